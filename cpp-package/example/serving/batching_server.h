@@ -0,0 +1,249 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file batching_server.h
+ * \brief serve concurrent inference requests over the predict API by
+ *  batching them dynamically
+ */
+#ifndef MXNET_CPP_SERVING_BATCHING_SERVER_H_
+#define MXNET_CPP_SERVING_BATCHING_SERVER_H_
+
+#include <mxnet/c_predict_api.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mxnet {
+namespace cpp {
+namespace serving {
+
+/*! \brief how requests are grouped into batches */
+struct BatchingConfig {
+  /*! \brief the largest batch, every predictor is created for this batch size */
+  mx_uint max_batch_size = 32;
+  /*! \brief the longest time a request waits for the batch to fill */
+  std::chrono::microseconds max_delay = std::chrono::microseconds(2000);
+  /*! \brief number of predictors, each one runs a batch at a time on its own thread */
+  int num_predictors = 2;
+  /*! \brief device of the predictors, 1: cpu, 2: gpu */
+  int dev_type = 1;
+  int dev_id = 0;
+};
+
+/*! \brief counters of a BatchingServer */
+struct BatchingStats {
+  uint64_t num_requests = 0;
+  uint64_t num_batches = 0;
+};
+
+/*!
+ * \brief accepts single samples from any number of threads, runs them in
+ *  batches of up to max_batch_size, and gives each caller its own output.
+ *
+ *  A batch is started as soon as max_batch_size requests are queued, or when
+ *  the oldest queued request has waited max_delay. Batches run on a pool of
+ *  predictors, each one loads its own copy of the parameters, so the memory
+ *  grows with num_predictors. The predict API binds a fixed shape, so partial
+ *  batches are padded with zeros up to max_batch_size.
+ */
+class BatchingServer {
+ public:
+  /*!
+   * \brief called with the output of a request, or with the error of its batch
+   */
+  typedef std::function<void(std::vector<mx_float> output, std::exception_ptr error)> Callback;
+  /*!
+   * \brief create the predictors and start their threads
+   * \param symbol_json the JSON of the network
+   * \param param_bytes the content of the parameter file
+   * \param input_key the name of the input
+   * \param sample_shape the shape of one sample, without the batch dimension
+   */
+  BatchingServer(const std::string &symbol_json, const std::string &param_bytes,
+                 const std::string &input_key, const std::vector<mx_uint> &sample_shape,
+                 const BatchingConfig &config)
+      : config_(config), input_key_(input_key), shutdown_(false) {
+    if (config_.max_batch_size == 0 || config_.num_predictors <= 0) {
+      throw std::invalid_argument("max_batch_size and num_predictors must be positive");
+    }
+    std::vector<mx_uint> shape = {config_.max_batch_size};
+    shape.insert(shape.end(), sample_shape.begin(), sample_shape.end());
+    input_size_ = 1;
+    for (mx_uint s : sample_shape) input_size_ *= s;
+    const mx_uint indptr[] = {0, static_cast<mx_uint>(shape.size())};
+    const char *keys[] = {input_key_.c_str()};
+    try {
+      for (int i = 0; i < config_.num_predictors; ++i) {
+        PredictorHandle pred;
+        Check(MXPredCreate(symbol_json.c_str(), param_bytes.data(),
+                           static_cast<int>(param_bytes.size()), config_.dev_type,
+                           config_.dev_id, 1, keys, indptr, shape.data(), &pred));
+        predictors_.push_back(pred);
+      }
+      mx_uint *out_shape, out_ndim;
+      Check(MXPredGetOutputShape(predictors_[0], 0, &out_shape, &out_ndim));
+      output_size_ = 1;
+      for (mx_uint i = 1; i < out_ndim; ++i) output_size_ *= out_shape[i];
+    } catch (...) {
+      // the destructor does not run when the constructor throws
+      for (PredictorHandle pred : predictors_) MXPredFree(pred);
+      throw;
+    }
+    for (PredictorHandle pred : predictors_) {
+      workers_.emplace_back([this, pred]() { this->RunPredictor(pred); });
+    }
+  }
+  /*! \brief finish the queued requests, then free the predictors */
+  ~BatchingServer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      shutdown_ = true;
+    }
+    queue_cv_.notify_all();
+    for (std::thread &worker : workers_) worker.join();
+    for (PredictorHandle pred : predictors_) MXPredFree(pred);
+  }
+  /*!
+   * \brief queue a sample, done is called from a predictor thread
+   * \param input the sample, of input_size() values
+   * \throw std::runtime_error once the server is shutting down
+   */
+  void Submit(std::vector<mx_float> input, Callback done) {
+    if (input.size() != input_size_) {
+      throw std::invalid_argument("the input has " + std::to_string(input.size()) +
+                                  " values, expected " + std::to_string(input_size_));
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // the predictors may have exited already, the request would never complete
+      if (shutdown_) throw std::runtime_error("the server is shutting down");
+      queue_.push_back(Request{std::move(input), std::move(done), Clock::now()});
+    }
+    queue_cv_.notify_one();
+  }
+  /*! \brief queue a sample and get its output through a future */
+  std::future<std::vector<mx_float> > Submit(std::vector<mx_float> input) {
+    auto promise = std::make_shared<std::promise<std::vector<mx_float> > >();
+    std::future<std::vector<mx_float> > result = promise->get_future();
+    Submit(std::move(input), [promise](std::vector<mx_float> output, std::exception_ptr error) {
+        if (error) {
+          promise->set_exception(error);
+        } else {
+          promise->set_value(std::move(output));
+        }
+      });
+    return result;
+  }
+  /*! \return number of values of a sample */
+  size_t input_size() const { return input_size_; }
+  /*! \return number of values of the output of a sample */
+  size_t output_size() const { return output_size_; }
+  /*! \return the counters since the server started */
+  BatchingStats stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+  struct Request {
+    std::vector<mx_float> input;
+    Callback done;
+    Clock::time_point arrival;
+  };
+  /*! \brief throw the last error of the predict API */
+  static void Check(int ret) {
+    if (ret != 0) throw std::runtime_error(MXGetLastError());
+  }
+  /*! \brief wait for the next batch, empty when shutting down with no request left */
+  std::vector<Request> NextBatch() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      queue_cv_.wait(lock, [this]() { return !queue_.empty() || shutdown_; });
+      if (queue_.empty()) return std::vector<Request>();
+      const Clock::time_point deadline = queue_.front().arrival + config_.max_delay;
+      // another predictor may take the requests while this one waits
+      queue_cv_.wait_until(lock, deadline, [this]() {
+          return queue_.size() >= config_.max_batch_size || queue_.empty() || shutdown_;
+        });
+      if (queue_.empty()) continue;
+      if (queue_.size() < config_.max_batch_size && Clock::now() < deadline && !shutdown_) {
+        continue;
+      }
+      const size_t n = std::min<size_t>(queue_.size(), config_.max_batch_size);
+      std::vector<Request> batch;
+      batch.reserve(n);
+      for (size_t i = 0; i < n; ++i) {
+        batch.push_back(std::move(queue_.front()));
+        queue_.pop_front();
+      }
+      stats_.num_requests += n;
+      stats_.num_batches += 1;
+      // the requests left over may already be due
+      if (!queue_.empty()) queue_cv_.notify_one();
+      return batch;
+    }
+  }
+  /*! \brief the loop of the thread of a predictor */
+  void RunPredictor(PredictorHandle pred) {
+    std::vector<mx_float> input(input_size_ * config_.max_batch_size);
+    std::vector<mx_float> output(output_size_ * config_.max_batch_size);
+    while (true) {
+      std::vector<Request> batch = NextBatch();
+      if (batch.empty()) return;
+      std::exception_ptr error;
+      try {
+        // gather, padding the rest of the batch
+        for (size_t i = 0; i < batch.size(); ++i) {
+          std::copy(batch[i].input.begin(), batch[i].input.end(),
+                    input.begin() + i * input_size_);
+        }
+        std::fill(input.begin() + batch.size() * input_size_, input.end(), 0.0f);
+        Check(MXPredSetInput(pred, input_key_.c_str(), input.data(),
+                             static_cast<mx_uint>(input.size())));
+        Check(MXPredForward(pred));
+        Check(MXPredGetOutput(pred, 0, output.data(), static_cast<mx_uint>(output.size())));
+      } catch (const std::exception &) {
+        error = std::current_exception();
+      }
+      // scatter
+      for (size_t i = 0; i < batch.size(); ++i) {
+        if (error) {
+          batch[i].done(std::vector<mx_float>(), error);
+        } else {
+          batch[i].done(std::vector<mx_float>(output.begin() + i * output_size_,
+                                              output.begin() + (i + 1) * output_size_),
+                        nullptr);
+        }
+      }
+    }
+  }
+
+  BatchingConfig config_;
+  std::string input_key_;
+  size_t input_size_, output_size_;
+  std::vector<PredictorHandle> predictors_;
+  std::vector<std::thread> workers_;
+  /*! \brief requests not taken by a predictor yet, oldest first */
+  std::deque<Request> queue_;
+  BatchingStats stats_;
+  bool shutdown_;
+  /*! \brief protects queue_, stats_ and shutdown_ */
+  std::mutex mutex_;
+  std::condition_variable queue_cv_;
+};
+}  // namespace serving
+}  // namespace cpp
+}  // namespace mxnet
+#endif  // MXNET_CPP_SERVING_BATCHING_SERVER_H_
@@ -0,0 +1,192 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file serving_benchmark.cpp
+ * \brief open loop load generator for BatchingServer, reporting the latency
+ *  percentiles reached at several request rates
+ */
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mxnet-cpp/MxNetCpp.h"
+#include "./batching_server.h"
+
+using namespace std;
+using namespace mxnet::cpp;
+using serving::BatchingConfig;
+using serving::BatchingServer;
+using serving::BatchingStats;
+
+typedef chrono::steady_clock Clock;
+
+/*
+ * Usage:
+ *   serving_benchmark [key=value ...]
+ * with the keys
+ *   symbol, params, shape   the model to serve, and the shape of one sample,
+ *                           e.g. shape=3,224,224. Without them a random MLP on
+ *                           784 inputs is generated.
+ *   max_batch, max_delay_us, predictors, dev_type, dev_id
+ *                           the BatchingConfig
+ *   qps                     the request rates to run, e.g. qps=500,1000,2000
+ *   duration                seconds of each run
+ */
+
+vector<mx_uint> ParseList(const string &str) {
+  vector<mx_uint> ret;
+  stringstream ss(str);
+  string item;
+  while (getline(ss, item, ',')) ret.push_back(static_cast<mx_uint>(atoi(item.c_str())));
+  return ret;
+}
+
+string ReadFile(const string &fname) {
+  ifstream fin(fname, ios::binary);
+  if (!fin) {
+    LG << "Cannot open " << fname;
+    exit(-1);
+  }
+  return string(istreambuf_iterator<char>(fin), istreambuf_iterator<char>());
+}
+
+/*! \brief a MLP with random weights, saved as the predict API expects */
+void MakeMLP(const vector<int> &layers, string *symbol_json, string *param_bytes) {
+  auto x = Symbol::Variable("data");
+  Symbol out = x;
+  for (size_t i = 0; i < layers.size(); ++i) {
+    auto weight = Symbol::Variable("w" + to_string(i));
+    auto bias = Symbol::Variable("b" + to_string(i));
+    out = FullyConnected(out, weight, bias, layers[i]);
+    if (i + 1 < layers.size()) out = Activation(out, ActivationActType::relu);
+  }
+  *symbol_json = out.ToJSON();
+
+  vector<vector<mx_uint> > in_shapes, aux_shapes, out_shapes;
+  out.InferShape({{"data", {1, 784}}}, &in_shapes, &aux_shapes, &out_shapes);
+  const vector<string> names = out.ListArguments();
+  map<string, NDArray> params;
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (names[i] == "data") continue;
+    NDArray arr(in_shapes[i], Context::cpu(), false);
+    NDArray::SampleUniform(-0.05f, 0.05f, &arr);
+    params["arg:" + names[i]] = arr;
+  }
+  const string fname = "serving_benchmark.params";
+  NDArray::Save(fname, params);
+  *param_bytes = ReadFile(fname);
+  remove(fname.c_str());
+}
+
+/*! \brief the value at fraction q of the sorted values */
+double Percentile(const vector<double> &sorted, double q) {
+  if (sorted.empty()) return 0;
+  size_t i = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+  return sorted[i];
+}
+
+/*!
+ * \brief send requests at the given rate for duration seconds. The arrivals
+ *  follow a Poisson process and do not wait for the responses, so the
+ *  latencies include the time spent queued when the server falls behind.
+ */
+void RunLoad(BatchingServer *server, double qps, double duration) {
+  const size_t num_requests = static_cast<size_t>(qps * duration);
+  mt19937 rng(0);
+  exponential_distribution<double> interval(qps);
+  vector<Clock::time_point> arrivals(num_requests);
+  vector<double> latencies(num_requests);
+  vector<mx_float> sample(server->input_size());
+  for (mx_float &v : sample) v = uniform_real_distribution<float>(0, 1)(rng);
+
+  mutex done_mutex;
+  condition_variable done_cv;
+  size_t num_done = 0, num_errors = 0;
+  Clock::time_point last_done;
+  const BatchingStats begin_stats = server->stats();
+  const Clock::time_point start = Clock::now();
+  double offset = 0;
+  for (size_t i = 0; i < num_requests; ++i) {
+    offset += interval(rng);
+    arrivals[i] = start + chrono::duration_cast<Clock::duration>(
+        chrono::duration<double>(offset));
+    this_thread::sleep_until(arrivals[i]);
+    server->Submit(sample, [&, i](vector<mx_float> output, exception_ptr error) {
+        const Clock::time_point now = Clock::now();
+        latencies[i] = chrono::duration<double, milli>(now - arrivals[i]).count();
+        lock_guard<mutex> lock(done_mutex);
+        if (error) ++num_errors;
+        last_done = now;
+        if (++num_done == num_requests) done_cv.notify_one();
+      });
+  }
+  {
+    unique_lock<mutex> lock(done_mutex);
+    done_cv.wait(lock, [&]() { return num_done == num_requests; });
+  }
+  const BatchingStats end_stats = server->stats();
+  sort(latencies.begin(), latencies.end());
+  const double elapsed = chrono::duration<double>(last_done - start).count();
+  const uint64_t num_batches = end_stats.num_batches - begin_stats.num_batches;
+  printf("%10.0f %12.1f %10.3f %10.3f %10.3f %12.2f %8zu\n",
+         qps, num_requests / elapsed,
+         Percentile(latencies, 0.5), Percentile(latencies, 0.99), latencies.back(),
+         num_batches == 0 ? 0.0 : static_cast<double>(num_requests) / num_batches,
+         num_errors);
+}
+
+int main(int argc, char** argv) {
+  map<string, string> args = {
+    {"max_batch", "32"}, {"max_delay_us", "2000"}, {"predictors", "2"},
+    {"dev_type", "1"}, {"dev_id", "0"}, {"qps", "250,500,1000,2000,4000"},
+    {"duration", "5"}
+  };
+  for (int i = 1; i < argc; ++i) {
+    const string arg = argv[i];
+    const size_t pos = arg.find('=');
+    if (pos == string::npos) {
+      LG << "Arguments are key=value, got " << arg;
+      return -1;
+    }
+    args[arg.substr(0, pos)] = arg.substr(pos + 1);
+  }
+
+  string symbol_json, param_bytes;
+  vector<mx_uint> shape;
+  if (args.count("symbol")) {
+    symbol_json = ReadFile(args["symbol"]);
+    param_bytes = ReadFile(args["params"]);
+    shape = ParseList(args["shape"]);
+  } else {
+    MakeMLP({1024, 1024, 10}, &symbol_json, &param_bytes);
+    shape = {784};
+  }
+
+  BatchingConfig config;
+  config.max_batch_size = static_cast<mx_uint>(atoi(args["max_batch"].c_str()));
+  config.max_delay = chrono::microseconds(atoi(args["max_delay_us"].c_str()));
+  config.num_predictors = atoi(args["predictors"].c_str());
+  config.dev_type = atoi(args["dev_type"].c_str());
+  config.dev_id = atoi(args["dev_id"].c_str());
+  LG << "max_batch=" << config.max_batch_size << " max_delay_us="
+     << config.max_delay.count() << " predictors=" << config.num_predictors;
+  printf("%10s %12s %10s %10s %10s %12s %8s\n", "qps", "throughput", "p50(ms)",
+         "p99(ms)", "max(ms)", "mean_batch", "errors");
+  {
+    BatchingServer server(symbol_json, param_bytes, "data", shape, config);
+    for (mx_uint qps : ParseList(args["qps"])) {
+      RunLoad(&server, qps, atof(args["duration"].c_str()));
+    }
+  }
+  MXNotifyShutdown();
+  return 0;
+}
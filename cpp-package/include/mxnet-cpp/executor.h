@@ -78,7 +78,8 @@ class Executor {
   */
   std::string DebugStr();
   /*!
-  * \brief update the arguments with given learning rate and optimizer
+  * \brief update the arguments with given learning rate and optimizer, with
+  * one list update of the optimizer
   * \param opt the pointer to the optimizer
   * \param lr learning rate
   * \param wd weight decay
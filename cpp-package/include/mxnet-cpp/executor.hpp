@@ -82,9 +82,14 @@ inline std::string Executor::DebugStr() {
 inline void Executor::UpdateAll(Optimizer *opt, float lr, float wd,
                                 int arg_update_begin, int arg_update_end) {
   arg_update_end = arg_update_end < 0 ? arg_arrays.size() - 1 : arg_update_end;
+  std::vector<int> indices;
+  std::vector<NDArray> weights, grads;
   for (int i = arg_update_begin; i < arg_update_end; ++i) {
-    opt->Update(i, arg_arrays[i], grad_arrays[i], lr, wd);
+    indices.push_back(i);
+    weights.push_back(arg_arrays[i]);
+    grads.push_back(grad_arrays[i]);
   }
+  opt->Update(indices, weights, grads, lr, wd);
 }
 }  // namespace cpp
 }  // namespace mxnet
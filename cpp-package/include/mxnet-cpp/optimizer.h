@@ -68,10 +68,26 @@ class Optimizer {
   *  \param grad gradient for the weight.
   */
   virtual void Update(int index, NDArray weight, NDArray grad) = 0;
-  // TODO(zhangcheng-qinyinghua)
-  // implement Update a list of arrays, maybe in the form of map
-  // void Update(int index, std::vector<NDArray> weights, std::vector<NDArray>
-  // grad, mx_float lr);
+  /*!
+  *  \brief Update a list of weights with their gradients.
+  *  \param indices the unique indices of the weights.
+  *  \param weights the weights to update.
+  *  \param grads gradients of the weights.
+  *  \param lr learning rate.
+  *  \param wd weight decay.
+  */
+  void Update(const std::vector<int> &indices, const std::vector<NDArray> &weights,
+              const std::vector<NDArray> &grads, mx_float lr, mx_float wd);
+  /*!
+  *  \brief Update a list of weights with their gradients. By default the
+  *  weights are updated one by one, optimizers with a multi-weight operator
+  *  update them in as few calls as possible.
+  *  \param indices the unique indices of the weights.
+  *  \param weights the weights to update.
+  *  \param grads gradients of the weights.
+  */
+  virtual void Update(const std::vector<int> &indices, const std::vector<NDArray> &weights,
+                      const std::vector<NDArray> &grads);
 
   /*!
   *  \brief Serialize the optimizer parameters to a string.
@@ -107,12 +123,16 @@ class SGDOptimizer : public Optimizer {
   SGDOptimizer();
   virtual std::string GetType() const;
   virtual void Update(int index, NDArray weight, NDArray grad);
+  virtual void Update(const std::vector<int> &indices, const std::vector<NDArray> &weights,
+                      const std::vector<NDArray> &grads);
  private:
   virtual ~SGDOptimizer();
   virtual void CreateState_(int index, NDArray weight);
   std::map<int, NDArray*> states_;
   AtomicSymbolCreator update_handle_;
   AtomicSymbolCreator mom_update_handle_;
+  AtomicSymbolCreator multi_update_handle_;
+  AtomicSymbolCreator multi_mom_update_handle_;
 };
 
 
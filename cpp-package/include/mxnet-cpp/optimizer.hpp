@@ -13,6 +13,7 @@
 #include <numeric>
 #include <map>
 #include <string>
+#include <tuple>
 #include <vector>
 #include "mxnet-cpp/optimizer.h"
 #include "mxnet-cpp/op.h"
@@ -40,6 +41,25 @@ inline void Optimizer::Update(int index, NDArray weight, NDArray grad, mx_float
   Update(index, weight, grad);
 }
 
+inline void Optimizer::Update(const std::vector<int> &indices,
+                              const std::vector<NDArray> &weights,
+                              const std::vector<NDArray> &grads,
+                              mx_float lr, mx_float wd) {
+  params_["lr"] = std::to_string(lr);
+  params_["wd"] = std::to_string(wd);
+  Update(indices, weights, grads);
+}
+
+inline void Optimizer::Update(const std::vector<int> &indices,
+                              const std::vector<NDArray> &weights,
+                              const std::vector<NDArray> &grads) {
+  CHECK_EQ(indices.size(), weights.size());
+  CHECK_EQ(indices.size(), grads.size());
+  for (size_t i = 0; i < indices.size(); ++i) {
+    Update(indices[i], weights[i], grads[i]);
+  }
+}
+
 inline std::string Optimizer::Serialize() const {
   using ValueType = std::map<std::string, std::string>::value_type;
   auto params = params_;
@@ -86,6 +106,8 @@ inline std::string SGDOptimizer::GetType() const {
 inline SGDOptimizer::SGDOptimizer() {
   update_handle_ = op_map()->GetSymbolCreator("sgd_update");
   mom_update_handle_ = op_map()->GetSymbolCreator("sgd_mom_update");
+  multi_update_handle_ = op_map()->GetSymbolCreator("multi_sgd_update");
+  multi_mom_update_handle_ = op_map()->GetSymbolCreator("multi_sgd_mom_update");
 }
 
 inline SGDOptimizer::~SGDOptimizer() {
@@ -123,6 +145,50 @@ inline void SGDOptimizer::Update(int index, NDArray weight, NDArray grad) {
   }
 }
 
+inline void SGDOptimizer::Update(const std::vector<int> &indices,
+                                 const std::vector<NDArray> &weights,
+                                 const std::vector<NDArray> &grads) {
+  CHECK_EQ(indices.size(), weights.size());
+  CHECK_EQ(indices.size(), grads.size());
+  // one operator updates the weights of a device which all have, or all lack,
+  // a momentum
+  std::map<std::tuple<int, int, bool>, std::vector<size_t> > groups;
+  for (size_t i = 0; i < indices.size(); ++i) {
+    if (states_.count(indices[i]) == 0) {
+      CreateState_(indices[i], weights[i]);
+    }
+    Context ctx = weights[i].GetContext();
+    groups[std::make_tuple(static_cast<int>(ctx.GetDeviceType()), ctx.GetDeviceId(),
+                           states_[indices[i]] != nullptr)].push_back(i);
+  }
+
+  auto keys = GetParamKeys_();
+  auto values = GetParamValues_();
+  CHECK_EQ(keys.size(), values.size());
+  keys.push_back("num_weights");
+  values.push_back(nullptr);
+
+  for (const auto &group : groups) {
+    const bool has_mom = std::get<2>(group.first);
+    const std::string num_weights = std::to_string(group.second.size());
+    values.back() = num_weights.c_str();
+
+    std::vector<NDArrayHandle> inputs, outputs;
+    for (size_t i : group.second) {
+      inputs.push_back(weights[i].GetHandle());
+      inputs.push_back(grads[i].GetHandle());
+      if (has_mom) inputs.push_back(states_[indices[i]]->GetHandle());
+      outputs.push_back(weights[i].GetHandle());
+    }
+    int num_outputs = outputs.size();
+    NDArrayHandle *output_handles = outputs.data();
+    MXImperativeInvoke(has_mom ? multi_mom_update_handle_ : multi_update_handle_,
+        inputs.size(), inputs.data(),
+        &num_outputs, &output_handles,
+        keys.size(), keys.data(), values.data());
+  }
+}
+
 inline void SGDOptimizer::CreateState_(int index, NDArray weight) {
   if (params_.count("momentum") == 0) {
     states_[index] = nullptr;
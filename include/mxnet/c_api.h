@@ -64,6 +64,8 @@ typedef void *KVStoreHandle;
 typedef void *RecordIOHandle;
 /*! \brief handle to MXRtc*/
 typedef void *RtcHandle;
+/*! \brief handle to an operator with parsed parameters */
+typedef void *CachedOpHandle;
 
 typedef void (*ExecutorMonitorCallback)(const char*,
                                         NDArrayHandle,
@@ -172,6 +174,14 @@ MXNET_DLL int MXRandomSeed(int seed);
  * \return 0 when success, -1 when failure happens.
  */
 MXNET_DLL int MXNotifyShutdown();
+/*!
+ * \brief Set the maximum number of synchronous CPU operations pushed by the
+ *  calling thread that the engine groups into one engine operation.
+ * \param bulk_size the maximum size of a group, 0 to push every operation
+ * \param prev_bulk_size returns the previous size
+ * \return 0 when success, -1 when failure happens.
+ */
+MXNET_DLL int MXEngineSetBulkSize(int bulk_size, int* prev_bulk_size);
 /*!
  * \brief Set up configuration of profiler
  * \param mode indicate the working mode of profiler,
@@ -273,6 +283,24 @@ MXNET_DLL int MXNDArraySave(const char* fname,
                             mx_uint num_args,
                             NDArrayHandle* args,
                             const char** keys);
+/*!
+ * \brief Save list of narray into the file, with the options of NDArray::Save.
+ * \param fname name of the file.
+ * \param num_args number of arguments to save.
+ * \param args the array of NDArrayHandles to be saved.
+ * \param keys the name of the NDArray, optional, can be NULL
+ * \param compress whether to compress the arrays, the file then needs a
+ *  version of MXNDArrayLoad that reads compressed lists
+ * \param background whether to write the file in background, the file is
+ *  complete after MXNDArrayWaitAll, which fails if the write failed
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXNDArraySaveEx(const char* fname,
+                              mx_uint num_args,
+                              NDArrayHandle* args,
+                              const char** keys,
+                              int compress,
+                              int background);
 /*!
  * \brief Load list of narray from the file.
  * \param fname name of the file.
@@ -520,6 +548,45 @@ MXNET_DLL int MXImperativeInvoke(AtomicSymbolCreator creator,
                                  int num_params,
                                  const char **param_keys,
                                  const char **param_vals);
+/*!
+ * \brief create an operator with its parameters parsed once, to be invoked
+ *  many times by MXInvokeCachedOp without the dispatch cost of MXImperativeInvoke
+ * \param creator the op
+ * \param num_inputs number of input NDArrays of every invocation
+ * \param num_params number of keyword parameters
+ * \param param_keys keys for keyword parameters
+ * \param param_vals values for keyword parameters
+ * \param out the returned handle
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXCreateCachedOp(AtomicSymbolCreator creator,
+                               int num_inputs,
+                               int num_params,
+                               const char **param_keys,
+                               const char **param_vals,
+                               CachedOpHandle *out);
+/*!
+ * \brief free a cached op
+ * \param handle the handle to be freed
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXFreeCachedOp(CachedOpHandle handle);
+/*!
+ * \brief invoke a cached op. Shape and type inference is skipped when the
+ *  inputs and outputs have the same shapes and types as in the last invocation.
+ *  A handle must not be invoked by several threads at the same time.
+ * \param handle the cached op
+ * \param num_inputs number of input NDArrays
+ * \param inputs input NDArrays
+ * \param num_outputs number of output NDArrays
+ * \param outputs output NDArrays, allocated and returned when *outputs is NULL
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXInvokeCachedOp(CachedOpHandle handle,
+                               int num_inputs,
+                               NDArrayHandle *inputs,
+                               int *num_outputs,
+                               NDArrayHandle **outputs);
 /*!
  * \brief set whether to record operator for autograd
  * \param is_train 1 when training, 0 when testing
@@ -826,6 +893,16 @@ MXNET_DLL int MXSymbolGrad(SymbolHandle sym,
                            mx_uint num_wrt,
                            const char** wrt,
                            SymbolHandle* out);
+/*!
+ * \brief Replace Convolution and FullyConnected in the symbol by their uint8
+ *  quantized versions, inserting quantize and dequantize operators. A weight or
+ *  bias variable `name` is replaced by the variables `name_quantized`,
+ *  `name_min` and `name_max`.
+ * \param sym the symbol to quantize
+ * \param out the returned quantized symbol
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXQuantizeSymbol(SymbolHandle sym, SymbolHandle* out);
 /*!
  * \brief infer shape of unknown input shapes given the known one.
  *  The shapes are packed into a CSR matrix represented by arg_ind_ptr and arg_shape_data
@@ -1275,6 +1352,62 @@ typedef void (MXKVStoreUpdater)(int key,
 MXNET_DLL int MXKVStoreSetUpdater(KVStoreHandle handle,
                                   MXKVStoreUpdater updater,
                                   void *updater_handle);
+/*!
+ * \brief push a list of row-sparse values into the kvstore
+ * \param handle handle to the kvstore
+ * \param num the number of key-value pairs
+ * \param keys the list of keys
+ * \param row_ids the list of 1D row ids, negative ids are ignored
+ * \param vals the list of 2D values, row i holds the value of row_ids[i]
+ * \param priority the priority of the action
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXKVStorePushRowSparse(KVStoreHandle handle,
+                                     mx_uint num,
+                                     const int* keys,
+                                     NDArrayHandle* row_ids,
+                                     NDArrayHandle* vals,
+                                     int priority);
+/*!
+ * \brief pull the given rows of a list of keys from the kvstore
+ * \param handle handle to the kvstore
+ * \param num the number of key-value pairs
+ * \param keys the list of keys
+ * \param row_ids the list of 1D row ids to pull
+ * \param vals the list of preallocated 2D buffers, one row per row id
+ * \param priority the priority of the action
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXKVStorePullRowSparse(KVStoreHandle handle,
+                                     mx_uint num,
+                                     const int* keys,
+                                     NDArrayHandle* row_ids,
+                                     NDArrayHandle* vals,
+                                     int priority);
+/*!
+ * \brief user-defined updater of row-sparse values for the kvstore
+ * It's this updater's responsibility to delete \a row_ids, \a recv and \a local
+ * \param the key
+ * \param row_ids the merged row ids pushed on this key
+ * \param recv the merged rows pushed on this key
+ * \param local the value stored on local on this key
+ * \param handle The additional handle to the updater
+ */
+typedef void (MXKVStoreRowSparseUpdater)(int key,
+                                         NDArrayHandle row_ids,
+                                         NDArrayHandle recv,
+                                         NDArrayHandle local,
+                                         void *handle);
+/*!
+ * \brief register an updater for row-sparse pushes
+ * \param handle handle to the KVStore
+ * \param updater udpater function
+ * \param updater_handle The additional handle used to invoke the updater
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXKVStoreSetRowSparseUpdater(KVStoreHandle handle,
+                                           MXKVStoreRowSparseUpdater updater,
+                                           void *updater_handle);
 /*!
  * \brief get the type of the kvstore
  * \param handle handle to the KVStore
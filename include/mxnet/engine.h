@@ -174,6 +174,24 @@ class MXNET_API Engine {
    * \brief Wait until all the activity of engine finishes.
    */
   virtual void WaitForAll() = 0;
+  /*!
+   * \brief Set the maximum number of synchronous CPU operations pushed by the
+   *  calling thread that are grouped into one engine operation. The pending
+   *  group is pushed when it is full, when an operation that cannot be grouped
+   *  is pushed, when a variable is waited for and when the size is changed.
+   *  Engines that do not group operations ignore it.
+   * \param bulk_size the maximum size of a group, 0 to push every operation
+   * \return the previous size
+   */
+  virtual int set_bulk_size(int bulk_size) {
+    return 0;
+  }
+  /*!
+   * \return the maximum number of operations grouped for the calling thread
+   */
+  virtual int bulk_size() const {
+    return 0;
+  }
   /*!\brief virtual destructor */
   virtual ~Engine() noexcept(false) {}
   /*!
@@ -201,12 +219,12 @@ class MXNET_API Engine {
    * \param opr_name The operator name.
    * \tparam SyncFn the synchronous function to be pushed.
    */
-  inline void PushSync(SyncFn exec_fn, Context exec_ctx,
-                       std::vector<VarHandle> const& const_vars,
-                       std::vector<VarHandle> const& mutable_vars,
-                       FnProperty prop = FnProperty::kNormal,
-                       int priority = 0,
-                       const char* opr_name = nullptr) {
+  virtual void PushSync(SyncFn exec_fn, Context exec_ctx,
+                        std::vector<VarHandle> const& const_vars,
+                        std::vector<VarHandle> const& mutable_vars,
+                        FnProperty prop = FnProperty::kNormal,
+                        int priority = 0,
+                        const char* opr_name = nullptr) {
     this->PushAsync([exec_fn](RunContext ctx, CallbackOnComplete on_complete) {
         exec_fn(ctx);
         on_complete();
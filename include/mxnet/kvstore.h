@@ -129,6 +129,43 @@ class KVStore {
                     const std::vector<NDArray*>& values,
                     int priority = 0) = 0;
 
+  /*!
+   * \brief push a list of row-sparse values into the store
+   *
+   * A row-sparse value is a pair (row_ids, values) where values[i] is the
+   * value of row row_ids[i] of the 2D array stored on the key. Negative row
+   * ids are padding and ignored. Only the listed rows of the stored value are
+   * updated, by the row-sparse updater if set, otherwise they are assigned.
+   *
+   * \param keys the list of keys
+   * \param row_ids the list of row ids, one 1D array per key
+   * \param values the list of row values, one 2D array per key
+   * \param priority Priority of the action.
+   */
+  virtual void PushRowSparse(const std::vector<int>& keys,
+                             const std::vector<NDArray>& row_ids,
+                             const std::vector<NDArray>& values,
+                             int priority = 0) {
+    LOG(FATAL) << "row-sparse push is not supported by kvstore " << type_;
+  }
+  /*!
+   * \brief pull the given rows of a list of keys from the store
+   *
+   * values[i] is a preallocated 2D array whose row j receives the row
+   * row_ids[i][j] of the stored value, or zeros if the row id is negative.
+   *
+   * \param keys the list of keys
+   * \param row_ids the list of row ids to pull, one 1D array per key
+   * \param values the list of buffers for the pulled rows
+   * \param priority Priority of the action.
+   */
+  virtual void PullRowSparse(const std::vector<int>& keys,
+                             const std::vector<NDArray>& row_ids,
+                             const std::vector<NDArray*>& values,
+                             int priority = 0) {
+    LOG(FATAL) << "row-sparse pull is not supported by kvstore " << type_;
+  }
+
   /**
    * \brief the prototype of user-defined updater
    */
@@ -147,6 +184,21 @@ class KVStore {
     updater_ = updater;
   }
 
+  /**
+   * \brief the prototype of user-defined updater of row-sparse values,
+   *  called with the key, the merged row ids, the merged rows and the stored value
+   */
+  typedef std::function<void(int, const NDArray&, const NDArray&, NDArray*)>
+      RowSparseUpdater;
+  /*!
+   * \brief set an updater for the values pushed by PushRowSparse
+   * \param updater user-defined updater, default is assigning the rows
+   */
+  virtual void set_row_sparse_updater(const RowSparseUpdater& updater) {
+    CHECK(updater) << "invalid updater";
+    row_sparse_updater_ = updater;
+  }
+
   /******************************************************
    * the following are used for multi-machines.
    ******************************************************/
@@ -291,6 +343,11 @@ class KVStore {
    */
   Updater updater_;
 
+  /**
+   * \brief the user-defined updater of row-sparse values
+   */
+  RowSparseUpdater row_sparse_updater_;
+
   /**
    * \brief the kvstore type
    */
@@ -360,6 +360,27 @@ class NDArray {
   static void Save(dmlc::Stream* fo,
                    const std::vector<NDArray>& data,
                    const std::vector<std::string>& names);
+  /*!
+   * \brief Save list of narray into a file. The arrays are staged to CPU before
+   *  any of them is waited for, and are written with their checksums.
+   * \param fname The name of the file.
+   * \param data the NDArrays to be saved.
+   * \param names the name of the NDArray, optional, can be zero length.
+   * \param compress whether to compress the arrays by chunks in parallel,
+   *  the file can then only be loaded by versions that read compressed lists.
+   * \param background whether to write the file on a background thread.
+   *  The arrays are snapshotted before returning, the write is complete after
+   *  Engine::WaitForAll. A failed write is reported by CheckBackgroundSaves.
+   */
+  static void Save(const std::string& fname,
+                   const std::vector<NDArray>& data,
+                   const std::vector<std::string>& names,
+                   bool compress, bool background);
+  /*!
+   * \brief throw the errors of the background saves finished since the last
+   *  call, it is called by Save and by MXNDArrayWaitAll.
+   */
+  static void CheckBackgroundSaves();
   /*!
    * \brief Load list of narray into from the stream.
    * \param fi The stream of the input file.
@@ -0,0 +1,125 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file random_generator.h
+ * \brief counter based random number generator shared by concurrent operators
+ *
+ *  A value of the stream is a function of the seed and of its position only,
+ *  so an operator can generate its values with any number of threads, on any
+ *  device, and still get the same values for the same seed.
+ */
+#ifndef MXNET_RANDOM_GENERATOR_H_
+#define MXNET_RANDOM_GENERATOR_H_
+
+#include <mshadow/base.h>
+#include <cmath>
+#include <cstdint>
+
+namespace mxnet {
+namespace random {
+/*!
+ * \brief a range of the stream of a ParallelRandom, reserved by an operator.
+ *  It is a plain value that can be copied into kernels. The range is made of
+ *  blocks of kBlockSize values, block i is the Philox4x32-10 bijection of
+ *  counter (first block + i) under the key of the stream.
+ */
+class RandomRange {
+ public:
+  /*! \brief number of values generated at once */
+  static const int kBlockSize = 4;
+  RandomRange() {}
+  RandomRange(uint32_t key0, uint32_t key1, uint64_t begin)
+      : key0_(key0), key1_(key1), begin_(begin) {}
+  /*! \brief random bits of block i */
+  MSHADOW_XINLINE void Bits(uint64_t i, uint32_t out[kBlockSize]) const {
+    const uint32_t kMul0 = 0xD2511F53U, kMul1 = 0xCD9E8D57U;
+    const uint32_t kWeyl0 = 0x9E3779B9U, kWeyl1 = 0xBB67AE85U;
+    const uint64_t counter = begin_ + i;
+    uint32_t c0 = static_cast<uint32_t>(counter), c1 = static_cast<uint32_t>(counter >> 32);
+    uint32_t c2 = 0, c3 = 0;
+    uint32_t k0 = key0_, k1 = key1_;
+    for (int round = 0; round < 10; ++round) {
+      const uint64_t p0 = static_cast<uint64_t>(kMul0) * c0;
+      const uint64_t p1 = static_cast<uint64_t>(kMul1) * c2;
+      const uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+      const uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+      c1 = static_cast<uint32_t>(p1);
+      c3 = static_cast<uint32_t>(p0);
+      c0 = n0;
+      c2 = n2;
+      k0 += kWeyl0;
+      k1 += kWeyl1;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+  }
+  /*! \brief uniform values in [0, 1) of block i */
+  template<typename DType>
+  MSHADOW_XINLINE void Uniform(uint64_t i, DType out[kBlockSize]) const {
+    uint32_t bits[kBlockSize];
+    this->Bits(i, bits);
+    for (int j = 0; j < kBlockSize; ++j) {
+      out[j] = static_cast<DType>(ToFloat(bits[j]));
+    }
+  }
+  /*! \brief standard normal values of block i, by the Box-Muller transform */
+  template<typename DType>
+  MSHADOW_XINLINE void Normal(uint64_t i, DType out[kBlockSize]) const {
+    const float kTwoPi = 6.283185307179586f;
+    uint32_t bits[kBlockSize];
+    this->Bits(i, bits);
+    for (int j = 0; j < kBlockSize; j += 2) {
+      // 1 - u is in (0, 1], away from the pole of log
+      const float r = sqrtf(-2.0f * logf(1.0f - ToFloat(bits[j])));
+      const float theta = kTwoPi * ToFloat(bits[j + 1]);
+      out[j] = static_cast<DType>(r * cosf(theta));
+      out[j + 1] = static_cast<DType>(r * sinf(theta));
+    }
+  }
+
+ private:
+  /*! \brief the upper 24 bits as a float in [0, 1) */
+  MSHADOW_XINLINE static float ToFloat(uint32_t bits) {
+    return static_cast<float>(bits >> 8) * (1.0f / 16777216.0f);
+  }
+  uint32_t key0_, key1_;
+  uint64_t begin_;
+};
+
+/*!
+ * \brief the stream of a random number resource: its key and the first block
+ *  not reserved yet. Operators writing the resource are serialized by its
+ *  engine variable, so the ranges they reserve, and the values they get, only
+ *  depend on the seed and on the order in which they were pushed.
+ */
+class ParallelRandom {
+ public:
+  ParallelRandom() : key0_(0), key1_(0), next_(0) {}
+  /*!
+   * \brief restart the stream
+   * \param seed the global seed
+   * \param id distinguishes the streams of the same seed
+   */
+  inline void Seed(uint32_t seed, uint32_t id) {
+    key0_ = seed;
+    key1_ = id;
+    next_ = 0;
+  }
+  /*!
+   * \brief reserve the range of the next n values
+   * \return the range, of (n + kBlockSize - 1) / kBlockSize blocks
+   */
+  inline RandomRange Reserve(uint64_t n) {
+    RandomRange range(key0_, key1_, next_);
+    next_ += (n + RandomRange::kBlockSize - 1) / RandomRange::kBlockSize;
+    return range;
+  }
+
+ private:
+  uint32_t key0_, key1_;
+  uint64_t next_;
+};
+}  // namespace random
+}  // namespace mxnet
+#endif  // MXNET_RANDOM_GENERATOR_H_
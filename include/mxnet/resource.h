@@ -9,6 +9,7 @@
 #include <dmlc/logging.h>
 #include "./base.h"
 #include "./engine.h"
+#include "./random_generator.h"
 
 namespace mxnet {
 
@@ -21,7 +22,13 @@ struct ResourceRequest {
     /*! \brief mshadow::Random<xpu> object */
     kRandom,
     /*! \brief A dynamic temp space that can be arbitrary size */
-    kTempSpace
+    kTempSpace,
+    /*!
+     * \brief random::ParallelRandom object, a counter based generator whose
+     *  values can be generated in parallel. Several copies are handed out in
+     *  turn, so operators requesting it can run concurrently.
+     */
+    kParallelRandom
   };
   /*! \brief type of resources */
   Type type;
@@ -35,6 +42,17 @@ struct ResourceRequest {
       : type(type) {}
 };
 
+/*!
+ * \brief statistics of the temp space requested by one operator
+ */
+struct TempSpaceStat {
+  /*! \brief largest space requested, in bytes */
+  size_t high_water;
+  /*! \brief number of requests */
+  size_t num_requests;
+  /*! \brief default constructor */
+  TempSpaceStat() : high_water(0), num_requests(0) {}
+};
 
 /*!
  * \brief Resources used by mxnet operations.
@@ -53,8 +71,13 @@ struct Resource {
    *  access using member functions
    */
   void *ptr_;
+  /*!
+   * \brief where the temp space requested through this resource is recorded,
+   *  nullptr if it is not recorded
+   */
+  TempSpaceStat *stat;
   /*! \brief default constructor */
-  Resource() : id(0) {}
+  Resource() : id(0), stat(nullptr) {}
   /*!
    * \brief Get random number generator.
    * \param stream The stream to use in the random number generator.
@@ -70,6 +93,16 @@ struct Resource {
     ret->set_stream(stream);
     return ret;
   }
+  /*!
+   * \brief Get the counter based random number generator.
+   *  Reserve the values to generate from it, then generate them from the
+   *  returned random::RandomRange on any number of threads.
+   * \return the random number generator requested.
+   */
+  inline random::ParallelRandom* get_parallel_random() const {
+    CHECK_EQ(req.type, ResourceRequest::kParallelRandom);
+    return static_cast<random::ParallelRandom*>(ptr_);
+  }
   /*!
    * \brief Get space requested as mshadow Tensor.
    *  The caller can request arbitrary size.
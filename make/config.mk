@@ -79,6 +79,12 @@ USE_NVRTC = 0
 # imbin iterator
 USE_OPENCV = 1
 
+# whether use libjpeg-turbo to decode JPEG images at a reduced resolution in
+# ImageRecordIter when they are resized afterwards
+USE_LIBJPEG_TURBO = 0
+# add the path to libjpeg-turbo library if not on the default path
+USE_LIBJPEG_TURBO_PATH = NONE
+
 # use openmp for parallelization
 USE_OPENMP = 1
 
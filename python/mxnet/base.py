@@ -66,6 +66,7 @@ DataIterHandle = ctypes.c_void_p
 KVStoreHandle = ctypes.c_void_p
 RecordIOHandle = ctypes.c_void_p
 RtcHandle = ctypes.c_void_p
+CachedOpHandle = ctypes.c_void_p
 #----------------------------
 # helper function definition
 #----------------------------
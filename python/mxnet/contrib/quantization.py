@@ -0,0 +1,64 @@
+# coding: utf-8
+"""Quantization of symbols for uint8 inference on CPU."""
+from __future__ import absolute_import
+
+import ctypes
+from ..base import _LIB, check_call, SymbolHandle
+from ..symbol import Symbol
+from .. import ndarray as nd
+from . import ndarray as contrib_nd
+
+
+def quantize_graph(sym):
+    """Replaces Convolution and FullyConnected layers by their quantized versions.
+
+    The data input of every replaced layer is quantized to uint8 with the range
+    observed at runtime, the layer accumulates in int32 and its output is
+    dequantized back to float32. A layer fed directly by another quantized layer
+    gets its input through requantize, without a round trip through float32.
+
+    The weight and bias are quantized once, by `quantize_params`. Each such
+    variable `name` is replaced by `name_quantized`, `name_min` and `name_max`.
+
+    Parameters
+    ----------
+    sym : Symbol
+        The float32 symbol.
+
+    Returns
+    -------
+    Symbol
+        The quantized symbol, it can only be bound on CPU.
+    """
+    handle = SymbolHandle()
+    check_call(_LIB.MXQuantizeSymbol(sym.handle, ctypes.byref(handle)))
+    return Symbol(handle)
+
+
+def quantize_params(qsym, params):
+    """Quantizes the parameters of a symbol returned by `quantize_graph`.
+
+    Parameters
+    ----------
+    qsym : Symbol
+        The quantized symbol.
+    params : dict of str to NDArray
+        The float32 arguments of the original symbol.
+
+    Returns
+    -------
+    dict of str to NDArray
+        The arguments of `qsym`: the parameters of the quantized layers as uint8
+        with their ranges, the other arguments unchanged.
+    """
+    suffix = '_quantized'
+    quantized = {}
+    for name in qsym.list_arguments():
+        if name in params:
+            quantized[name] = params[name]
+        elif name.endswith(suffix) and name[:-len(suffix)] in params:
+            original = name[:-len(suffix)]
+            param = params[original]
+            quantized[name], quantized[original + '_min'], quantized[original + '_max'] = \
+                contrib_nd.quantize(param, nd.min(param), nd.max(param), out_type='uint8')
+    return quantized
@@ -0,0 +1,66 @@
+# coding: utf-8
+"""Engine properties management."""
+from __future__ import absolute_import
+
+import ctypes
+from .base import _LIB, check_call
+
+
+def set_bulk_size(size):
+    """Set the maximum number of imperative CPU operations of the current thread
+    that the engine groups into one engine operation.
+
+    A pending group is pushed when it is full, when an operation that cannot be
+    grouped is pushed, or when a value is read, e.g. by ``asnumpy`` or
+    ``wait_to_read``.
+
+    Parameters
+    ----------
+    size : int
+        Maximum number of operations in a group, 0 to push every operation.
+
+    Returns
+    -------
+    int
+        The previous size.
+    """
+    prev = ctypes.c_int()
+    check_call(_LIB.MXEngineSetBulkSize(
+        ctypes.c_int(size), ctypes.byref(prev)))
+    return prev.value
+
+
+class _BulkScope(object):
+    """Scope object for bulk execution."""
+    def __init__(self, size):
+        self._size = size
+        self._old_size = None
+
+    def __enter__(self):
+        self._old_size = set_bulk_size(self._size)
+        return self
+
+    def __exit__(self, ptype, value, trace):
+        set_bulk_size(self._old_size)
+
+
+def bulk(size):
+    """Returns a scope in which imperative CPU operations are grouped by ``size``
+    into engine operations, which cuts the scheduling overhead of loops of small
+    operations. The pending group is pushed when the scope exits.
+
+    Parameters
+    ----------
+    size : int
+        Maximum number of operations in a group.
+
+    Examples
+    --------
+    >>> x = mx.nd.zeros((10,))
+    >>> with mx.engine.bulk(10):
+    ...     for _ in range(100):
+    ...         x += 1
+    >>> x.asnumpy()
+    array([ 100.,  100.,  100.,  100.,  100.,  100.,  100.,  100.,  100.,  100.], dtype=float32)
+    """
+    return _BulkScope(size)
@@ -46,6 +46,17 @@ def _updater_wrapper(updater):
     return updater_handle
 
 
+def _row_sparse_updater_wrapper(updater):
+    """A wrapper passing row-sparse values as a (row_ids, values) tuple to the updater."""
+    def updater_handle(key, ids_handle, lhs_handle, rhs_handle, _):
+        """ ctypes function """
+        ids = NDArray(NDArrayHandle(ids_handle))
+        lhs = NDArray(NDArrayHandle(lhs_handle))
+        rhs = NDArray(NDArrayHandle(rhs_handle))
+        updater(key, (ids, lhs), rhs)
+    return updater_handle
+
+
 class KVStore(object):
     """A key-value store for synchronization of values, over multiple devices."""
     def __init__(self, handle):
@@ -60,6 +71,7 @@ class KVStore(object):
         self.handle = handle
         self._updater = None
         self._updater_func = None
+        self._row_sparse_updater_func = None
 
     def __del__(self):
         check_call(_LIB.MXKVStoreFree(self.handle))
@@ -223,6 +235,73 @@ class KVStore(object):
             self.handle, mx_uint(len(ckeys)), ckeys, cvals,
             ctypes.c_int(priority)))
 
+    def push_row_sparse(self, key, row_ids, value, priority=0):
+        """ Pushes row-sparse values into the store.
+
+        A row-sparse value only holds some rows of the 2D value stored on a key:
+        ``value[i]`` is the value of row ``row_ids[i]``. Negative row ids are
+        ignored. Values pushed from several devices are summed per row, then only
+        these rows are updated by the updater, or assigned if there is none. The
+        updater receives the value as a ``(row_ids, values)`` tuple.
+
+        Parameters
+        ----------
+        key : int or list of int
+            Keys.
+
+        row_ids : NDArray or list of NDArray or list of list of NDArray
+            1D row ids corresponding to the values.
+
+        value : NDArray or list of NDArray or list of list of NDArray
+            2D values corresponding to the keys.
+
+        priority : int, optional
+            The priority of the push operation.
+
+        Examples
+        --------
+        >>> kv.init(3, mx.nd.zeros((4, 2)))
+        >>> kv.push_row_sparse(3, mx.nd.array([1, 3]), mx.nd.ones((2, 2)))
+        >>> a = mx.nd.zeros((2, 2))
+        >>> kv.pull_row_sparse(3, out=a, row_ids=mx.nd.array([0, 3]))
+        >>> print a.asnumpy()
+        [[ 0.  0.]
+        [ 1.  1.]]
+        """
+        ckeys, cids = _ctype_key_value(key, row_ids)
+        _, cvals = _ctype_key_value(key, value)
+        check_call(_LIB.MXKVStorePushRowSparse(
+            self.handle, mx_uint(len(ckeys)), ckeys, cids, cvals,
+            ctypes.c_int(priority)))
+
+    def pull_row_sparse(self, key, out=None, row_ids=None, priority=0):
+        """ Pulls the given rows of a single value or a sequence of values from the store.
+
+        Row ``j`` of `out` receives row ``row_ids[j]`` of the stored value, or
+        zeros if the row id is negative.
+
+        Parameters
+        ----------
+        key : int or list of int
+            Keys.
+
+        out: NDArray or list of NDArray or list of list of NDArray
+            2D buffers with one row per row id.
+
+        row_ids : NDArray or list of NDArray or list of list of NDArray
+            1D row ids to pull, corresponding to `out`.
+
+        priority : int, optional
+            The priority of the pull operation.
+        """
+        assert(out is not None)
+        assert(row_ids is not None)
+        ckeys, cvals = _ctype_key_value(key, out)
+        _, cids = _ctype_key_value(key, row_ids)
+        check_call(_LIB.MXKVStorePullRowSparse(
+            self.handle, mx_uint(len(ckeys)), ckeys, cids, cvals,
+            ctypes.c_int(priority)))
+
     def set_optimizer(self, optimizer):
         """ Registers an optimizer with the store.
 
@@ -345,6 +424,12 @@ class KVStore(object):
             None, ctypes.c_int, NDArrayHandle, NDArrayHandle, ctypes.c_void_p)
         self._updater_func = _updater_proto(_updater_wrapper(updater))
         check_call(_LIB.MXKVStoreSetUpdater(self.handle, self._updater_func, None))
+        _row_sparse_updater_proto = ctypes.CFUNCTYPE(
+            None, ctypes.c_int, NDArrayHandle, NDArrayHandle, NDArrayHandle, ctypes.c_void_p)
+        self._row_sparse_updater_func = _row_sparse_updater_proto(
+            _row_sparse_updater_wrapper(updater))
+        check_call(_LIB.MXKVStoreSetRowSparseUpdater(
+            self.handle, self._row_sparse_updater_func, None))
 
 
     def _barrier(self):
@@ -19,7 +19,7 @@ import operator
 import numpy as np
 from .base import _LIB, string_types, numeric_types
 from .base import c_array, py_str, c_str, mx_real_t
-from .base import mx_uint, NDArrayHandle, check_call
+from .base import mx_uint, NDArrayHandle, OpHandle, CachedOpHandle, check_call
 from .base import ctypes2buffer
 from .context import Context
 from . import _ndarray_internal as _internal
@@ -874,6 +874,80 @@ fixed-size items.
 
 _init_ndarray_module(NDArray, "mxnet")
 
+class CachedOp(object):
+    """An operator whose parameters are parsed once, for calling it many times
+    with less overhead than the functions of ``mx.nd``. Shape and type inference
+    is skipped when the arrays have the same shapes and types as in the last call.
+
+    Parameters
+    ----------
+    op_name : str
+        Name of the operator.
+    num_inputs : int
+        Number of input arrays of every call.
+    **kwargs
+        Parameters of the operator.
+
+    Examples
+    --------
+    >>> add = mx.nd.CachedOp('_plus_scalar', 1, scalar=1)
+    >>> x = mx.nd.ones((2,3))
+    >>> add(x).asnumpy()
+    array([[ 2.,  2.,  2.],
+           [ 2.,  2.,  2.]], dtype=float32)
+    >>> add(x, out=x).asnumpy()
+    array([[ 2.,  2.,  2.],
+           [ 2.,  2.,  2.]], dtype=float32)
+    """
+    def __init__(self, op_name, num_inputs, **kwargs):
+        op = OpHandle()
+        check_call(_LIB.NNGetOpHandle(c_str(op_name), ctypes.byref(op)))
+        keys = [c_str(key) for key in kwargs]
+        vals = [c_str(str(val)) for val in kwargs.values()]
+        self.num_inputs = num_inputs
+        self.handle = CachedOpHandle()
+        check_call(_LIB.MXCreateCachedOp(
+            op,
+            ctypes.c_int(num_inputs),
+            ctypes.c_int(len(keys)),
+            c_array(ctypes.c_char_p, keys),
+            c_array(ctypes.c_char_p, vals),
+            ctypes.byref(self.handle)))
+
+    def __del__(self):
+        check_call(_LIB.MXFreeCachedOp(self.handle))
+
+    def __call__(self, *args, **kwargs):
+        """Invokes the operator on the input arrays, returns the output array or
+        the list of output arrays. The outputs are written to ``out`` when given."""
+        out = kwargs.pop('out', None)
+        if kwargs:
+            raise TypeError('CachedOp only accepts the out keyword argument, got %s'
+                            % str(list(kwargs.keys())))
+        if out is not None:
+            original_output = out
+            if isinstance(out, NDArrayBase):
+                out = (out,)
+            num_output = ctypes.c_int(len(out))
+            output_vars = c_array(NDArrayHandle, [i.handle for i in out])
+            output_vars = ctypes.cast(output_vars, ctypes.POINTER(NDArrayHandle))
+        else:
+            original_output = None
+            output_vars = ctypes.POINTER(NDArrayHandle)()
+            num_output = ctypes.c_int(0)
+        check_call(_LIB.MXInvokeCachedOp(
+            self.handle,
+            ctypes.c_int(len(args)),
+            c_array(NDArrayHandle, [arr.handle for arr in args]),
+            ctypes.byref(num_output),
+            ctypes.byref(output_vars)))
+        if original_output is not None:
+            return original_output
+        if num_output.value == 1:
+            return NDArray(ctypes.cast(output_vars[0], NDArrayHandle))
+        return [NDArray(ctypes.cast(output_vars[i], NDArrayHandle))
+                for i in range(num_output.value)]
+
 def onehot_encode(indices, out):
     """One-hot encoding indices into matrix out.
 
@@ -2052,7 +2126,7 @@ def load(fname):
             (py_str(names[i]), NDArray(NDArrayHandle(handles[i]))) for i in range(out_size.value))
 
 
-def save(fname, data):
+def save(fname, data, compress=False, background=False):
     """Saves a list of arrays or a dict of str->array to file.
 
     Examples of filenames:
@@ -2067,6 +2141,13 @@ def save(fname, data):
         The filename.
     data : list of ``NDArray` or dict of str to ``NDArray``
         The data to save.
+    compress : bool, optional
+        Whether to compress the arrays. Compressed files can not be loaded by
+        versions older than this one.
+    background : bool, optional
+        Whether to write the file in background. The arrays are copied before
+        returning, the file is complete after ``mx.nd.waitall()``. A failed
+        write raises an error from the next ``mx.nd.waitall()`` or ``save``.
 
     Examples
     --------
@@ -2096,10 +2177,12 @@ def save(fname, data):
                 raise TypeError('save only accept dict str->NDArray or list of NDArray')
             handles.append(val.handle)
         keys = None
-    check_call(_LIB.MXNDArraySave(c_str(fname),
-                                  mx_uint(len(handles)),
-                                  c_array(NDArrayHandle, handles),
-                                  keys))
+    check_call(_LIB.MXNDArraySaveEx(c_str(fname),
+                                    mx_uint(len(handles)),
+                                    c_array(NDArrayHandle, handles),
+                                    keys,
+                                    ctypes.c_int(compress),
+                                    ctypes.c_int(background)))
 
 
 def concatenate(arrays, axis=0, always_copy=True):
@@ -4,6 +4,7 @@ import pickle
 import logging
 from .ndarray import NDArray, zeros, clip, sqrt, sign
 from .ndarray import sgd_update, sgd_mom_update, adam_update, rmsprop_update, rmspropalex_update
+from .ndarray import sparse_sgd_update, sparse_sgd_mom_update
 from .random import normal
 
 
@@ -308,12 +309,28 @@ class SGD(Optimizer):
             return zeros(weight.shape, weight.context, dtype=weight.dtype)
 
     def update(self, index, weight, grad, state):
+        """Updates the weight.
+
+        `grad` is either an NDArray or a row-sparse gradient ``(row_ids, values)``,
+        for instance as returned by ``contrib.nd.embedding_row_sparse_grad``,
+        in which case only the rows in `row_ids` are updated.
+        """
         assert(isinstance(weight, NDArray))
-        assert(isinstance(grad, NDArray))
         lr = self._get_lr(index)
         wd = self._get_wd(index)
         self._update_count(index)
 
+        if isinstance(grad, tuple):
+            row_ids, values = grad
+            if state is not None:
+                sparse_sgd_mom_update(weight, values, row_ids, state, out=weight,
+                                      lr=lr, wd=wd, **self.kwargs)
+            else:
+                sparse_sgd_update(weight, values, row_ids, out=weight,
+                                  lr=lr, wd=wd, **self.kwargs)
+            return
+
+        assert(isinstance(grad, NDArray))
         if state is not None:
             sgd_mom_update(weight, grad, state, out=weight,
                            lr=lr, wd=wd, **self.kwargs)
@@ -76,6 +76,12 @@ int MXNotifyShutdown() {
   API_END();
 }
 
+int MXEngineSetBulkSize(int bulk_size, int* prev_bulk_size) {
+  API_BEGIN();
+  *prev_bulk_size = Engine::Get()->set_bulk_size(bulk_size);
+  API_END();
+}
+
 int MXSetProfilerConfig(int mode, const char* filename) {
   // mode, kOnlySymbolic: 0, kAllOperator: 1
   API_BEGIN();
@@ -205,6 +211,7 @@ int MXNDArrayWaitToWrite(NDArrayHandle handle) {
 int MXNDArrayWaitAll() {
   API_BEGIN();
   Engine::Get()->WaitForAll();
+  mxnet::NDArray::CheckBackgroundSaves();
   API_END();
 }
 
@@ -224,10 +231,29 @@ int MXNDArraySave(const char* fname,
       names[i] = keys[i];
     }
   }
-  {
-    std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(fname, "w"));
-    mxnet::NDArray::Save(fo.get(), data, names);
+  mxnet::NDArray::Save(fname, data, names, false, false);
+  API_END();
+}
+
+int MXNDArraySaveEx(const char* fname,
+                    mx_uint num_args,
+                    NDArrayHandle* args,
+                    const char** keys,
+                    int compress,
+                    int background) {
+  API_BEGIN();
+  std::vector<NDArray> data(num_args);
+  std::vector<std::string> names;
+  for (mx_uint i = 0; i < num_args; ++i) {
+    data[i] = *static_cast<NDArray*>(args[i]);
   }
+  if (keys != nullptr) {
+    names.resize(num_args);
+    for (mx_uint i = 0; i < num_args; ++i) {
+      names[i] = keys[i];
+    }
+  }
+  mxnet::NDArray::Save(fname, data, names, compress != 0, background != 0);
   API_END();
 }
 
@@ -619,6 +645,65 @@ int MXKVStoreSetUpdater(KVStoreHandle handle,
   API_END();
 }
 
+int MXKVStorePushRowSparse(KVStoreHandle handle,
+                           mx_uint num,
+                           const int* keys,
+                           NDArrayHandle* row_ids,
+                           NDArrayHandle* vals,
+                           int priority) {
+  API_BEGIN();
+  std::vector<int> v_keys(num);
+  std::vector<NDArray> v_ids(num);
+  std::vector<NDArray> v_vals(num);
+  for (mx_uint i = 0; i < num; ++i) {
+    v_keys[i] = keys[i];
+    v_ids[i] = *static_cast<NDArray*>(row_ids[i]);
+    v_vals[i] = *static_cast<NDArray*>(vals[i]);
+  }
+  static_cast<KVStore*>(handle)->PushRowSparse(v_keys, v_ids, v_vals, priority);
+  API_END();
+}
+
+int MXKVStorePullRowSparse(KVStoreHandle handle,
+                           mx_uint num,
+                           const int* keys,
+                           NDArrayHandle* row_ids,
+                           NDArrayHandle* vals,
+                           int priority) {
+  API_BEGIN();
+  std::vector<int> v_keys(num);
+  std::vector<NDArray> v_ids(num);
+  std::vector<NDArray*> v_vals(num);
+  for (mx_uint i = 0; i < num; ++i) {
+    v_keys[i] = keys[i];
+    v_ids[i] = *static_cast<NDArray*>(row_ids[i]);
+    v_vals[i] = static_cast<NDArray*>(vals[i]);
+  }
+  static_cast<KVStore*>(handle)->PullRowSparse(v_keys, v_ids, v_vals, priority);
+  API_END();
+}
+
+int MXKVStoreSetRowSparseUpdater(KVStoreHandle handle,
+                                 MXKVStoreRowSparseUpdater updater,
+                                 void* updater_handle) {
+  API_BEGIN();
+  MXKVStoreRowSparseUpdater * updater_temp = updater;
+  void* updater_handle_temp = updater_handle;
+  KVStore::RowSparseUpdater updt
+  = [updater_temp, updater_handle_temp](int key, const NDArray& row_ids,
+                                        const NDArray& recv, NDArray* local) {
+    NDArray* ids_copy = new NDArray();
+    *ids_copy = row_ids;
+    NDArray* recv_copy = new NDArray();
+    *recv_copy = recv;
+    NDArray* local_copy = new NDArray();
+    *local_copy = *local;
+    updater_temp(key, ids_copy, recv_copy, local_copy, updater_handle_temp);
+  };
+  static_cast<KVStore*>(handle)->set_row_sparse_updater(updt);
+  API_END();
+}
+
 int MXKVStoreGetRank(KVStoreHandle handle, int *rank) {
   API_BEGIN();
   *rank = static_cast<KVStore*>(handle)->get_rank();
@@ -11,7 +11,9 @@
 #include <mxnet/op_attr_types.h>
 #include <nnvm/node.h>
 #include <nnvm/op_attr_types.h>
+#include <algorithm>
 #include <string>
+#include <vector>
 #include "./c_api_common.h"
 #include "../common/utils.h"
 #include "../ndarray/autograd.h"
@@ -120,6 +122,28 @@ void SetContext(Context* p_ctx,
   }
 }
 
+void SetOutputArrays(const nnvm::Op* op,
+                     const Context& ctx,
+                     const std::vector<TShape>& out_shapes,
+                     const std::vector<int>& out_types,
+                     std::vector<NDArray>* p_ndoutputs) {
+  std::vector<NDArray>& ndoutputs = *p_ndoutputs;
+  for (size_t i = 0; i < ndoutputs.size(); ++i) {
+    if (ndoutputs[i].is_none()) {
+      ndoutputs[i] = NDArray(out_shapes[i], ctx, true, out_types[i]);
+    } else {
+      CHECK_EQ(ndoutputs[i].shape(), out_shapes[i])
+        << i << "th output has invalid shape. "
+        << "Expecting " << out_shapes[i] << " got "
+        << ndoutputs[i].shape() << " in operator " << op->name;
+      CHECK_EQ(ndoutputs[i].dtype(), out_types[i])
+        << i << "th output has invalid shape. "
+        << "Expecting " << out_types[i] << " got "
+        << ndoutputs[i].dtype()  << " in operator " << op->name;
+    }
+  }
+}
+
 void SetShapeType(const nnvm::Op* op,
                   const nnvm::NodeAttrs& attrs,
                   const Context& ctx,
@@ -164,46 +188,29 @@ void SetShapeType(const nnvm::Op* op,
   CHECK(infertype[op](attrs, &in_types, &out_types));
   CHECK_EQ(out_types.size(), static_cast<size_t>(infered_num_outputs));
 
-  for (int i = 0; i < infered_num_outputs; ++i) {
-    if (ndoutputs[i].is_none()) {
-      ndoutputs[i] = NDArray(out_shapes[i], ctx, true, out_types[i]);
-    } else {
-      CHECK_EQ(ndoutputs[i].shape(), out_shapes[i])
-        << i << "th output has invalid shape. "
-        << "Expecting " << out_shapes[i] << " got "
-        << ndoutputs[i].shape() << " in operator " << op->name;
-      CHECK_EQ(ndoutputs[i].dtype(), out_types[i])
-        << i << "th output has invalid shape. "
-        << "Expecting " << out_types[i] << " got "
-        << ndoutputs[i].dtype()  << " in operator " << op->name;
-    }
-  }
+  SetOutputArrays(op, ctx, out_shapes, out_types, &ndoutputs);
 }
 
 void SetDependency(std::vector<engine::VarHandle> *p_read_vars,
                    std::vector<engine::VarHandle> *p_write_vars,
                    std::vector<Resource> *p_requested,
-                   std::vector<uint32_t> *p_auxidx,
-                   const nnvm::Op* op,
-                   const nnvm::NodeAttrs& attrs,
+                   const std::vector<ResourceRequest>& resources,
+                   const std::vector<uint32_t>& auxidx,
                    const Context& ctx,
                    const std::vector<NDArray>& ndinputs,
                    const std::vector<NDArray>& ndoutputs) {
-  static auto& mutate = nnvm::Op::GetAttr<nnvm::FMutateInputs>("FMutateInputs");
-  static auto& tmp_resource = nnvm::Op::GetAttr<FResourceRequest>("FResourceRequest");
-
   std::vector<engine::VarHandle>& read_vars  = *p_read_vars;
   std::vector<engine::VarHandle>& write_vars = *p_write_vars;
   std::vector<Resource>& requested = *p_requested;
-  std::vector<uint32_t>& auxidx = *p_auxidx;
 
-  if (tmp_resource.count(op)) {
+  if (resources.size()) {
     int ntmp = 0;
-    for (const auto& req : tmp_resource[op](attrs)) {
+    for (const auto& req : resources) {
       switch (req.type) {
        case ResourceRequest::kTempSpace:
         ++ntmp;
        case ResourceRequest::kRandom:
+       case ResourceRequest::kParallelRandom:
         requested.push_back(ResourceManager::Get()->Request(ctx, req));
         write_vars.push_back(requested.back().var);
         break;
@@ -220,16 +227,36 @@ void SetDependency(std::vector<engine::VarHandle> *p_read_vars,
   for (auto& i : ndoutputs) {
     write_vars.push_back(i.var());
   }
-  if (mutate.count(op)) {
-    auxidx = mutate[op](attrs);
-    std::sort(auxidx.begin(), auxidx.end());
-    for (auto & i : auxidx) {
-      write_vars.push_back(ndinputs[i].var());
-    }
+  for (auto & i : auxidx) {
+    write_vars.push_back(ndinputs[i].var());
   }
   Engine::Get()->DeduplicateVarHandle(&read_vars, &write_vars);
 }
 
+void SetDependency(std::vector<engine::VarHandle> *p_read_vars,
+                   std::vector<engine::VarHandle> *p_write_vars,
+                   std::vector<Resource> *p_requested,
+                   std::vector<uint32_t> *p_auxidx,
+                   const nnvm::Op* op,
+                   const nnvm::NodeAttrs& attrs,
+                   const Context& ctx,
+                   const std::vector<NDArray>& ndinputs,
+                   const std::vector<NDArray>& ndoutputs) {
+  static auto& mutate = nnvm::Op::GetAttr<nnvm::FMutateInputs>("FMutateInputs");
+  static auto& tmp_resource = nnvm::Op::GetAttr<FResourceRequest>("FResourceRequest");
+
+  std::vector<ResourceRequest> resources;
+  if (tmp_resource.count(op)) {
+    resources = tmp_resource[op](attrs);
+  }
+  if (mutate.count(op)) {
+    *p_auxidx = mutate[op](attrs);
+    std::sort(p_auxidx->begin(), p_auxidx->end());
+  }
+  SetDependency(p_read_vars, p_write_vars, p_requested,
+      resources, *p_auxidx, ctx, ndinputs, ndoutputs);
+}
+
 void PushFCompute(const FCompute& fn,
                   const nnvm::Op* op,
                   const nnvm::NodeAttrs& attrs,
@@ -240,10 +267,9 @@ void PushFCompute(const FCompute& fn,
                   const std::vector<NDArray>& ndinputs,
                   const std::vector<NDArray>& ndoutputs) {
   bool is_train = AutogradRuntime::Get()->IsTraining();
-  Engine::Get()->PushAsync(
-    [ctx, attrs, fn, ndinputs, ndoutputs, requested, is_train](
-        RunContext rctx,
-        engine::CallbackOnComplete on_complete) {
+  // pushed as synchronous so that the engine can group it with its neighbours
+  Engine::Get()->PushSync(
+    [ctx, attrs, fn, ndinputs, ndoutputs, requested, is_train](RunContext rctx) {
       std::vector<TBlob> input_blobs, output_blobs;
       for (auto& i : ndinputs) {
         input_blobs.push_back(i.data());
@@ -259,7 +285,6 @@ void PushFCompute(const FCompute& fn,
       if (ctx.dev_mask() == gpu::kDevMask) {
         rctx.get_stream<gpu>()->Wait();
       }
-      on_complete();
     }, ctx, read_vars, write_vars, FnProperty::kNormal,
     0, PROFILER_MESSAGE(op->name.c_str()));
 }
@@ -319,6 +344,64 @@ void PushOperator(std::shared_ptr<Operator> opr,
     0, PROFILER_MESSAGE(op->name.c_str()));
 }
 
+void PushImperative(const FCompute& fn,
+                    const nnvm::Op* op,
+                    const nnvm::NodeAttrs& attrs,
+                    const Context& ctx,
+                    const std::vector<TShape>& in_shapes,
+                    const std::vector<int>& in_types,
+                    const std::vector<engine::VarHandle>& read_vars,
+                    const std::vector<engine::VarHandle>& write_vars,
+                    const std::vector<Resource>& requested,
+                    const std::vector<uint32_t>& auxidx,
+                    std::vector<NDArray>* p_ndinputs,
+                    std::vector<NDArray>* p_ndoutputs) {
+  static auto& createop = nnvm::Op::GetAttr<FCreateLayerOp>("FCreateLayerOp");
+  if (fn) {
+    if (AutogradRuntime::Get()->IsTraining()) {
+      AutogradRuntime::Get()->RecordImperativeFCompute(fn, op,
+          attrs, p_ndinputs, p_ndoutputs);
+    }
+    PushFCompute(fn, op, attrs, ctx, read_vars, write_vars,
+        requested, *p_ndinputs, *p_ndoutputs);
+  } else if (createop.count(op)) {
+    std::shared_ptr<Operator> opr(
+        createop[op](attrs, ctx, in_shapes, in_types));
+    if (AutogradRuntime::Get()->IsTraining()) {
+      AutogradRuntime::Get()->RecordImperativeOperator(opr, op,
+          attrs, p_ndinputs, p_ndoutputs);
+    }
+    PushOperator(opr, op, attrs, ctx, read_vars, write_vars,
+        requested, auxidx, *p_ndinputs, *p_ndoutputs);
+  } else {
+    LOG(FATAL)
+      << "Operator " << op->name
+      << " cannot be run; requires at least one of"
+      << " FCompute<xpu>, NDArrayFunction, FCreateOperator be registered";
+  }
+}
+
+void SetOutputHandles(const int& num_visible_outputs,
+                      NDArray** outarray,
+                      int *num_outputs,
+                      NDArrayHandle **outputs,
+                      std::vector<NDArray>* p_ndoutputs) {
+  std::vector<NDArray>& ndoutputs = *p_ndoutputs;
+  if (outarray == nullptr) {
+    MXAPIThreadLocalEntry *ret = MXAPIThreadLocalStore::Get();
+    ret->ret_handles.clear();
+    for (int i = 0; i < num_visible_outputs; ++i) {
+      ret->ret_handles.push_back(
+        reinterpret_cast<NDArrayHandle>(new NDArray(std::move(ndoutputs[i]))));
+    }
+    *outputs = dmlc::BeginPtr(ret->ret_handles);
+  } else {
+    for (int i = 0; i < *num_outputs; ++i) {
+      *outarray[i] = std::move(ndoutputs[i]);
+    }
+  }
+}
+
 int MXImperativeInvoke(AtomicSymbolCreator creator,
                        int num_inputs,
                        NDArrayHandle *inputs,
@@ -330,7 +413,6 @@ int MXImperativeInvoke(AtomicSymbolCreator creator,
   static auto& fcpu = nnvm::Op::GetAttr<FCompute>("FCompute<cpu>");
   static auto& fgpu = nnvm::Op::GetAttr<FCompute>("FCompute<gpu>");
   static auto& ndfunc = nnvm::Op::GetAttr<FNDArrayFunction>("FNDArrayFunction");
-  static auto& createop = nnvm::Op::GetAttr<FCreateLayerOp>("FCreateLayerOp");
   const nnvm::Op* op = static_cast<nnvm::Op*>(creator);
   NDArray** outarray = *reinterpret_cast<NDArray***>(outputs);
   MXAPIThreadLocalEntry *ret = MXAPIThreadLocalStore::Get();
@@ -369,44 +451,157 @@ int MXImperativeInvoke(AtomicSymbolCreator creator,
     } else if (ctx.dev_mask() == gpu::kDevMask && fgpu.count(op)) {
       fn = fgpu[op];
     }
+    PushImperative(fn, op, attrs, ctx, ret->arg_shapes, ret->arg_types,
+        read_vars, write_vars, requested, auxidx, &ndinputs, &ndoutputs);
+  }
 
-    if (fn) {
-      if (AutogradRuntime::Get()->IsTraining()) {
-        AutogradRuntime::Get()->RecordImperativeFCompute(fn, op,
-            attrs, &ndinputs, &ndoutputs);
-      }
-      PushFCompute(fn, op, attrs, ctx, read_vars, write_vars,
-          requested, ndinputs, ndoutputs);
-    } else if (createop.count(op)) {
-      std::shared_ptr<Operator> opr(
-          createop[op](attrs, ctx, ret->arg_shapes, ret->arg_types));
-      if (AutogradRuntime::Get()->IsTraining()) {
-        AutogradRuntime::Get()->RecordImperativeOperator(opr, op,
-            attrs, &ndinputs, &ndoutputs);
-      }
-      PushOperator(opr, op, attrs, ctx, read_vars, write_vars,
-          requested, auxidx, ndinputs, ndoutputs);
-    } else {
-      LOG(FATAL)
-        << "Operator " << op->name
-        << " cannot be run; requires at least one of"
-        << " FCompute<xpu>, NDArrayFunction, FCreateOperator be registered";
-    }
+  SetOutputHandles(num_visible_outputs, outarray, num_outputs, outputs, &ndoutputs);
+  API_END();
+}
+
+/*!
+ * \brief an operator whose parameters are parsed and whose attributes are
+ *  looked up once by MXCreateCachedOp, with the result of the last shape and
+ *  type inference.
+ */
+struct CachedOp {
+  const nnvm::Op* op;
+  nnvm::NodeAttrs attrs;
+  int num_inputs;
+  int num_outputs;
+  int num_visible_outputs;
+  FNDArrayFunction ndfunc;
+  FCompute fcompute_cpu;
+  FCompute fcompute_gpu;
+  std::vector<ResourceRequest> resources;
+  /*! \brief sorted indices of the mutated inputs */
+  std::vector<uint32_t> auxidx;
+  /*! \brief whether the fields below are valid */
+  bool infered = false;
+  /*! \brief shapes and types of the inputs then the outputs before inference */
+  std::vector<TShape> given_shapes;
+  std::vector<int> given_types;
+  /*! \brief infered shapes and types */
+  std::vector<TShape> in_shapes, out_shapes;
+  std::vector<int> in_types, out_types;
+  /*! \brief buffers reused by every invocation */
+  std::vector<engine::VarHandle> read_vars, write_vars;
+};
+
+int MXCreateCachedOp(AtomicSymbolCreator creator,
+                     int num_inputs,
+                     int num_params,
+                     const char **param_keys,
+                     const char **param_vals,
+                     CachedOpHandle *out) {
+  static auto& fcpu = nnvm::Op::GetAttr<FCompute>("FCompute<cpu>");
+  static auto& fgpu = nnvm::Op::GetAttr<FCompute>("FCompute<gpu>");
+  static auto& ndfunc = nnvm::Op::GetAttr<FNDArrayFunction>("FNDArrayFunction");
+  static auto& mutate = nnvm::Op::GetAttr<nnvm::FMutateInputs>("FMutateInputs");
+  static auto& tmp_resource = nnvm::Op::GetAttr<FResourceRequest>("FResourceRequest");
+  const nnvm::Op* op = static_cast<nnvm::Op*>(creator);
+  CachedOp *cached = new CachedOp();
+
+  API_BEGIN();
+  cached->op = op;
+  cached->num_inputs = num_inputs;
+  SetOpAttrs(op, &cached->attrs,
+      num_inputs, num_params, param_keys, param_vals);
+  SetNumOutputs(op, cached->attrs, num_inputs,
+      &cached->num_outputs, &cached->num_visible_outputs);
+  if (ndfunc.count(op)) {
+    cached->ndfunc = ndfunc[op];
+  }
+  if (fcpu.count(op)) {
+    cached->fcompute_cpu = fcpu[op];
   }
+  if (fgpu.count(op)) {
+    cached->fcompute_gpu = fgpu[op];
+  }
+  if (tmp_resource.count(op)) {
+    cached->resources = tmp_resource[op](cached->attrs);
+  }
+  if (mutate.count(op)) {
+    cached->auxidx = mutate[op](cached->attrs);
+    std::sort(cached->auxidx.begin(), cached->auxidx.end());
+  }
+  *out = cached;
+  API_END_HANDLE_ERROR(delete cached);
+}
 
+int MXFreeCachedOp(CachedOpHandle handle) {
+  API_BEGIN();
+  delete static_cast<CachedOp*>(handle);
+  API_END();
+}
 
-  if (outarray == nullptr) {
-    ret->ret_handles.clear();
-    for (int i = 0; i < num_visible_outputs; ++i) {
-      ret->ret_handles.push_back(
-        reinterpret_cast<NDArrayHandle>(new NDArray(std::move(ndoutputs[i]))));
-    }
-    *outputs = dmlc::BeginPtr(ret->ret_handles);
+int MXInvokeCachedOp(CachedOpHandle handle,
+                     int num_inputs,
+                     NDArrayHandle *inputs,
+                     int *num_outputs,
+                     NDArrayHandle **outputs) {
+  CachedOp *cached = static_cast<CachedOp*>(handle);
+  const nnvm::Op* op = cached->op;
+  const nnvm::NodeAttrs& attrs = cached->attrs;
+  NDArray** outarray = *reinterpret_cast<NDArray***>(outputs);
+
+  API_BEGIN();
+  CHECK_EQ(num_inputs, cached->num_inputs)
+    << "Expecting " << cached->num_inputs << " inputs, got "
+    << num_inputs << " in operator " << op->name;
+  std::vector<NDArray> ndinputs, ndoutputs;
+  SetNDInputsOutputs(op, &ndinputs, &ndoutputs, num_inputs, inputs,
+      num_outputs, cached->num_outputs, cached->num_visible_outputs, outarray);
+
+  if (cached->ndfunc) {
+    cached->ndfunc(attrs, ndinputs, &ndoutputs);
   } else {
-    for (int i = 0; i < *num_outputs; ++i) {
-      *outarray[i] = std::move(ndoutputs[i]);
+    Context ctx;
+    SetContext(&ctx, attrs, num_inputs, ndinputs, cached->num_outputs, ndoutputs);
+
+    // infer again only when a shape or type differs from the last invocation
+    bool same = cached->infered;
+    for (size_t i = 0; same && i < ndinputs.size() + ndoutputs.size(); ++i) {
+      const NDArray& arr = i < ndinputs.size() ? ndinputs[i] : ndoutputs[i - ndinputs.size()];
+      same = arr.shape() == cached->given_shapes[i] && arr.dtype() == cached->given_types[i];
+    }
+    if (same) {
+      SetOutputArrays(op, ctx, cached->out_shapes, cached->out_types, &ndoutputs);
+    } else {
+      cached->infered = false;
+      cached->given_shapes.clear();
+      cached->given_types.clear();
+      for (const auto& arr : ndinputs) {
+        cached->given_shapes.push_back(arr.shape());
+        cached->given_types.push_back(arr.dtype());
+      }
+      for (const auto& arr : ndoutputs) {
+        cached->given_shapes.push_back(arr.shape());
+        cached->given_types.push_back(arr.dtype());
+      }
+      SetShapeType(op, attrs, ctx, ndinputs, cached->num_outputs, &ndoutputs);
+      MXAPIThreadLocalEntry *ret = MXAPIThreadLocalStore::Get();
+      cached->in_shapes = ret->arg_shapes;
+      cached->out_shapes = ret->out_shapes;
+      cached->in_types = ret->arg_types;
+      cached->out_types = ret->out_types;
+      cached->infered = true;
     }
+
+    std::vector<Resource> requested;
+    cached->read_vars.clear();
+    cached->write_vars.clear();
+    SetDependency(&cached->read_vars, &cached->write_vars, &requested,
+        cached->resources, cached->auxidx, ctx, ndinputs, ndoutputs);
+
+    const FCompute& fn = ctx.dev_mask() == cpu::kDevMask ?
+        cached->fcompute_cpu : cached->fcompute_gpu;
+    PushImperative(fn, op, attrs, ctx, cached->in_shapes, cached->in_types,
+        cached->read_vars, cached->write_vars, requested, cached->auxidx,
+        &ndinputs, &ndoutputs);
   }
+
+  SetOutputHandles(cached->num_visible_outputs, outarray, num_outputs, outputs, &ndoutputs);
   API_END();
 }
 
@@ -547,3 +547,12 @@ int MXSymbolGrad(SymbolHandle sym, mx_uint num_wrt, const char** wrt, SymbolHand
   LOG(FATAL) << "not implemented";
   API_END();
 }
+
+int MXQuantizeSymbol(SymbolHandle sym, SymbolHandle* out) {
+  nnvm::Symbol *s = new nnvm::Symbol();
+  API_BEGIN();
+  nnvm::Graph g = Symbol2Graph(*static_cast<nnvm::Symbol*>(sym));
+  s->outputs = nnvm::ApplyPass(std::move(g), "QuantizeGraph").outputs;
+  *out = s;
+  API_END_HANDLE_ERROR(delete s);
+}
@@ -10,6 +10,7 @@
 #include <map>
 #include <mutex>
 #include <chrono>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include "./profiler.h"
@@ -106,6 +107,17 @@ OprExecStat *Profiler::AddOprStat(int dev_type, uint32_t dev_id) {
   return opr_stat;
 }
 
+void Profiler::AddCounter(const char *name, int64_t value) {
+  if (state_ != kRunning) return;
+  CounterStat stat;
+  strncpy(stat.name, name, sizeof(stat.name) - 1);
+  stat.name[sizeof(stat.name) - 1] = '\0';
+  stat.rel_micros = NowInUsec() - init_time_;
+  stat.value = value;
+  std::lock_guard<std::mutex> lock{this->counter_m_};
+  counter_stats_.push_back(stat);
+}
+
 void Profiler::EmitPid(std::ostream *os, const std::string& name, uint32_t pid) {
   (*os) << "        {\n"
         << "            \"ph\": \"M\",\n"
@@ -130,6 +142,17 @@ void Profiler::EmitEvent(std::ostream *os, const std::string& name,
         << "        }";
 }
 
+void Profiler::EmitCounter(std::ostream *os, const CounterStat& stat, uint32_t pid) {
+  (*os) << "        {\n"
+        << "            \"name\": \""  << stat.name << "\",\n"
+        << "            \"ph\": \"C\",\n"
+        << "            \"ts\": "  << stat.rel_micros << ",\n"
+        << "            \"pid\": " << pid << ",\n"
+        << "            \"args\": {\n"
+        << "                \"value\": " << stat.value << "\n"
+        << "            }\n"
+        << "        }";
+}
 
 void Profiler::DumpProfile() {
   SetState(kNotRunning);
@@ -148,6 +171,8 @@ void Profiler::DumpProfile() {
     this->EmitPid(&file, d.dev_name, i);
     file << ",\n";
   }
+  this->EmitPid(&file, "counters", dev_num);
+  file << ",\n";
 
   bool first_flag = true;
   for (uint32_t i = 0; i < dev_num; ++i) {
@@ -174,6 +199,18 @@ void Profiler::DumpProfile() {
             opr_stat->opr_end_rel_micros, pid, tid);
     }
   }
+  {
+    std::lock_guard<std::mutex> lock(counter_m_);
+    for (const CounterStat& stat : counter_stats_) {
+      if (first_flag) {
+        first_flag = false;
+      } else {
+        file << ",";
+      }
+      file << std::endl;
+      this->EmitCounter(&file, stat, dev_num);
+    }
+  }
 
   file << "\n" << std::endl;
   file << "    ]," << std::endl;
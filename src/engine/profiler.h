@@ -41,6 +41,21 @@ struct OprExecStat {
   uint32_t dev_id;
 };
 
+/*!
+ * \brief a sample of a counter, such as the depth of a queue
+ */
+struct CounterStat {
+  /*! \brief counter name */
+  char name[32];
+  /*!
+   * \brief sample relative timestamp
+   *        time unit is microsecond (10^-6 s)
+   */
+  uint64_t rel_micros;
+  /*! \brief value of the counter */
+  int64_t value;
+};
+
 /*!
  * \brief Device statistics
  */
@@ -93,6 +108,8 @@ class Profiler {
   /*! \brief add one operation execution record in
    *   corresponding device statistics */
   OprExecStat* AddOprStat(int dev_type, uint32_t dev_id);
+  /*! \brief record a sample of the counter name, if the profiler is running */
+  void AddCounter(const char *name, int64_t value);
   /*! \return Profiler singleton */
   static Profiler* Get();
 
@@ -107,6 +124,8 @@ class Profiler {
   void EmitEvent(std::ostream *os, const std::string& name,
           const std::string& category, const std::string& ph,
           uint64_t ts, uint32_t pid, uint32_t tid);
+  /*! \brief generate counter information following chrome profile file format */
+  void EmitCounter(std::ostream *os, const CounterStat& stat, uint32_t pid);
   /*! \brief Profiler instance */
   static Profiler* instance_;
   /*! \brief internal mutex of the profiler */
@@ -121,6 +140,10 @@ class Profiler {
   std::string filename_;
   /*! \brief profile statistics consist of multiple device statistics */
   DevStat* profile_stat;
+  /*! \brief counter samples, they are shown as one more process */
+  std::vector<CounterStat> counter_stats_;
+  /*! \brief internal mutex of the counter samples */
+  std::mutex counter_m_;
   /*! \brief cpu number on the machine */
   unsigned int cpu_num_;
   /*! \brief gpu number on the machine */
@@ -256,6 +256,8 @@ void ThreadedEngine::DeleteOperator(OprHandle op) {
 }
 
 void ThreadedEngine::Push(OprHandle op, Context exec_ctx, int priority, bool profiling) {
+  // cached operators, e.g. of the executors, come after the grouped writes
+  BulkFlush();
   ThreadedOpr* threaded_opr = ThreadedOpr::CastFromBase(op);
   OprBlock* opr_block = OprBlock::New();
   opr_block->opr = threaded_opr;
@@ -286,6 +288,7 @@ void ThreadedEngine::PushAsync(AsyncFn fn, Context exec_ctx,
                                FnProperty prop,
                                int priority,
                                const char* opr_name) {
+  BulkFlush();
   ThreadedOpr *opr = NewOperator(std::move(fn), const_vars, mutable_vars, prop, opr_name);
   opr->temporary = true;
 #if MXNET_USE_PROFILER
@@ -298,20 +301,81 @@ void ThreadedEngine::PushAsync(AsyncFn fn, Context exec_ctx,
   Push(opr, exec_ctx, priority, profiling);
 }
 
+void ThreadedEngine::PushSync(SyncFn exec_fn, Context exec_ctx,
+                              std::vector<VarHandle> const& const_vars,
+                              std::vector<VarHandle> const& mutable_vars,
+                              FnProperty prop,
+                              int priority,
+                              const char* opr_name) {
+  const BulkStatus& bulk_status = *BulkStatusStore::Get();
+  if (!bulk_status.bulk_size || prop != FnProperty::kNormal || priority ||
+      exec_ctx.dev_mask() != cpu::kDevMask) {
+    Engine::PushSync(exec_fn, exec_ctx, const_vars, mutable_vars,
+                     prop, priority, opr_name);
+    return;
+  }
+  if (bulk_status.count && exec_ctx != bulk_status.ctx) BulkFlush();
+  BulkAppend(exec_fn, exec_ctx, const_vars, mutable_vars);
+}
+
+void ThreadedEngine::BulkAppend(SyncFn exec_fn, Context exec_ctx,
+                                std::vector<VarHandle> const& const_vars,
+                                std::vector<VarHandle> const& mutable_vars) {
+  BulkStatus& bulk_status = *BulkStatusStore::Get();
+  if (!bulk_status.functions) {
+    bulk_status.functions.reset(new std::vector<SyncFn>());
+  }
+  bulk_status.functions->push_back(exec_fn);
+  if (!bulk_status.count) {
+    bulk_status.ctx = exec_ctx;
+  }
+  ++bulk_status.count;
+  bulk_status.const_vars.insert(bulk_status.const_vars.end(),
+                                const_vars.begin(), const_vars.end());
+  bulk_status.mutable_vars.insert(bulk_status.mutable_vars.end(),
+                                  mutable_vars.begin(), mutable_vars.end());
+  if (bulk_status.count >= bulk_status.bulk_size) BulkFlush();
+}
+
+void ThreadedEngine::BulkFlush() {
+  BulkStatus& bulk_status = *BulkStatusStore::Get();
+  if (!bulk_status.count) return;
+  bulk_status.count = 0;
+  DeduplicateVarHandle(&bulk_status.const_vars, &bulk_status.mutable_vars);
+  std::shared_ptr<std::vector<SyncFn> > functions = std::move(bulk_status.functions);
+  this->PushAsync([functions](RunContext ctx, CallbackOnComplete on_complete) {
+      for (auto& fn : *functions) {
+        fn(ctx);
+      }
+      on_complete();
+    }, bulk_status.ctx, bulk_status.const_vars, bulk_status.mutable_vars,
+    FnProperty::kNormal, 0, PROFILER_MESSAGE("ImperativeBulk"));
+  bulk_status.const_vars.clear();
+  bulk_status.mutable_vars.clear();
+}
+
 void ThreadedEngine::DeleteVariable(SyncFn delete_fn,
                                     Context exec_ctx,
                                     VarHandle var) {
   ThreadedVar* threaded_var = ThreadedVar::CastFromBase(var);
-  this->PushSync([delete_fn, threaded_var](RunContext ctx) {
+  SyncFn fn = [delete_fn, threaded_var](RunContext ctx) {
       // Mark variable as orphan,
       // so during `ThreadedEngine::OnComplete` it could be recycled.
       threaded_var->SetToDelete();
       delete_fn(ctx);
-    }, exec_ctx, {}, {var}, FnProperty::kAsync, 0,
-    PROFILER_MESSAGE("DeleteVariable"));
+    };
+  const BulkStatus& bulk_status = *BulkStatusStore::Get();
+  if (bulk_status.count && exec_ctx == bulk_status.ctx) {
+    // delete after the pending group instead of pushing it early
+    BulkAppend(fn, exec_ctx, {}, {var});
+  } else {
+    this->PushSync(fn, exec_ctx, {}, {var}, FnProperty::kAsync, 0,
+                   PROFILER_MESSAGE("DeleteVariable"));
+  }
 }
 
 void ThreadedEngine::WaitForVar(VarHandle var) {
+  BulkFlush();
   ThreadedVar* threaded_var = ThreadedVar::CastFromBase(var);
   if (threaded_var->ready_to_read()) return;
   if (engine_info_) {
@@ -319,7 +383,7 @@ void ThreadedEngine::WaitForVar(VarHandle var) {
     debug_wait_var_ = threaded_var;
   }
   std::atomic<bool> done{false};
-  this->PushSync([this, &done](RunContext) {
+  this->PushAsync([this, &done](RunContext, CallbackOnComplete on_complete) {
       if (engine_info_) {
         LOG(INFO) << "Sync is executed";
       }
@@ -331,6 +395,7 @@ void ThreadedEngine::WaitForVar(VarHandle var) {
       if (engine_info_) {
         LOG(INFO) << "Sync is notified";
       }
+      on_complete();
     }, Context::CPU(), {var}, {}, FnProperty::kNormal, 0,
     PROFILER_MESSAGE("WaitForVar"));
   {
@@ -342,6 +407,7 @@ void ThreadedEngine::WaitForVar(VarHandle var) {
 }
 
 void ThreadedEngine::WaitForAll() {
+  BulkFlush();
   std::unique_lock<std::mutex> lock{finished_m_};
   finished_cv_.wait(lock, [this]() {
       return pending_.load() == 0 || kill_.load();
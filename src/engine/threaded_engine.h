@@ -10,13 +10,16 @@
 
 #include <dmlc/base.h>
 #include <dmlc/logging.h>
+#include <dmlc/thread_local.h>
 #include <vector>
 #include <functional>
+#include <memory>
 #include <condition_variable>
 #include <atomic>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <utility>
 #include "./engine_impl.h"
 #include "./profiler.h"
 #include "../common/object_pool.h"
@@ -252,12 +255,27 @@ class ThreadedEngine : public Engine {
                  FnProperty prop = FnProperty::kNormal,
                  int priority = 0,
                  const char* opr_name = nullptr) override;
+  void PushSync(SyncFn exec_fn, Context exec_ctx,
+                std::vector<VarHandle> const& const_vars,
+                std::vector<VarHandle> const& mutable_vars,
+                FnProperty prop = FnProperty::kNormal,
+                int priority = 0,
+                const char* opr_name = nullptr) override;
   void DeleteVariable(SyncFn delete_fn, Context exec_ctx, VarHandle var) override;
   void WaitForVar(VarHandle var) override;
   void WaitForAll() override;
   void NotifyShutdown() override {
     shutdown_phase_.store(true);
   }
+  int set_bulk_size(int bulk_size) override {
+    BulkStatus& bulk_status = *BulkStatusStore::Get();
+    std::swap(bulk_status.bulk_size, bulk_size);
+    if (bulk_status.count >= bulk_status.bulk_size) BulkFlush();
+    return bulk_size;
+  }
+  int bulk_size() const override {
+    return BulkStatusStore::Get()->bulk_size;
+  }
 
   ThreadedEngine() {
     engine_info_ = dmlc::GetEnv("MXNET_ENGINE_INFO", false);
@@ -343,6 +361,27 @@ class ThreadedEngine : public Engine {
   }
 
  private:
+  /*! \brief synchronous operations of a thread waiting to be pushed as one */
+  struct BulkStatus {
+    /*! \brief maximum number of operations, 0 when grouping is off */
+    int bulk_size = 0;
+    /*! \brief number of operations */
+    int count = 0;
+    /*! \brief context of the operations */
+    Context ctx;
+    /*! \brief the operations in push order */
+    std::shared_ptr<std::vector<SyncFn> > functions;
+    /*! \brief union of the variables of the operations */
+    std::vector<VarHandle> const_vars, mutable_vars;
+  };
+  /*! \brief the pending group of each thread */
+  typedef dmlc::ThreadLocalStore<BulkStatus> BulkStatusStore;
+  /*! \brief add an operation to the pending group of the calling thread */
+  void BulkAppend(SyncFn exec_fn, Context exec_ctx,
+                  std::vector<VarHandle> const& const_vars,
+                  std::vector<VarHandle> const& mutable_vars);
+  /*! \brief push the pending group of the calling thread as one operation */
+  void BulkFlush();
   /*!
    * \brief check if thee is duplication in const_vars and mutable_vars.
    * \param const_vars the variables to read from.
@@ -6,6 +6,8 @@
  */
 #include <mxnet/resource.h>
 #include <mxnet/op_attr_types.h>
+#include <map>
+#include <vector>
 #include "./exec_pass.h"
 
 namespace mxnet {
@@ -18,7 +20,18 @@ Graph AttachOpResources(Graph g) {
   const auto& vctx = g.GetAttr<ContextVector>("context");
   const auto& idx = g.indexed_graph();
   // Use global resource pool for each executor for now.
-  std::map<Context, Resource> cached_temp;
+  // The temp space is kept across passes, and shared with the executors
+  // given it beforehand, since their operators do not run concurrently.
+  if (g.attrs.count("temp_space") == 0) {
+    g.attrs["temp_space"] = std::make_shared<nnvm::any>(std::map<Context, Resource>());
+  }
+  auto& cached_temp = nnvm::get<std::map<Context, Resource> >(*g.attrs.at("temp_space"));
+  // the temp space requested by each node
+  if (g.attrs.count("temp_space_stats") == 0) {
+    g.attrs["temp_space_stats"] =
+        std::make_shared<nnvm::any>(std::vector<TempSpaceStat>(idx.num_nodes()));
+  }
+  auto& temp_stats = nnvm::get<std::vector<TempSpaceStat> >(*g.attrs.at("temp_space_stats"));
   // Resource allocation
   for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
     const auto& inode = idx[nid];
@@ -31,14 +44,14 @@ Graph AttachOpResources(Graph g) {
     for (const ResourceRequest& req : reqs) {
       const Context &ctx = vctx[nid];
       if (req.type == ResourceRequest::kTempSpace) {
-        if (cached_temp.count(ctx) != 0) {
-          requested.push_back(cached_temp.at(ctx));
-        } else {
-          Resource r = ResourceManager::Get()->Request(ctx, req);
-          requested.push_back(r);
-          cached_temp[ctx] = r;
+        if (cached_temp.count(ctx) == 0) {
+          cached_temp[ctx] = ResourceManager::Get()->Request(ctx, req);
         }
-      } else if (req.type == ResourceRequest::kRandom) {
+        Resource r = cached_temp.at(ctx);
+        r.stat = &temp_stats[nid];
+        requested.push_back(r);
+      } else if (req.type == ResourceRequest::kRandom ||
+                 req.type == ResourceRequest::kParallelRandom) {
         requested.push_back(ResourceManager::Get()->Request(ctx, req));
       } else {
         LOG(FATAL) << "resource type not yet supported";
@@ -77,9 +77,14 @@ Graph AttachOpExecs(Graph g);
  * \brief Attach Resource to the OpExecVector of the graph.
  *
  * \param g input graph need to contain op_exec attribute.
+ *  The temp space resources of an optional "temp_space" attribute,
+ *  of type std::map<Context, Resource>, are used before new ones are requested.
  *
  * \return graph with new attribute "op_exec" of type OpExecVector
  *  The fields on the OpExecVector are not yet been setup.
+ *  The temp space resources are in attribute "temp_space", and the temp space
+ *  requested by each node is recorded in attribute "temp_space_stats", of
+ *  type std::vector<TempSpaceStat>.
  */
 Graph AttachOpResources(Graph g);
 
@@ -101,6 +106,21 @@ Graph AttachOpResources(Graph g);
  */
 Graph DetectInplaceAddTo(Graph g);
 
+/*!
+ * \brief Fuse chains of elementwise operators into _FusedElemwise nodes.
+ *
+ * A node is absorbed into its consumer when both are fusable elementwise ops
+ * and its output is read by nothing else, so the intermediate entry drops out
+ * of the memory plan and the whole chain runs in one pass over memory.
+ * The nodes are copied, the input nodes of the graph are kept as they are.
+ *
+ * Must run before shape/type inference and memory planning, on CPU graphs only.
+ *
+ * \param g input graph.
+ * \return the fused graph, or g itself if nothing can be fused.
+ */
+Graph FuseElemwise(Graph g);
+
 }  // namespace exec
 }  // namespace mxnet
 
@@ -0,0 +1,187 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file fuse_elemwise_pass.cc
+ * \brief Fuse chains of elementwise operators into a single _FusedElemwise node.
+ */
+#include <mxnet/base.h>
+#include <mxnet/operator.h>
+#include <nnvm/graph_attr_types.h>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "./exec_pass.h"
+#include "../operator/tensor/elemwise_fused_op.h"
+
+namespace mxnet {
+namespace exec {
+
+Graph FuseElemwise(Graph g) {
+  using nnvm::NodePtr;
+  using nnvm::NodeEntry;
+  using op::FusedElemwiseInstr;
+  using op::FusedElemwiseParam;
+  static const Op* fused_op = Op::Get("_FusedElemwise");
+  const auto& idx = g.indexed_graph();
+  const uint32_t num_nodes = idx.num_nodes();
+
+  std::vector<int> ref_count(idx.num_node_entries(), 0);
+  for (auto& e : idx.outputs()) {
+    ++ref_count[idx.entry_id(e)];
+  }
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    for (auto& e : idx[nid].inputs) {
+      ++ref_count[idx.entry_id(e)];
+    }
+  }
+
+  // the backward of a layer op reaches the operator of its forward node through
+  // its first control dependency, so that forward node must stay as it is.
+  static auto& is_layer_backward = nnvm::Op::GetAttr<bool>("TIsLayerOpBackward");
+  std::vector<int> layer_forward(num_nodes, 0);
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    const nnvm::Node* node = idx[nid].source;
+    if (!node->is_variable() && is_layer_backward.get(node->op(), false) &&
+        idx[nid].control_deps.size() != 0) {
+      layer_forward[idx[nid].control_deps[0]] = 1;
+    }
+  }
+
+  std::vector<int> opcode(num_nodes, -1);
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    const nnvm::Node* node = idx[nid].source;
+    if (node->is_variable() || node->num_outputs() != 1 || layer_forward[nid]) continue;
+    opcode[nid] = op::FusedElemwiseOpCode(node->attrs);
+  }
+
+  // grow fusion groups in topological order: a node absorbs the producer of
+  // its input when that producer is fusable and the entry has no other reader.
+  std::vector<int> group_size(num_nodes, 1);
+  std::vector<int> absorbed(num_nodes, 0);
+  std::vector<uint32_t> absorber(num_nodes);
+  bool changed = false;
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    if (opcode[nid] < 0) continue;
+    for (const auto& e : idx[nid].inputs) {
+      uint32_t pid = e.node_id;
+      if (opcode[pid] < 0 || absorbed[pid]) continue;
+      if (ref_count[idx.entry_id(e)] != 1) continue;
+      if (group_size[nid] + group_size[pid] > op::fused::kMaxInstructions) continue;
+      absorbed[pid] = 1;
+      absorber[pid] = nid;
+      group_size[nid] += group_size[pid];
+      changed = true;
+    }
+  }
+  if (!changed) return g;
+  // the fused node that computes each node. Control dependencies on an absorbed
+  // node, such as the ones of the gradient nodes on their forward node, move to
+  // that fused node. Gradient nodes never feed forward nodes, so no cycle forms.
+  std::vector<uint32_t> root(num_nodes);
+  for (uint32_t nid = num_nodes; nid-- > 0;) {
+    root[nid] = absorbed[nid] ? root[absorber[nid]] : nid;
+  }
+
+  // rebuild the graph, copying the nodes so that the bound symbol is untouched.
+  std::vector<NodePtr> old_nodes;
+  nnvm::DFSVisit(g.outputs, [&old_nodes](const NodePtr& n) {
+      old_nodes.push_back(n);
+    });
+  CHECK_EQ(old_nodes.size(), num_nodes);
+  // control dependencies do not follow the topological order of the data,
+  // so all the nodes are created before they are connected.
+  std::vector<NodePtr> new_nodes(num_nodes);
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    CHECK_EQ(idx[nid].source, old_nodes[nid].get());
+    if (idx[nid].source->is_variable()) {
+      new_nodes[nid] = old_nodes[nid];
+    } else if (!absorbed[nid]) {
+      new_nodes[nid] = nnvm::Node::Create();
+    }
+  }
+  auto new_entry = [&](const nnvm::IndexedGraph::NodeEntry& e) {
+    return NodeEntry{new_nodes[e.node_id], e.index, e.version};
+  };
+
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    const nnvm::Node* src = idx[nid].source;
+    if (src->is_variable() || absorbed[nid]) continue;
+    const NodePtr& n = new_nodes[nid];
+    std::unordered_set<uint32_t> deps;
+    auto add_deps = [&](uint32_t cur) {
+      for (uint32_t dep : idx[cur].control_deps) {
+        if (root[dep] != nid && deps.insert(root[dep]).second) {
+          n->control_deps.emplace_back(new_nodes[root[dep]]);
+        }
+      }
+    };
+    if (group_size[nid] == 1) {
+      n->attrs = src->attrs;
+      for (const auto& e : idx[nid].inputs) {
+        n->inputs.emplace_back(new_entry(e));
+      }
+      add_deps(nid);
+      continue;
+    }
+    // emit the program in post order; instruction results are encoded as
+    // -(k + 1) until the number of external inputs is known.
+    FusedElemwiseParam param;
+    std::unordered_map<uint32_t, int> input_slot;
+    std::function<int(uint32_t)> emit = [&](uint32_t cur) -> int {
+      add_deps(cur);
+      std::vector<int> operands;
+      for (const auto& e : idx[cur].inputs) {
+        if (absorbed[e.node_id]) {
+          operands.push_back(emit(e.node_id));
+          continue;
+        }
+        uint32_t eid = idx.entry_id(e);
+        auto it = input_slot.find(eid);
+        if (it == input_slot.end()) {
+          it = input_slot.emplace(eid, static_cast<int>(n->inputs.size())).first;
+          n->inputs.emplace_back(new_entry(e));
+        }
+        operands.push_back(it->second);
+      }
+      FusedElemwiseInstr ins;
+      ins.opcode = opcode[cur];
+      ins.lhs = operands[0];
+      ins.rhs = operands.size() > 1 ? operands[1] : 0;
+      ins.scalar = 0.0;
+      if (ins.opcode >= op::fused::kPlusScalar) {
+        ins.scalar = nnvm::get<double>(idx[cur].source->attrs.parsed);
+      }
+      param.program.push_back(ins);
+      return -static_cast<int>(param.program.size());
+    };
+    emit(nid);
+    param.num_inputs = static_cast<int>(n->inputs.size());
+    for (auto& ins : param.program) {
+      if (ins.lhs < 0) ins.lhs = param.num_inputs - ins.lhs - 1;
+      if (ins.rhs < 0) ins.rhs = param.num_inputs - ins.rhs - 1;
+    }
+    n->attrs.op = fused_op;
+    n->attrs.name = src->attrs.name;
+    n->attrs.dict["num_inputs"] = std::to_string(param.num_inputs);
+    n->attrs.dict["num_ops"] = std::to_string(param.program.size());
+    n->attrs.parsed = std::move(param);
+  }
+
+  Graph ret;
+  for (const auto& e : idx.outputs()) {
+    ret.outputs.emplace_back(new_entry(e));
+  }
+  // the executor binds arguments by the order of input nodes, which must be kept.
+  const auto& new_idx = ret.indexed_graph();
+  if (new_idx.input_nodes().size() != idx.input_nodes().size()) return g;
+  for (size_t i = 0; i < idx.input_nodes().size(); ++i) {
+    if (new_idx[new_idx.input_nodes()[i]].source != idx[idx.input_nodes()[i]].source) {
+      LOG(INFO) << "FuseElemwise changed the order of graph inputs, fusion skipped";
+      return g;
+    }
+  }
+  return ret;
+}
+
+}  // namespace exec
+}  // namespace mxnet
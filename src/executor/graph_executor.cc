@@ -63,7 +63,20 @@ void GraphExecutor::Print(std::ostream &os) const {  // NOLINT(*)
   // message to be backward compatible with the memonger
   size_t total_bytes = graph_.GetAttr<size_t>("storage_allocated_bytes");
   os << "Total " << (total_bytes >> 20UL) <<" MB allocated\n";
-  os << "Total " << 11 << " TempSpace resource requested\n";
+  const auto& temp_space = graph_.GetAttr<std::map<Context, Resource> >("temp_space");
+  os << "Total " << temp_space.size() << " TempSpace resource requested\n";
+  // high-water marks of the temp space of the operators run so far
+  const auto& idx = graph_.indexed_graph();
+  const auto& temp_stats = graph_.GetAttr<std::vector<TempSpaceStat> >("temp_space_stats");
+  size_t peak = 0;
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    const TempSpaceStat& stat = temp_stats[nid];
+    if (stat.num_requests == 0) continue;
+    os << "TempSpace " << idx[nid].source->attrs.name << ": " << (stat.high_water >> 10UL)
+       << " KB high-water, " << stat.num_requests << " requests\n";
+    peak = std::max(peak, stat.high_water);
+  }
+  os << "Total " << (peak >> 20UL) << " MB TempSpace high-water\n";
 }
 
 void GraphExecutor::SetMonitorCallback(const MonitorCallback& callback) {
@@ -344,6 +357,12 @@ void GraphExecutor::Init(nnvm::Symbol symbol,
                             grad_req_type, aux_states, feed_dict);
   g.attrs["saved_opr"] = std::make_shared<nnvm::any>(std::move(saved_opr_));
   g = AttachOpExecs(g);
+  if (shared_exec != nullptr) {
+    // share the temp space of the shared executor
+    const auto& shared_temp = dynamic_cast<GraphExecutor*>(shared_exec)->graph_
+        .GetAttr<std::map<Context, Resource> >("temp_space");
+    g.attrs["temp_space"] = std::make_shared<nnvm::any>(shared_temp);
+  }
   g = AttachOpResources(g);
   graph_ = std::move(g);
   if (shared_exec != nullptr) {
@@ -370,6 +389,84 @@ void GraphExecutor::Init(nnvm::Symbol symbol,
   this->InitOpSegs();
 }
 
+void GraphExecutor::Rebind(const std::vector<NDArray>& in_args,
+                           const std::vector<NDArray>& arg_grad_store,
+                           const std::vector<OpReqType>& grad_req_type,
+                           const nnvm::NodeEntryMap<NDArray>& feed_dict,
+                           const NodeOperatorMap& saved_opr) {
+  const auto& idx = graph_.indexed_graph();
+  CHECK_EQ(in_args.size(), num_forward_inputs_);
+  for (size_t i = 0; i < num_forward_inputs_; ++i) {
+    const uint32_t nid = idx.input_nodes().at(i);
+    data_entry_[idx.entry_id(nid, 0)] = in_args[i];
+  }
+  size_t k = 0;
+  for (size_t i = 0; i < grad_req_type.size(); ++i) {
+    if (grad_req_type[i] == kNullOp) continue;
+    CHECK_LT(k, grad_store_.size());
+    CHECK_EQ(grad_store_[k].first, grad_req_type[i]);
+    grad_store_[k].second = arg_grad_store[i];
+    data_entry_[idx.entry_id(idx.outputs()[num_forward_outputs_ + k])] = arg_grad_store[i];
+    ++k;
+  }
+  CHECK_EQ(k, grad_store_.size());
+  for (const auto& kv : feed_dict) {
+    data_entry_[idx.entry_id(kv.first)] = kv.second;
+  }
+  for (size_t i = 0; i < num_forward_outputs_; ++i) {
+    output_arrays_[i] = data_entry_[idx.entry_id(idx.outputs()[i])];
+  }
+  // the op executors hold the arrays and operators, create them again
+  for (auto& n : op_nodes_) {
+    if (n.cached_opr != nullptr) {
+      Engine::Get()->DeleteOperator(n.cached_opr);
+    }
+  }
+  for (auto& seg : cached_seg_opr_) {
+    if (seg.opr != nullptr) {
+      Engine::Get()->DeleteOperator(seg.opr);
+    }
+  }
+  op_nodes_.clear();
+  graph_.attrs["saved_opr"] = std::make_shared<nnvm::any>(saved_opr);
+  graph_ = AttachOpExecs(graph_);
+  graph_ = AttachOpResources(graph_);
+  this->InitCachedOps();
+  this->InitOpSegs();
+}
+
+void GraphExecutor::ReleaseBound(const nnvm::NodeEntryMap<NDArray>& feed_dict) {
+  const auto& idx = graph_.indexed_graph();
+  // the pushed operations keep their arrays alive until they complete
+  for (auto& n : op_nodes_) {
+    if (n.cached_opr != nullptr) {
+      Engine::Get()->DeleteOperator(n.cached_opr);
+    }
+  }
+  for (auto& seg : cached_seg_opr_) {
+    if (seg.opr != nullptr) {
+      Engine::Get()->DeleteOperator(seg.opr);
+      seg.opr = nullptr;
+    }
+  }
+  op_nodes_.clear();
+  graph_.attrs.erase("op_execs");
+  saved_opr_.clear();
+  graph_.attrs["saved_opr"] = std::make_shared<nnvm::any>(NodeOperatorMap());
+  for (size_t i = 0; i < num_forward_inputs_; ++i) {
+    const uint32_t nid = idx.input_nodes().at(i);
+    data_entry_[idx.entry_id(nid, 0)] = NDArray();
+  }
+  for (size_t k = 0; k < grad_store_.size(); ++k) {
+    grad_store_[k].second = NDArray();
+    data_entry_[idx.entry_id(idx.outputs()[num_forward_outputs_ + k])] = NDArray();
+  }
+  for (const auto& kv : feed_dict) {
+    data_entry_[idx.entry_id(kv.first)] = NDArray();
+  }
+  for (auto& arr : output_arrays_) arr = NDArray();
+}
+
 Graph GraphExecutor::InitGraph(nnvm::Symbol symbol,
                                const Context& default_ctx,
                                const std::map<std::string, Context>& ctx_map,
@@ -380,6 +477,12 @@ Graph GraphExecutor::InitGraph(nnvm::Symbol symbol,
                                const nnvm::NodeEntryMap<NDArray>& feed_dict) {
   // setup gradient
   nnvm::Graph g = InitFullGraph(symbol, grad_req_type, arg_grad_store);
+  // fuse elementwise chains, only generated for single context CPU graphs
+  static bool fuse_elemwise = dmlc::GetEnv("MXNET_EXEC_FUSE_ELEMWISE", true);
+  if (fuse_elemwise && ctx_map.size() == 0 && feed_dict.size() == 0 &&
+      default_ctx.dev_mask() == cpu::kDevMask) {
+    g = FuseElemwise(g);
+  }
   g = AssignContext(g, default_ctx, ctx_map,
                     in_args,
                     grad_store_,
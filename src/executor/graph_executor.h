@@ -62,6 +62,23 @@ class GraphExecutor : public Executor {
             Executor* shared_exec = nullptr,
             const nnvm::NodeEntryMap<NDArray>& feed_dict
               = nnvm::NodeEntryMap<NDArray>());
+  /*!
+   * \brief bind new arrays and saved operators to an initialized executor.
+   *  The graph, its shapes, memory plan and allocated memory are kept, so the
+   *  arrays must have the shapes, types and contexts given to Init.
+   * \param feed_dict keyed by the entries of the symbol given to Init
+   */
+  void Rebind(const std::vector<NDArray>& in_args,
+              const std::vector<NDArray>& arg_grad_store,
+              const std::vector<OpReqType>& grad_req_type,
+              const nnvm::NodeEntryMap<NDArray>& feed_dict,
+              const NodeOperatorMap& saved_opr);
+  /*!
+   * \brief drop the arrays and operators bound by Init or Rebind, keeping the
+   *  graph and its allocated memory. Rebind must be called before the next run.
+   * \param feed_dict the entries fed to the last Init or Rebind
+   */
+  void ReleaseBound(const nnvm::NodeEntryMap<NDArray>& feed_dict);
 
  protected:
   // Information about operational node
@@ -0,0 +1,228 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file columnar_format.h
+ * \brief chunked columnar binary format for tabular data, read by ColumnarIter
+ *  and written by tools/tab2col.cc
+ *
+ *  File layout, all integers little endian:
+ *    magic[64bit]
+ *    blocks, each starting at a multiple of 8 bytes
+ *    footer
+ *    footer offset[64bit] magic[64bit]
+ *  A chunk is a range of rows. A block holds the values of one column in one
+ *  chunk as a typed array, stored as is or compressed. The footer lists the
+ *  types of the columns and where the blocks of every chunk are.
+ */
+#ifndef MXNET_IO_COLUMNAR_FORMAT_H_
+#define MXNET_IO_COLUMNAR_FORMAT_H_
+
+#include <dmlc/io.h>
+#include <dmlc/logging.h>
+#include <mshadow/base.h>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace mxnet {
+namespace io {
+namespace columnar {
+/*! \brief "MXCOL001" */
+const uint64_t kMagic = 0x3130304c4f43584dULL;
+/*! \brief how a block is stored */
+enum Codec {
+  /*! \brief the array as is */
+  kRaw = 0,
+  /*! \brief bytes grouped by their position in the value, then run length encoded */
+  kShuffleRLE = 1
+};
+/*! \brief alignment of the blocks */
+const size_t kAlign = 8;
+
+/*! \brief index of the file */
+struct Footer {
+  /*! \brief the first num_label columns are labels, the others are data */
+  uint32_t num_label;
+  /*! \brief mshadow type flag of every column */
+  std::vector<int32_t> dtypes;
+  /*! \brief number of rows of every chunk */
+  std::vector<uint64_t> chunk_rows;
+  /*! \brief offset, stored size and codec of block (chunk, column),
+   *  at chunk * number of columns + column */
+  std::vector<uint64_t> offsets;
+  std::vector<uint64_t> sizes;
+  std::vector<uint32_t> codecs;
+
+  inline size_t num_column() const {
+    return dtypes.size();
+  }
+  inline void Save(dmlc::Stream *fo) const {
+    fo->Write(&num_label, sizeof(num_label));
+    fo->Write(dtypes);
+    fo->Write(chunk_rows);
+    fo->Write(offsets);
+    fo->Write(sizes);
+    fo->Write(codecs);
+  }
+  inline void Load(dmlc::Stream *fi) {
+    CHECK(fi->Read(&num_label, sizeof(num_label)) == sizeof(num_label) &&
+          fi->Read(&dtypes) && fi->Read(&chunk_rows) && fi->Read(&offsets) &&
+          fi->Read(&sizes) && fi->Read(&codecs)) << "invalid columnar file footer";
+    const size_t nblock = chunk_rows.size() * dtypes.size();
+    CHECK(num_label <= dtypes.size() && offsets.size() == nblock &&
+          sizes.size() == nblock && codecs.size() == nblock) << "invalid columnar file footer";
+  }
+};
+
+/*!
+ * \brief compress n values of elem_size bytes with kShuffleRLE. Byte j of every
+ *  value is gathered into plane j, which turns the high bytes of small numbers
+ *  and the bytes of repeated values into long runs. The planes are then coded as
+ *  control bytes c: c < 128 is followed by c + 1 literal bytes, c >= 128 by one
+ *  byte repeated c - 126 times.
+ */
+inline void ShuffleRLEEncode(const char *src, size_t n, size_t elem_size, std::string *out) {
+  const size_t nbytes = n * elem_size;
+  std::string planes(nbytes, '\0');
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < elem_size; ++j) {
+      planes[j * n + i] = src[i * elem_size + j];
+    }
+  }
+  out->clear();
+  size_t i = 0;
+  while (i < nbytes) {
+    size_t run = 1;
+    while (i + run < nbytes && run < 129 && planes[i + run] == planes[i]) ++run;
+    if (run >= 2) {
+      out->push_back(static_cast<char>(run + 126));
+      out->push_back(planes[i]);
+      i += run;
+      continue;
+    }
+    // literals up to the next run of at least 3 bytes
+    size_t len = 1;
+    while (i + len < nbytes && len < 128 &&
+           !(i + len + 2 < nbytes && planes[i + len] == planes[i + len + 1] &&
+             planes[i + len] == planes[i + len + 2])) {
+      ++len;
+    }
+    out->push_back(static_cast<char>(len - 1));
+    out->append(planes, i, len);
+    i += len;
+  }
+}
+
+/*!
+ * \brief decompress a block of n values of elem_size bytes coded by ShuffleRLEEncode
+ * \param buf scratch space of n * elem_size bytes
+ */
+inline void ShuffleRLEDecode(const char *src, size_t size, size_t n, size_t elem_size,
+                             char *buf, char *dst) {
+  const size_t nbytes = n * elem_size;
+  const unsigned char *p = reinterpret_cast<const unsigned char*>(src);
+  const unsigned char *end = p + size;
+  size_t pos = 0;
+  while (p != end) {
+    const unsigned c = *p++;
+    if (c < 128) {
+      CHECK(end - p >= static_cast<ptrdiff_t>(c + 1) && pos + c + 1 <= nbytes)
+          << "corrupted columnar block";
+      std::memcpy(buf + pos, p, c + 1);
+      p += c + 1;
+      pos += c + 1;
+    } else {
+      CHECK(p != end && pos + c - 126 <= nbytes) << "corrupted columnar block";
+      std::memset(buf + pos, *p++, c - 126);
+      pos += c - 126;
+    }
+  }
+  CHECK_EQ(pos, nbytes) << "corrupted columnar block";
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < elem_size; ++j) {
+      dst[i * elem_size + j] = buf[j * n + i];
+    }
+  }
+}
+
+/*!
+ * \brief writes a columnar file chunk by chunk
+ *
+ *  \code
+ *  Writer writer(fo, dtypes, num_label, true);
+ *  writer.WriteChunk(columns, num_rows);
+ *  writer.Close();
+ *  \endcode
+ */
+class Writer {
+ public:
+  /*!
+   * \param fo output stream, which must stay open until Close
+   * \param dtypes mshadow type flag of every column
+   * \param num_label the first num_label columns are labels
+   * \param compress whether to compress blocks, a block is stored as is when
+   *  compression does not make it smaller
+   */
+  Writer(dmlc::Stream *fo, const std::vector<int> &dtypes, unsigned num_label, bool compress)
+      : fo_(fo), compress_(compress), pos_(0) {
+    CHECK_LE(num_label, dtypes.size());
+    footer_.num_label = num_label;
+    footer_.dtypes.assign(dtypes.begin(), dtypes.end());
+    this->Write(&kMagic, sizeof(kMagic));
+  }
+  /*!
+   * \brief append a chunk
+   * \param columns values of each column, as arrays of the type of the column
+   * \param num_rows number of rows of the chunk
+   */
+  inline void WriteChunk(const std::vector<const void*> &columns, size_t num_rows) {
+    CHECK_EQ(columns.size(), footer_.num_column());
+    footer_.chunk_rows.push_back(num_rows);
+    std::string packed;
+    for (size_t c = 0; c < columns.size(); ++c) {
+      const size_t elem_size = mshadow::mshadow_sizeof(footer_.dtypes[c]);
+      const char *dptr = static_cast<const char*>(columns[c]);
+      size_t size = num_rows * elem_size;
+      uint32_t codec = kRaw;
+      if (compress_) {
+        ShuffleRLEEncode(dptr, num_rows, elem_size, &packed);
+        if (packed.size() < size) {
+          dptr = packed.data();
+          size = packed.size();
+          codec = kShuffleRLE;
+        }
+      }
+      footer_.offsets.push_back(pos_);
+      footer_.sizes.push_back(size);
+      footer_.codecs.push_back(codec);
+      this->Write(dptr, size);
+      this->Pad();
+    }
+  }
+  /*! \brief write the footer, no chunk can be written afterwards */
+  inline void Close() {
+    const uint64_t footer_offset = pos_;
+    footer_.Save(fo_);
+    fo_->Write(&footer_offset, sizeof(footer_offset));
+    fo_->Write(&kMagic, sizeof(kMagic));
+  }
+
+ private:
+  inline void Write(const void *dptr, size_t size) {
+    fo_->Write(dptr, size);
+    pos_ += size;
+  }
+  inline void Pad() {
+    const char zeros[kAlign] = {0};
+    if (pos_ % kAlign != 0) this->Write(zeros, kAlign - pos_ % kAlign);
+  }
+  dmlc::Stream *fo_;
+  bool compress_;
+  /*! \brief bytes written */
+  uint64_t pos_;
+  Footer footer_;
+};
+}  // namespace columnar
+}  // namespace io
+}  // namespace mxnet
+#endif  // MXNET_IO_COLUMNAR_FORMAT_H_
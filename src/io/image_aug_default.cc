@@ -51,6 +51,8 @@ struct DefaultImageAugmentParam : public dmlc::Parameter<DefaultImageAugmentPara
   int random_s;
   /*! \brief max random in L channel */
   int random_l;
+  /*! \brief whether to jitter the color with a matrix on BGR pixels */
+  bool color_jitter_bgr;
   /*! \brief rotate angle */
   int rotate;
   /*! \brief filled color while padding */
@@ -104,6 +106,10 @@ struct DefaultImageAugmentParam : public dmlc::Parameter<DefaultImageAugmentPara
     DMLC_DECLARE_FIELD(random_l).set_default(0)
         .describe("Add a random value in ``[-random_l, random_l]`` to "
                   "the L channel in HSL color space.");
+    DMLC_DECLARE_FIELD(color_jitter_bgr).set_default(false)
+        .describe("Apply the H, S and L jitter as one color matrix on the BGR pixels "
+                  "instead of converting to HSL and back. Faster, H rotates the hue, "
+                  "S scales the saturation by ``1 + S / 255`` and L is added to each channel.");
     DMLC_DECLARE_FIELD(rotate).set_default(-1.0f)
         .describe("Rotate by an angle. If set, it overrites the ``max_rotate_angle`` option.");
     DMLC_DECLARE_FIELD(fill_value).set_default(255)
@@ -199,6 +205,8 @@ class DefaultImageAugmenter : public ImageAugmenter {
       res = src;
     }
 
+    // whether pad and crop have already been folded into the affine warp
+    bool cropped = false;
     // normal augmentation by affine transformation.
     if (param_.max_rotate_angle > 0 || param_.max_shear_ratio > 0.0f
         || param_.rotate > 0 || rotate_list_.size() > 0 || param_.max_random_scale != 1.0
@@ -243,7 +251,29 @@ class DefaultImageAugmenter : public ImageAugmenter {
          << "invalid inter_method: valid value 0,1,2,3,9,10";
       int interpolation_method = GetInterMethod(param_.inter_method,
                     res.cols, res.rows, new_width, new_height, prnd);
-      cv::warpAffine(res, temp_, M, cv::Size(new_width, new_height),
+      cv::Size dsize(new_width, new_height);
+      if (param_.max_crop_size == -1 && param_.min_crop_size == -1) {
+        // padding and a fixed size crop are a translation of the warped image,
+        // so warp straight into the cropped window instead of filling the
+        // whole image and copying it twice
+        const index_t rows = dsize.height + 2 * param_.pad;
+        const index_t cols = dsize.width + 2 * param_.pad;
+        CHECK(rows >= param_.data_shape[1] && cols >= param_.data_shape[2])
+            << "input image size smaller than input shape";
+        index_t y = rows - param_.data_shape[1];
+        index_t x = cols - param_.data_shape[2];
+        if (param_.rand_crop != 0) {
+          y = std::uniform_int_distribution<index_t>(0, y)(*prnd);
+          x = std::uniform_int_distribution<index_t>(0, x)(*prnd);
+        } else {
+          y /= 2; x /= 2;
+        }
+        M.at<float>(0, 2) += static_cast<float>(param_.pad) - x;
+        M.at<float>(1, 2) += static_cast<float>(param_.pad) - y;
+        dsize = cv::Size(param_.data_shape[2], param_.data_shape[1]);
+        cropped = true;
+      }
+      cv::warpAffine(res, temp_, M, dsize,
                      interpolation_method,
                      cv::BORDER_CONSTANT,
                      cv::Scalar(param_.fill_value, param_.fill_value, param_.fill_value));
@@ -251,7 +281,7 @@ class DefaultImageAugmenter : public ImageAugmenter {
     }
 
     // pad logic
-    if (param_.pad > 0) {
+    if (!cropped && param_.pad > 0) {
       cv::copyMakeBorder(res, res, param_.pad, param_.pad, param_.pad, param_.pad,
                          cv::BORDER_CONSTANT,
                          cv::Scalar(param_.fill_value, param_.fill_value, param_.fill_value));
@@ -277,7 +307,7 @@ class DefaultImageAugmenter : public ImageAugmenter {
                                                 param_.data_shape[2], param_.data_shape[1], prnd);
       cv::resize(res(roi), res, cv::Size(param_.data_shape[2], param_.data_shape[1])
                 , 0, 0, interpolation_method);
-    } else {
+    } else if (!cropped) {
       CHECK(static_cast<index_t>(res.rows) >= param_.data_shape[1]
             && static_cast<index_t>(res.cols) >= param_.data_shape[2])
           << "input image size smaller than input shape";
@@ -296,23 +326,16 @@ class DefaultImageAugmenter : public ImageAugmenter {
     // color space augmentation
     if (param_.random_h != 0 || param_.random_s != 0 || param_.random_l != 0) {
       std::uniform_real_distribution<float> rand_uniform(0, 1);
-      cvtColor(res, res, CV_BGR2HLS);
       int h = rand_uniform(*prnd) * param_.random_h * 2 - param_.random_h;
       int s = rand_uniform(*prnd) * param_.random_s * 2 - param_.random_s;
       int l = rand_uniform(*prnd) * param_.random_l * 2 - param_.random_l;
-      int temp[3] = {h, l, s};
-      int limit[3] = {180, 255, 255};
-      for (int i = 0; i < res.rows; ++i) {
-        for (int j = 0; j < res.cols; ++j) {
-          for (int k = 0; k < 3; ++k) {
-            int v = res.at<cv::Vec3b>(i, j)[k];
-            v += temp[k];
-            v = std::max(0, std::min(limit[k], v));
-            res.at<cv::Vec3b>(i, j)[k] = v;
-          }
-        }
+      cv::Mat jittered;
+      if (param_.color_jitter_bgr) {
+        JitterBGR(res, h, l, s, &jittered);
+      } else {
+        JitterHLS(res, h, l, s, &jittered);
       }
-      cvtColor(res, res, CV_HLS2BGR);
+      res = jittered;
     }
     return res;
   }
@@ -10,6 +10,8 @@
 
 #if MXNET_USE_OPENCV
 #include <opencv2/opencv.hpp>
+#include <algorithm>  // NOLINT(*)
+#include <cmath>  // NOLINT(*)
 #include <vector>  // NOLINT(*)
 #include <utility> // NOLINT(*)
 #include <string> // NOLINT(*)
@@ -50,6 +52,58 @@ class ImageAugmenter {
   static ImageAugmenter* Create(const std::string& name);
 };
 
+/*!
+ * \brief add h, l and s to the channels of the HLS conversion of a BGR image,
+ *  clamped to their range, and convert back. The offsets go through a lookup
+ *  table instead of a loop over the pixels.
+ */
+inline void JitterHLS(const cv::Mat &src, int h, int l, int s, cv::Mat *dst) {
+  const int offset[3] = {h, l, s};
+  const int limit[3] = {180, 255, 255};
+  cv::Mat lut(1, 256, CV_8UC3);
+  for (int v = 0; v < 256; ++v) {
+    for (int k = 0; k < 3; ++k) {
+      lut.at<cv::Vec3b>(0, v)[k] = std::max(0, std::min(limit[k], v + offset[k]));
+    }
+  }
+  cv::Mat hls;
+  cv::cvtColor(src, hls, CV_BGR2HLS);
+  cv::LUT(hls, lut, hls);
+  cv::cvtColor(hls, *dst, CV_HLS2BGR);
+}
+
+/*!
+ * \brief approximate JitterHLS with a single 3x4 colour matrix applied to the
+ *  BGR pixels, without converting to HLS and back: the hue is rotated around
+ *  the gray axis by h, in units of 2 degrees like the 8 bit HLS of OpenCV, the
+ *  saturation is scaled by 1 + s / 255 and l is added to every channel.
+ */
+inline void JitterBGR(const cv::Mat &src, int h, int l, int s, cv::Mat *dst) {
+  const float theta = h * 2.0f * static_cast<float>(M_PI) / 180.0f;
+  const float cos_t = std::cos(theta), sin_t = std::sin(theta) / std::sqrt(3.0f);
+  const float alpha = 1.0f + s / 255.0f;
+  // rotation around (1, 1, 1) in RGB order, red turns to green for h > 0
+  const float skew[3][3] = {{0, -1, 1}, {1, 0, -1}, {-1, 1, 0}};
+  float rot[3][3];
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      rot[i][j] = (i == j ? cos_t : 0.0f) + (1.0f - cos_t) / 3.0f + sin_t * skew[i][j];
+    }
+  }
+  // saturation scales the distance to the gray axis, which commutes with the rotation,
+  // and the channels are reversed to BGR order
+  cv::Matx34f m;
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      float gray = 0.0f;
+      for (int k = 0; k < 3; ++k) gray += rot[k][j];
+      m(2 - i, 2 - j) = alpha * rot[i][j] + (1.0f - alpha) * gray / 3.0f;
+    }
+    m(i, 3) = static_cast<float>(l);
+  }
+  cv::transform(src, *dst, m);
+}
+
 /*! \brief typedef the factory function of data iterator */
 typedef std::function<ImageAugmenter *()> ImageAugmenterFactory;
 /*!
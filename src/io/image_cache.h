@@ -0,0 +1,125 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file image_cache.h
+ * \brief in-memory cache of decoded images, so that later epochs skip decoding
+ */
+#ifndef MXNET_IO_IMAGE_CACHE_H_
+#define MXNET_IO_IMAGE_CACHE_H_
+
+#include <dmlc/logging.h>
+#if MXNET_USE_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace mxnet {
+namespace io {
+#if MXNET_USE_OPENCV
+/*!
+ * \brief a fixed budget cache of decoded uint8 images keyed by record index.
+ *
+ *  Pixels are packed into large blocks that are never freed nor moved, so an
+ *  entry is only a pointer and a header. Images are inserted until the budget
+ *  is used up; the cache has no eviction since every epoch visits all records.
+ *  All functions are thread safe.
+ */
+class ImageCache {
+ public:
+  /*! \param capacity budget of the pixel storage in bytes */
+  explicit ImageCache(size_t capacity)
+      : capacity_(capacity), allocated_(0), block_used_(0), block_size_(0), full_(false) {}
+  /*!
+   * \brief copy the image cached under key to out
+   * \param tag extra value that must match the one given to Put, such as the
+   *  encoded size, to detect different records sharing an index
+   * \return false if the image is not cached
+   */
+  inline bool Get(uint64_t key, size_t tag, cv::Mat *out) {
+    Entry entry;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = index_.find(key);
+      if (it == index_.end() || it->second.tag != tag) return false;
+      entry = it->second;
+    }
+    // the pixels of an entry are written before it is indexed and never change
+    out->create(entry.rows, entry.cols, entry.type);
+    const size_t row_bytes = out->cols * out->elemSize();
+    for (int i = 0; i < entry.rows; ++i) {
+      std::memcpy(out->ptr<uchar>(i), entry.dptr + i * row_bytes, row_bytes);
+    }
+    return true;
+  }
+  /*!
+   * \brief cache a copy of img under key
+   * \return false if the key is already present or the budget is used up
+   */
+  inline bool Put(uint64_t key, size_t tag, const cv::Mat &img) {
+    CHECK_EQ(img.depth(), CV_8U) << "only uint8 images can be cached";
+    const size_t row_bytes = img.cols * img.elemSize();
+    const size_t nbytes = row_bytes * img.rows;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (full_ || index_.count(key) != 0) return false;
+    if (block_used_ + nbytes > block_size_) {
+      const size_t block_size = kBlockSize;
+      const size_t size = std::max(nbytes, std::min(block_size, capacity_ - allocated_));
+      if (allocated_ + size > capacity_) {
+        full_ = true;
+        LOG(INFO) << "Decoded image cache is full with " << index_.size()
+                  << " images, the remaining images are decoded every epoch";
+        return false;
+      }
+      blocks_.emplace_back(new char[size]);
+      allocated_ += size;
+      block_used_ = 0;
+      block_size_ = size;
+    }
+    char *dptr = blocks_.back().get() + block_used_;
+    for (int i = 0; i < img.rows; ++i) {
+      std::memcpy(dptr + i * row_bytes, img.ptr<uchar>(i), row_bytes);
+    }
+    Entry entry;
+    entry.dptr = dptr;
+    entry.rows = img.rows;
+    entry.cols = img.cols;
+    entry.type = img.type();
+    entry.tag = tag;
+    block_used_ += nbytes;
+    index_[key] = entry;
+    return true;
+  }
+  /*! \return number of cached images */
+  inline size_t Size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.size();
+  }
+
+ private:
+  /*! \brief size of the blocks the pixels are packed into */
+  static const size_t kBlockSize = 64UL << 20UL;
+  /*! \brief location and header of a cached image */
+  struct Entry {
+    const char *dptr;
+    int rows, cols, type;
+    size_t tag;
+  };
+  /*! \brief protects all the fields below */
+  std::mutex mutex_;
+  /*! \brief cached images */
+  std::unordered_map<uint64_t, Entry> index_;
+  /*! \brief pixel storage */
+  std::vector<std::unique_ptr<char[]> > blocks_;
+  /*! \brief budget, allocated bytes, and usage of the last block */
+  size_t capacity_, allocated_, block_used_, block_size_;
+  /*! \brief whether an image did not fit in the budget */
+  bool full_;
+};
+#endif  // MXNET_USE_OPENCV
+}  // namespace io
+}  // namespace mxnet
+#endif  // MXNET_IO_IMAGE_CACHE_H_
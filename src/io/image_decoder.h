@@ -0,0 +1,116 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file image_decoder.h
+ * \brief image decoding that can skip resolution which is thrown away later
+ */
+#ifndef MXNET_IO_IMAGE_DECODER_H_
+#define MXNET_IO_IMAGE_DECODER_H_
+
+#include <dmlc/logging.h>
+#if MXNET_USE_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+#if MXNET_USE_LIBJPEG_TURBO
+#include <csetjmp>
+#include <cstdio>
+#include <jpeglib.h>
+#endif
+#include <algorithm>
+
+namespace mxnet {
+namespace io {
+#if MXNET_USE_OPENCV
+#if MXNET_USE_LIBJPEG_TURBO
+/*! \brief libjpeg error manager that returns to the caller instead of exiting */
+struct JpegErrorManager {
+  struct jpeg_error_mgr pub;
+  std::jmp_buf jump;
+};
+
+inline void JpegErrorExit(j_common_ptr cinfo) {
+  JpegErrorManager *err = reinterpret_cast<JpegErrorManager*>(cinfo->err);
+  std::longjmp(err->jump, 1);
+}
+
+/*!
+ * \brief decode a JPEG with DCT scaling. Returns false when the image is not a
+ *  JPEG libjpeg can decode to the requested format, or when no reduction is possible.
+ * \param flag 0 for gray, 1 for BGR, like cv::imdecode
+ * \param min_short_edge the decoded shorter edge is kept at least this long
+ */
+inline bool JpegDecodeScaled(const unsigned char *data, size_t size, int flag,
+                             int min_short_edge, cv::Mat *out) {
+  if (size < 2 || data[0] != 0xFF || data[1] != 0xD8) return false;
+  struct jpeg_decompress_struct cinfo;
+  JpegErrorManager jerr;
+  cinfo.err = jpeg_std_error(&jerr.pub);
+  jerr.pub.error_exit = JpegErrorExit;
+  if (setjmp(jerr.jump)) {
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+  jpeg_create_decompress(&cinfo);
+  jpeg_mem_src(&cinfo, const_cast<unsigned char*>(data), size);
+  jpeg_read_header(&cinfo, TRUE);
+  if (cinfo.jpeg_color_space == JCS_CMYK || cinfo.jpeg_color_space == JCS_YCCK) {
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+  // largest reduction, output sizes are rounded up by libjpeg
+  const unsigned short_edge = std::min(cinfo.image_width, cinfo.image_height);
+  unsigned denom = 8;
+  while (denom > 1 && (short_edge + denom - 1) / denom < static_cast<unsigned>(min_short_edge)) {
+    denom /= 2;
+  }
+  if (denom == 1) {
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+  cinfo.scale_num = 1;
+  cinfo.scale_denom = denom;
+  bool need_swap = false;
+  if (flag == 0) {
+    cinfo.out_color_space = JCS_GRAYSCALE;
+  } else {
+#ifdef JCS_EXTENSIONS
+    cinfo.out_color_space = JCS_EXT_BGR;
+#else
+    cinfo.out_color_space = JCS_RGB;
+    need_swap = true;
+#endif
+  }
+  jpeg_start_decompress(&cinfo);
+  out->create(cinfo.output_height, cinfo.output_width, flag == 0 ? CV_8UC1 : CV_8UC3);
+  while (cinfo.output_scanline < cinfo.output_height) {
+    JSAMPROW row = out->ptr<unsigned char>(cinfo.output_scanline);
+    jpeg_read_scanlines(&cinfo, &row, 1);
+  }
+  jpeg_finish_decompress(&cinfo);
+  jpeg_destroy_decompress(&cinfo);
+  if (need_swap) cv::cvtColor(*out, *out, CV_RGB2BGR);
+  return true;
+}
+#endif  // MXNET_USE_LIBJPEG_TURBO
+
+/*!
+ * \brief decode an image like cv::imdecode(buf, flag). When built with libjpeg-turbo
+ *  and min_short_edge is positive, a gray or color JPEG is decoded directly at 1/2,
+ *  1/4 or 1/8 of its size, the smallest scale whose shorter edge still covers
+ *  min_short_edge. Other images are decoded by OpenCV at full resolution.
+ */
+inline cv::Mat ImdecodeAtLeast(const cv::Mat &buf, int flag, int min_short_edge) {
+#if MXNET_USE_LIBJPEG_TURBO
+  if (min_short_edge > 0 && (flag == 0 || flag == 1)) {
+    cv::Mat res;
+    if (JpegDecodeScaled(buf.ptr<unsigned char>(), buf.total() * buf.elemSize(),
+                         flag, min_short_edge, &res)) {
+      return res;
+    }
+  }
+#endif  // MXNET_USE_LIBJPEG_TURBO
+  return cv::imdecode(buf, flag);
+}
+#endif  // MXNET_USE_OPENCV
+}  // namespace io
+}  // namespace mxnet
+#endif  // MXNET_IO_IMAGE_DECODER_H_
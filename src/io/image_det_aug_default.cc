@@ -74,6 +74,8 @@ struct DefaultImageDetAugmentParam : public dmlc::Parameter<DefaultImageDetAugme
   int max_random_illumination;
   /*! \brief random illumination change prob */
   float random_illumination_prob;
+  /*! \brief whether to jitter the color with a matrix on BGR pixels */
+  bool color_jitter_bgr;
   /*! \brief max random contrast */
   float max_random_contrast;
   /*! \brief random contrast prob */
@@ -152,6 +154,11 @@ struct DefaultImageDetAugmentParam : public dmlc::Parameter<DefaultImageDetAugme
         .describe("Augmentation Param: Maximum random value of L channel in HSL color space.");
     DMLC_DECLARE_FIELD(random_illumination_prob).set_default(0.0f)
         .describe("Augmentation Param: Probability to apply random illumination.");
+    DMLC_DECLARE_FIELD(color_jitter_bgr).set_default(false)
+        .describe("Augmentation Param: Apply the hue, saturation and illumination jitter "
+                  "as one color matrix on the BGR pixels instead of converting to HSL and "
+                  "back. Faster, hue rotates the hue, saturation scales it by "
+                  "``1 + saturation / 255`` and illumination is added to each channel.");
     DMLC_DECLARE_FIELD(max_random_contrast).set_default(0)
         .describe("Augmentation Param: Maximum random value of delta contrast.");
     DMLC_DECLARE_FIELD(random_contrast_prob).set_default(0.0f)
@@ -526,20 +533,13 @@ class DefaultImageDetAugmenter : public ImageAugmenter {
       l = rand_uniform(*prnd) < param_.random_illumination_prob ? l : 0;
       c = rand_uniform(*prnd) < param_.random_contrast_prob ? c : 0;
       if (h != 0 || s != 0 || l != 0) {
-        int temp[3] = {h, l, s};
-        int limit[3] = {180, 255, 255};
-        cv::cvtColor(res, res, CV_BGR2HLS);
-        for (int i = 0; i < res.rows; ++i) {
-          for (int j = 0; j < res.cols; ++j) {
-            for (int k = 0; k < 3; ++k) {
-              int v = res.at<cv::Vec3b>(i, j)[k];
-              v += temp[k];
-              v = std::max(0, std::min(limit[k], v));
-              res.at<cv::Vec3b>(i, j)[k] = v;
-            }
-          }
+        cv::Mat jittered;
+        if (param_.color_jitter_bgr) {
+          JitterBGR(res, h, l, s, &jittered);
+        } else {
+          JitterHLS(res, h, l, s, &jittered);
         }
-        cv::cvtColor(res, res, CV_HLS2BGR);
+        res = jittered;
       }
       if (fabs(c) > 1e-3) {
         cv::Mat tmp = res;
@@ -84,12 +84,16 @@ struct ImageRecParserParam : public dmlc::Parameter<ImageRecParserParam> {
   std::string path_imglist;
   /*! \brief path to image recordio */
   std::string path_imgrec;
+  /*! \brief path to the index of the image recordio */
+  std::string path_imgidx;
   /*! \brief a sequence of names of image augmenters, seperated by , */
   std::string aug_seq;
   /*! \brief label-width */
   int label_width;
   /*! \brief input shape */
   TShape data_shape;
+  /*! \brief layout of the output batch */
+  int layout;
   /*! \brief number of threads */
   int preprocess_threads;
   /*! \brief whether to remain silent */
@@ -102,6 +106,8 @@ struct ImageRecParserParam : public dmlc::Parameter<ImageRecParserParam> {
   size_t shuffle_chunk_size;
   /*! \brief the seed for chunk shuffling*/
   int shuffle_chunk_seed;
+  /*! \brief budget of the decoded image cache in MB */
+  size_t decoded_cache_size;
 
   // declare parameters
   DMLC_DECLARE_PARAMETER(ImageRecParserParam) {
@@ -109,6 +115,10 @@ struct ImageRecParserParam : public dmlc::Parameter<ImageRecParserParam> {
         .describe("Path to the image list file");
     DMLC_DECLARE_FIELD(path_imgrec).set_default("")
         .describe("Filename of the image RecordIO file or a directory path.");
+    DMLC_DECLARE_FIELD(path_imgidx).set_default("")
+        .describe("Filename of the index of a local image RecordIO file, as written by "
+                  "``tools/im2rec.py``. If given, records are read by random access and "
+                  "shuffle permutes all the records of the part every epoch.");
     DMLC_DECLARE_FIELD(aug_seq).set_default("aug_default")
         .describe("The augmenter names to represent"\
                   " sequence of augmenters to be applied, seperated by comma." \
@@ -118,6 +128,13 @@ struct ImageRecParserParam : public dmlc::Parameter<ImageRecParserParam> {
     DMLC_DECLARE_FIELD(data_shape)
         .set_expect_ndim(3).enforce_nonzero()
         .describe("The shape of one output image.");
+    DMLC_DECLARE_FIELD(layout).set_default(mshadow::kNCHW)
+        .add_enum("NCHW", mshadow::kNCHW)
+        .add_enum("NHWC", mshadow::kNHWC)
+        .describe("The layout of the output batch. ``data_shape`` is always given "
+                  "as (channels, height, width). NHWC is the layout of the decoded pixels, "
+                  "e.g. for uint8 batches normalized on the device by "
+                  "``contrib.normalize_image``. The ``_v1`` iterators only support NCHW.");
     DMLC_DECLARE_FIELD(preprocess_threads).set_lower_bound(1).set_default(4)
         .describe("The number of threads.");
     DMLC_DECLARE_FIELD(verbose).set_default(true)
@@ -130,6 +147,11 @@ struct ImageRecParserParam : public dmlc::Parameter<ImageRecParserParam> {
         .describe("The data shuffle buffer size in MB. Only valid if shuffle is true");
     DMLC_DECLARE_FIELD(shuffle_chunk_seed).set_default(0)
         .describe("The random seed for shuffling");
+    DMLC_DECLARE_FIELD(decoded_cache_size).set_default(0)
+        .describe("Keep up to this many MB of decoded images in memory, so that "
+                  "later epochs only run the random augmentations on them. "
+                  "Images are stored at the size of the ``resize`` augmentation. "
+                  "Requires unique image indices in the rec file. 0 to disable.");
   }
 };
 
@@ -285,11 +307,34 @@ struct PrefetcherParam : public dmlc::Parameter<PrefetcherParam> {
   size_t prefetch_buffer;
   /*! \brief data type */
   dmlc::optional<int> dtype;
+  /*! \brief whether batches are produced by engine operations */
+  bool use_engine;
+  /*! \brief device the batches are copied to, 0 for no copy */
+  int device_type;
+  /*! \brief id of that device */
+  int device_id;
+  /*! \brief whether to prefetch into page locked memory */
+  bool pin_memory;
 
   // declare parameters
   DMLC_DECLARE_PARAMETER(PrefetcherParam) {
     DMLC_DECLARE_FIELD(prefetch_buffer).set_default(4)
         .describe("Maximal Number of batches to prefetch.");
+    DMLC_DECLARE_FIELD(use_engine).set_default(false)
+        .describe("Load batches with operations pushed to the engine instead of a "
+                  "separate thread. A batch is refilled as soon as the operations "
+                  "reading it are done, and loading shows up in the profiler.");
+    DMLC_DECLARE_FIELD(device_type).set_default(0)
+        .add_enum("none", 0)
+        .add_enum("cpu", Context::kCPU)
+        .add_enum("gpu", Context::kGPU)
+        .describe("Copy every batch to this device as soon as it is prefetched, "
+                  "and return the copies. ``none`` returns the prefetched batches.");
+    DMLC_DECLARE_FIELD(device_id).set_default(0)
+        .describe("Id of the device batches are copied to.");
+    DMLC_DECLARE_FIELD(pin_memory).set_default(false)
+        .describe("Prefetch batches into page locked memory, for faster copies to a "
+                  "GPU. Ignored without GPU support.");
     DMLC_DECLARE_FIELD(dtype)
       .add_enum("float32", mshadow::kFloat32)
       .add_enum("float64", mshadow::kFloat64)
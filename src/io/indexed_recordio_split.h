@@ -0,0 +1,231 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file indexed_recordio_split.h
+ * \brief input split that reads a RecordIO file in random order through its index
+ */
+#ifndef MXNET_IO_INDEXED_RECORDIO_SPLIT_H_
+#define MXNET_IO_INDEXED_RECORDIO_SPLIT_H_
+
+#include <dmlc/base.h>
+#include <dmlc/io.h>
+#include <dmlc/logging.h>
+#include <dmlc/omp.h>
+#include <dmlc/recordio.h>
+#ifdef _WIN32
+#include <cstdio>
+#include <mutex>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mxnet {
+namespace io {
+/*!
+ * \brief InputSplit over a local RecordIO file and the index written next to it
+ *  by tools/im2rec.py, one "key\toffset" line per record.
+ *
+ *  Every epoch the records of the part are permuted as a whole, instead of the
+ *  chunk level shuffling of InputSplitShuffle. A chunk is the next records of
+ *  the permutation up to the hinted size; they are read in file order with
+ *  positional reads issued in parallel, one read per run of adjacent records.
+ */
+class IndexedRecordIOSplitter : public dmlc::InputSplit {
+ public:
+  /*!
+   * \param path_rec path of the RecordIO file, must be a local file
+   * \param path_idx path of the index file
+   * \param part_index the part of the records to read
+   * \param num_parts number of parts the records are divided into
+   * \param shuffle whether to permute the records every epoch
+   * \param seed seed of the permutation
+   * \param nthread number of parallel reads
+   */
+  IndexedRecordIOSplitter(const std::string &path_rec, const std::string &path_idx,
+                          unsigned part_index, unsigned num_parts,
+                          bool shuffle, int seed, int nthread)
+      : shuffle_(shuffle), nthread_(std::max(nthread, 1)), epoch_(0), seed_(seed),
+        chunk_size_(kDefaultChunkSize), cursor_(0) {
+    CHECK_LT(part_index, num_parts) << "invalid part_index";
+#ifdef _WIN32
+    fp_ = std::fopen(path_rec.c_str(), "rb");
+    CHECK(fp_ != nullptr) << "cannot open " << path_rec;
+    _fseeki64(fp_, 0, SEEK_END);
+    const size_t file_size = static_cast<size_t>(_ftelli64(fp_));
+#else
+    fd_ = open(path_rec.c_str(), O_RDONLY);
+    CHECK_GE(fd_, 0) << "cannot open " << path_rec
+                     << ", the indexed reader only supports local files";
+    struct stat st;
+    CHECK_EQ(fstat(fd_, &st), 0) << "cannot stat " << path_rec;
+    const size_t file_size = static_cast<size_t>(st.st_size);
+#endif
+    // the extent of a record ends where the next one in the file starts
+    std::vector<size_t> offsets;
+    std::unique_ptr<dmlc::InputSplit> fi(
+        dmlc::InputSplit::Create(path_idx.c_str(), 0, 1, "text"));
+    dmlc::InputSplit::Blob line;
+    while (fi->NextRecord(&line)) {
+      const char *p = static_cast<const char*>(line.dptr);
+      const char *end = p + line.size;
+      // skip the key
+      while (p != end && !isspace(*p)) ++p;
+      while (p != end && isspace(*p)) ++p;
+      if (p == end) continue;
+      offsets.push_back(static_cast<size_t>(std::strtoull(p, nullptr, 10)));
+    }
+    std::sort(offsets.begin(), offsets.end());
+    offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+    CHECK(offsets.size() != 0) << "no record found in " << path_idx;
+    CHECK_LE(offsets.back(), file_size) << path_idx << " does not index " << path_rec;
+    const size_t begin = offsets.size() * part_index / num_parts;
+    const size_t end = offsets.size() * (part_index + 1) / num_parts;
+    total_size_ = 0;
+    for (size_t i = begin; i < end; ++i) {
+      const size_t next = i + 1 < offsets.size() ? offsets[i + 1] : file_size;
+      records_.push_back(std::make_pair(offsets[i], next - offsets[i]));
+      total_size_ += next - offsets[i];
+    }
+    order_.resize(records_.size());
+    this->BeforeFirst();
+  }
+
+  virtual ~IndexedRecordIOSplitter(void) {
+#ifdef _WIN32
+    std::fclose(fp_);
+#else
+    close(fd_);
+#endif
+  }
+
+  virtual void HintChunkSize(size_t chunk_size) {
+    chunk_size_ = chunk_size > kMinChunkSize ? chunk_size : kMinChunkSize;
+  }
+
+  virtual size_t GetTotalSize(void) {
+    return total_size_;
+  }
+
+  virtual void BeforeFirst(void) {
+    for (size_t i = 0; i < order_.size(); ++i) order_[i] = i;
+    if (shuffle_) {
+      // a different permutation every epoch, reproducible from the seed
+      std::mt19937 rnd(seed_ + kRandMagic * epoch_);
+      std::shuffle(order_.begin(), order_.end(), rnd);
+    }
+    ++epoch_;
+    cursor_ = 0;
+    reader_.reset(nullptr);
+  }
+
+  virtual bool NextRecord(Blob *out_rec) {
+    while (reader_ == nullptr || !reader_->NextRecord(out_rec)) {
+      Blob chunk;
+      if (!this->NextChunk(&chunk)) return false;
+      reader_.reset(new dmlc::RecordIOChunkReader(chunk, 0, 1));
+    }
+    return true;
+  }
+
+  virtual bool NextChunk(Blob *out_chunk) {
+    if (cursor_ == order_.size()) return false;
+    // take the next records of the permutation and sort them by offset
+    std::vector<size_t> ids;
+    size_t nbytes = 0;
+    while (cursor_ < order_.size() && (ids.size() == 0 || nbytes < chunk_size_)) {
+      ids.push_back(order_[cursor_++]);
+      nbytes += records_[ids.back()].second;
+    }
+    std::sort(ids.begin(), ids.end());
+    // coalesce adjacent records into runs of (file offset, buffer offset, size)
+    std::vector<Run> runs;
+    size_t pos = 0;
+    for (size_t id : ids) {
+      const std::pair<size_t, size_t> &rec = records_[id];
+      if (runs.size() != 0 && runs.back().offset + runs.back().size == rec.first) {
+        runs.back().size += rec.second;
+      } else {
+        runs.push_back(Run{rec.first, pos, rec.second});
+      }
+      pos += rec.second;
+    }
+    // records are 4 bytes aligned as RecordIOChunkReader expects
+    buffer_.resize((nbytes + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+    char *dptr = reinterpret_cast<char*>(dmlc::BeginPtr(buffer_));
+    const int nrun = static_cast<int>(runs.size());
+    #pragma omp parallel for num_threads(nthread_) schedule(dynamic, 1)
+    for (int i = 0; i < nrun; ++i) {
+      this->ReadAt(runs[i].offset, runs[i].size, dptr + runs[i].pos);
+    }
+    out_chunk->dptr = dptr;
+    out_chunk->size = nbytes;
+    return true;
+  }
+
+  /*! \brief not supported, the part is fixed at construction */
+  void ResetPartition(unsigned part_index, unsigned num_parts) {
+    LOG(FATAL) << "IndexedRecordIOSplitter does not support ResetPartition";
+  }
+
+ private:
+  /*! \brief default and minimal size of a chunk in bytes */
+  static const size_t kDefaultChunkSize = 8UL << 20UL;
+  static const size_t kMinChunkSize = 1UL << 20UL;
+  // magic number to seed the permutation of each epoch
+  static const int kRandMagic = 233;
+  /*! \brief a contiguous range of the file copied to the chunk */
+  struct Run {
+    size_t offset, pos, size;
+  };
+  /*! \brief read size bytes at offset of the file */
+  inline void ReadAt(size_t offset, size_t size, char *dptr) {
+#ifdef _WIN32
+    std::lock_guard<std::mutex> lock(mutex_);
+    _fseeki64(fp_, offset, SEEK_SET);
+    CHECK_EQ(std::fread(dptr, 1, size, fp_), size) << "failed to read the record file";
+#else
+    while (size != 0) {
+      ssize_t n = pread(fd_, dptr, size, static_cast<off_t>(offset));
+      CHECK_GT(n, 0) << "failed to read the record file";
+      offset += n;
+      dptr += n;
+      size -= n;
+    }
+#endif
+  }
+#ifdef _WIN32
+  std::FILE *fp_;
+  std::mutex mutex_;
+#else
+  int fd_;
+#endif
+  /*! \brief (offset, size) of the records of this part, in file order */
+  std::vector<std::pair<size_t, size_t> > records_;
+  /*! \brief order of the records in the current epoch */
+  std::vector<size_t> order_;
+  /*! \brief total size of the records of this part */
+  size_t total_size_;
+  bool shuffle_;
+  int nthread_;
+  unsigned epoch_;
+  int seed_;
+  size_t chunk_size_;
+  /*! \brief next position in order_ */
+  size_t cursor_;
+  /*! \brief the current chunk */
+  std::vector<uint32_t> buffer_;
+  /*! \brief reader of the current chunk, for NextRecord */
+  std::unique_ptr<dmlc::RecordIOChunkReader> reader_;
+};
+}  // namespace io
+}  // namespace mxnet
+#endif  // MXNET_IO_INDEXED_RECORDIO_SPLIT_H_
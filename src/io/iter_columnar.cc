@@ -0,0 +1,346 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file iter_columnar.cc
+ * \brief iterator over the columnar binary format of columnar_format.h
+ */
+#include <mxnet/io.h>
+#include <mxnet/base.h>
+#include <dmlc/base.h>
+#include <dmlc/logging.h>
+#include <dmlc/memory_io.h>
+#include <dmlc/parameter.h>
+#ifdef _WIN32
+#include <cstdio>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./columnar_format.h"
+#include "./iter_prefetcher.h"
+
+namespace mxnet {
+namespace io {
+// columnar iterator parameters
+struct ColumnarIterParam : public dmlc::Parameter<ColumnarIterParam> {
+  /*! \brief path to the columnar file */
+  std::string path;
+  /*! \brief whether to shuffle the chunks */
+  bool shuffle;
+  /*! \brief seed of the shuffle */
+  int seed;
+  /*! \brief partition of the chunks */
+  int num_parts;
+  int part_index;
+  // declare parameters
+  DMLC_DECLARE_PARAMETER(ColumnarIterParam) {
+    DMLC_DECLARE_FIELD(path)
+        .describe("The columnar file, created by tools/tab2col.");
+    DMLC_DECLARE_FIELD(shuffle).set_default(false)
+        .describe("Whether to visit the chunks in a random order every epoch. "
+                  "Rows within a chunk keep their order.");
+    DMLC_DECLARE_FIELD(seed).set_default(0)
+        .describe("The random seed.");
+    DMLC_DECLARE_FIELD(num_parts).set_default(1)
+        .describe("Virtually partition the chunks into this number of parts.");
+    DMLC_DECLARE_FIELD(part_index).set_default(0)
+        .describe("The index of the part to read.");
+  }
+};
+
+/*! \brief read only mapping of a whole local file */
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string &path) {
+#ifdef _WIN32
+    std::FILE *fp = std::fopen(path.c_str(), "rb");
+    CHECK(fp != nullptr) << "cannot open " << path;
+    _fseeki64(fp, 0, SEEK_END);
+    size_ = static_cast<size_t>(_ftelli64(fp));
+    _fseeki64(fp, 0, SEEK_SET);
+    buffer_.resize((size_ + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    CHECK_EQ(std::fread(dmlc::BeginPtr(buffer_), 1, size_, fp), size_)
+        << "failed to read " << path;
+    std::fclose(fp);
+    dptr_ = reinterpret_cast<const char*>(dmlc::BeginPtr(buffer_));
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    CHECK_GE(fd, 0) << "cannot open " << path << ", only local files can be mapped";
+    struct stat st;
+    CHECK_EQ(fstat(fd, &st), 0) << "cannot stat " << path;
+    size_ = static_cast<size_t>(st.st_size);
+    void *ptr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    CHECK(ptr != MAP_FAILED) << "cannot map " << path;
+    close(fd);
+    dptr_ = static_cast<const char*>(ptr);
+#endif
+  }
+  ~MappedFile() {
+#ifndef _WIN32
+    munmap(const_cast<char*>(dptr_), size_);
+#endif
+  }
+  inline const char *data() const {
+    return dptr_;
+  }
+  inline size_t size() const {
+    return size_;
+  }
+
+ private:
+  const char *dptr_;
+  size_t size_;
+#ifdef _WIN32
+  std::vector<uint64_t> buffer_;
+#endif
+};
+
+/*!
+ * \brief produces batches of a columnar file. Blocks stored as is are read in
+ *  place from the mapping, compressed blocks are decoded once per visit of
+ *  their chunk, and a batch is assembled by copying row ranges of each column.
+ */
+class ColumnarIter : public IIterator<TBlobBatch> {
+ public:
+  ColumnarIter() : chunk_(-1), epoch_(0), num_overflow_(0) {}
+
+  virtual void Init(const std::vector<std::pair<std::string, std::string> >& kwargs) {
+    param_.InitAllowUnknown(kwargs);
+    batch_param_.InitAllowUnknown(kwargs);
+    CHECK_LT(param_.part_index, param_.num_parts) << "invalid part_index";
+    file_.reset(new MappedFile(param_.path));
+    this->LoadFooter();
+    // the chunks of this part and the index of their first row
+    const size_t nchunk = footer_.chunk_rows.size();
+    std::vector<uint64_t> row_begin(nchunk + 1, 0);
+    for (size_t i = 0; i < nchunk; ++i) row_begin[i + 1] = row_begin[i] + footer_.chunk_rows[i];
+    for (size_t i = nchunk * param_.part_index / param_.num_parts;
+         i < nchunk * (param_.part_index + 1) / param_.num_parts; ++i) {
+      if (footer_.chunk_rows[i] == 0) continue;
+      chunks_.push_back(i);
+    }
+    row_begin_.swap(row_begin);
+    CHECK_NE(chunks_.size(), 0U) << "no row in part " << param_.part_index
+                                 << " of " << param_.path;
+    // output arrays
+    const size_t batch_size = batch_param_.batch_size;
+    const size_t num_label = footer_.num_label;
+    const size_t num_data = footer_.num_column() - num_label;
+    data_.resize(batch_size * num_data);
+    label_.resize(batch_size * std::max<size_t>(num_label, 1));
+    out_.batch_size = batch_size;
+    // owned by out_
+    out_.inst_index = new unsigned[batch_size];
+    out_.data.clear();
+    out_.data.push_back(TBlob(dmlc::BeginPtr(data_), mshadow::Shape2(batch_size, num_data),
+                              cpu::kDevMask));
+    if (num_label <= 1) {
+      out_.data.push_back(TBlob(dmlc::BeginPtr(label_), mshadow::Shape1(batch_size),
+                                cpu::kDevMask));
+    } else {
+      out_.data.push_back(TBlob(dmlc::BeginPtr(label_), mshadow::Shape2(batch_size, num_label),
+                                cpu::kDevMask));
+    }
+    this->Rewind();
+  }
+
+  virtual void BeforeFirst(void) {
+    // a round batch already wrapped around into the next epoch
+    if (!batch_param_.round_batch || num_overflow_ == 0) {
+      this->Rewind();
+    } else {
+      num_overflow_ = 0;
+    }
+  }
+
+  virtual bool Next(void) {
+    if (num_overflow_ != 0) return false;
+    const size_t batch_size = batch_param_.batch_size;
+    size_t top = this->Fill(0);
+    if (top == 0) return false;
+    out_.num_batch_padd = 0;
+    if (top < batch_size) {
+      if (batch_param_.round_batch) {
+        num_overflow_ = batch_size - top;
+        this->Rewind();
+        top = this->Fill(top);
+        CHECK_EQ(top, batch_size) << "number of rows must be bigger than batch size";
+        out_.num_batch_padd = num_overflow_;
+      } else {
+        out_.num_batch_padd = batch_size - top;
+      }
+    }
+    return true;
+  }
+
+  virtual const TBlobBatch &Value(void) const {
+    return out_;
+  }
+
+ private:
+  inline void LoadFooter() {
+    const char *dptr = file_->data();
+    const size_t size = file_->size();
+    uint64_t magic = 0, footer_offset = 0;
+    CHECK_GE(size, 3 * sizeof(uint64_t)) << param_.path << " is not a columnar file";
+    std::memcpy(&magic, dptr, sizeof(magic));
+    CHECK_EQ(magic, columnar::kMagic) << param_.path << " is not a columnar file";
+    std::memcpy(&footer_offset, dptr + size - 2 * sizeof(uint64_t), sizeof(footer_offset));
+    std::memcpy(&magic, dptr + size - sizeof(uint64_t), sizeof(magic));
+    CHECK(magic == columnar::kMagic && footer_offset <= size - 2 * sizeof(uint64_t))
+        << param_.path << " is truncated";
+    dmlc::MemoryFixedSizeStream fi(const_cast<char*>(dptr) + footer_offset,  // NOLINT(*)
+                                   size - 2 * sizeof(uint64_t) - footer_offset);
+    footer_.Load(&fi);
+    for (size_t i = 0; i < footer_.offsets.size(); ++i) {
+      CHECK_LE(footer_.offsets[i] + footer_.sizes[i], footer_offset)
+          << param_.path << " is corrupted";
+    }
+    blocks_.resize(footer_.num_column());
+    buffers_.resize(footer_.num_column());
+  }
+  /*! \brief restart from the first chunk of a new epoch */
+  inline void Rewind() {
+    order_ = chunks_;
+    if (param_.shuffle) {
+      std::mt19937 rnd(param_.seed + kRandMagic * epoch_);
+      std::shuffle(order_.begin(), order_.end(), rnd);
+    }
+    ++epoch_;
+    pos_ = 0;
+    row_ = 0;
+  }
+  /*!
+   * \brief copy rows from the current position to the batch, starting at row
+   *  top of the batch, until the batch is full or the epoch ends
+   * \return the number of rows of the batch filled
+   */
+  inline size_t Fill(size_t top) {
+    const size_t batch_size = batch_param_.batch_size;
+    const size_t num_label = footer_.num_label;
+    const size_t num_column = footer_.num_column();
+    const size_t num_data = num_column - num_label;
+    while (top < batch_size && pos_ < order_.size()) {
+      const size_t chunk = order_[pos_];
+      this->MapChunk(chunk);
+      const size_t n = std::min<size_t>(batch_size - top, footer_.chunk_rows[chunk] - row_);
+      for (size_t c = 0; c < num_column; ++c) {
+        // row major destination, a label column when c < num_label
+        real_t *dst = c < num_label ? dmlc::BeginPtr(label_) + top * num_label + c
+                                    : dmlc::BeginPtr(data_) + top * num_data + c - num_label;
+        const size_t stride = c < num_label ? num_label : num_data;
+        MSHADOW_TYPE_SWITCH(footer_.dtypes[c], DType, {
+          const DType *src = reinterpret_cast<const DType*>(blocks_[c]) + row_;
+          for (size_t i = 0; i < n; ++i) {
+            dst[i * stride] = static_cast<real_t>(src[i]);
+          }
+        });
+      }
+      if (num_label == 0) std::fill_n(dmlc::BeginPtr(label_) + top, n, 0.0f);
+      for (size_t i = 0; i < n; ++i) {
+        out_.inst_index[top + i] = static_cast<unsigned>(row_begin_[chunk] + row_ + i);
+      }
+      top += n;
+      row_ += n;
+      if (row_ == footer_.chunk_rows[chunk]) {
+        ++pos_;
+        row_ = 0;
+      }
+    }
+    return top;
+  }
+  /*! \brief point blocks_ to the columns of a chunk, decoding compressed ones */
+  inline void MapChunk(size_t chunk) {
+    if (static_cast<int64_t>(chunk) == chunk_) return;
+    const size_t num_column = footer_.num_column();
+    const size_t num_rows = footer_.chunk_rows[chunk];
+    for (size_t c = 0; c < num_column; ++c) {
+      const size_t k = chunk * num_column + c;
+      const char *dptr = file_->data() + footer_.offsets[k];
+      const size_t elem_size = mshadow::mshadow_sizeof(footer_.dtypes[c]);
+      switch (footer_.codecs[k]) {
+        case columnar::kRaw:
+          CHECK_EQ(footer_.sizes[k], num_rows * elem_size) << param_.path << " is corrupted";
+          blocks_[c] = dptr;
+          break;
+        case columnar::kShuffleRLE: {
+          // 8 bytes aligned, like the blocks in the file
+          const size_t nword = (num_rows * elem_size + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+          buffers_[c].resize(2 * nword);
+          char *buf = reinterpret_cast<char*>(dmlc::BeginPtr(buffers_[c]));
+          columnar::ShuffleRLEDecode(dptr, footer_.sizes[k], num_rows, elem_size,
+                                     buf + nword * sizeof(uint64_t), buf);
+          blocks_[c] = buf;
+          break;
+        }
+        default:
+          LOG(FATAL) << "unknown codec " << footer_.codecs[k] << " in " << param_.path;
+      }
+    }
+    chunk_ = static_cast<int64_t>(chunk);
+  }
+  // magic number to seed the shuffle of each epoch
+  static const int kRandMagic = 111;
+  ColumnarIterParam param_;
+  BatchParam batch_param_;
+  std::unique_ptr<MappedFile> file_;
+  columnar::Footer footer_;
+  /*! \brief chunks of this part, and the order of the current epoch */
+  std::vector<size_t> chunks_, order_;
+  /*! \brief index of the first row of every chunk */
+  std::vector<uint64_t> row_begin_;
+  /*! \brief position in order_ and row in that chunk */
+  size_t pos_, row_;
+  /*! \brief chunk the blocks point to, -1 for none */
+  int64_t chunk_;
+  /*! \brief columns of the chunk, in the mapping or in buffers_ */
+  std::vector<const char*> blocks_;
+  /*! \brief decoded compressed columns */
+  std::vector<std::vector<uint64_t> > buffers_;
+  unsigned epoch_;
+  /*! \brief number of rows of the next epoch in the last round batch */
+  size_t num_overflow_;
+  /*! \brief output */
+  std::vector<real_t> data_, label_;
+  TBlobBatch out_;
+};
+
+DMLC_REGISTER_PARAMETER(ColumnarIterParam);
+
+MXNET_REGISTER_IO_ITER(ColumnarIter)
+.describe(R"code(Iterating on a columnar binary file.
+
+The file stores tabular data column by column in chunks of rows, and is created
+from CSV or LibSVM text by ``tools/tab2col``. It is memory mapped, and batches
+are sliced from the columns, so no text is parsed during training. Data is
+returned as float32 of shape ``(batch_size, number of data columns)``, label of
+shape ``(batch_size,)``, or ``(batch_size, number of label columns)`` when there
+are several.
+
+Like `CSVIter`, ``round_batch`` fills the last batch of an epoch with the first
+rows of the next one.
+
+Examples::
+
+  // convert a CSV file whose first column is the label
+  tab2col data.csv data.col format=csv label_width=1 compress=1
+
+  ColumnarIter = mx.io.ColumnarIter(path='data.col', batch_size=128, shuffle=True)
+
+)code" ADD_FILELINE)
+.add_arguments(ColumnarIterParam::__FIELDS__())
+.add_arguments(BatchParam::__FIELDS__())
+.add_arguments(PrefetcherParam::__FIELDS__())
+.set_body([]() {
+    return new PrefetcherIter(new ColumnarIter());
+  });
+}  // namespace io
+}  // namespace mxnet
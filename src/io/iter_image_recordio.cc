@@ -67,6 +67,8 @@ inline void ImageRecordIOParser<DType>::Init(
   // initialize parameter
   // init image rec param
   param_.InitAllowUnknown(kwargs);
+  CHECK_EQ(param_.layout, mshadow::kNCHW)
+    << "The _v1 image record iterators only support the NCHW layout";
   int maxthread, threadget;
   #pragma omp parallel
   {
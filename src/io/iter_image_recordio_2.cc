@@ -14,11 +14,16 @@
 #include <dmlc/omp.h>
 #include <dmlc/common.h>
 #include <dmlc/timer.h>
+#include <deque>
+#include <string>
 #include <type_traits>
 #include "./image_recordio.h"
 #include "./image_augmenter.h"
+#include "./image_cache.h"
+#include "./image_decoder.h"
 #include "./image_iter_common.h"
-#include "./inst_vector.h"
+#include "./indexed_recordio_split.h"
+#include "./iter_prefetcher.h"
 #include "../common/utils.h"
 
 namespace mxnet {
@@ -45,6 +50,21 @@ class ImageRecordIOParser2 {
 
  private:
   inline void ParseChunk(dmlc::InputSplit::Blob * chunk);
+  /*!
+   * \brief decode, augment and normalize one record into data and label,
+   *  which are the slots of the image in the output batch
+   * \return the image index of the record
+   */
+  inline unsigned ProcessImage(const dmlc::InputSplit::Blob &blob, int tid,
+                               mshadow::Tensor<cpu, 3, DType> data,
+                               mshadow::Tensor<cpu, 1> label);
+#if MXNET_USE_OPENCV
+  /*!
+   * \brief decode the image of a record, or take it from the cache, at the
+   *  resolution the augmenters start from
+   */
+  inline cv::Mat DecodeImage(const ImageRecordIO &rec);
+#endif
   inline void CreateMeanImg(void);
 
   // magic number to seed prng
@@ -67,23 +87,29 @@ class ImageRecordIOParser2 {
   std::unique_ptr<dmlc::InputSplit> source_;
   /*! \brief label information, if any */
   std::unique_ptr<ImageLabelMap> label_map_;
-  /*! \brief temporary results */
-  std::vector<InstVector<DType>> temp_;
-  /*! \brief temp space */
-  mshadow::TensorContainer<cpu, 3> img_;
+  /*! \brief records of the current chunk */
+  std::vector<dmlc::InputSplit::Blob> records_;
+  /*! \brief copies of the records that are not contiguous in the chunk */
+  std::deque<std::string> record_copies_;
   /*! \brief internal instance order */
-  std::vector<std::pair<unsigned, unsigned> > inst_order_;
+  std::vector<unsigned> inst_order_;
   unsigned inst_index_;
   /*! \brief internal counter tracking number of already parsed entries */
   unsigned n_parsed_;
   /*! \brief overflow marker */
   bool overflow;
-  /*! \brief unit size */
-  std::vector<size_t> unit_size_;
   /*! \brief mean image, if needed */
   mshadow::TensorContainer<cpu, 3> meanimg_;
   // whether mean image is ready.
   bool meanfile_ready_;
+  /*! \brief shorter edge the default augmenter resizes to first, -1 if it does not */
+  int decode_short_edge_;
+  /*! \brief interpolation of that resize */
+  int decode_inter_method_;
+#if MXNET_USE_OPENCV
+  /*! \brief decoded images kept across epochs, if enabled */
+  std::unique_ptr<ImageCache> cache_;
+#endif
 };
 
 template<typename DType>
@@ -114,6 +140,23 @@ inline void ImageRecordIOParser2<DType>::Init(
   param_.preprocess_threads = threadget;
 
   std::vector<std::string> aug_names = dmlc::Split(param_.aug_seq, ',');
+  // the default augmenter starts by resizing the shorter edge to `resize`,
+  // so pixels beyond that resolution do not need to be decoded
+  decode_short_edge_ = -1;
+  decode_inter_method_ = 1;
+  if (aug_names.size() != 0 && aug_names[0] == "aug_default") {
+    for (const auto& kv : kwargs) {
+      if (kv.first == "resize") decode_short_edge_ = std::atoi(kv.second.c_str());
+      if (kv.first == "inter_method") decode_inter_method_ = std::atoi(kv.second.c_str());
+    }
+  }
+  if (param_.decoded_cache_size > 0) {
+    cache_.reset(new ImageCache(param_.decoded_cache_size << 20UL));
+    if (param_.verbose) {
+      LOG(INFO) << "ImageRecordIOParser2: cache up to " << param_.decoded_cache_size
+                << " MB of decoded images";
+    }
+  }
   augmenters_.clear();
   augmenters_.resize(threadget);
   // setup decoders
@@ -135,10 +178,19 @@ inline void ImageRecordIOParser2<DType>::Init(
     LOG(INFO) << "ImageRecordIOParser2: " << param_.path_imgrec
               << ", use " << threadget << " threads for decoding..";
   }
-  source_.reset(dmlc::InputSplit::Create(
-      param_.path_imgrec.c_str(), param_.part_index,
-      param_.num_parts, "recordio"));
-  if (param_.shuffle_chunk_size > 0) {
+  if (param_.path_imgidx.length() != 0) {
+    // random access through the index, shuffled globally
+    source_.reset(new IndexedRecordIOSplitter(
+        param_.path_imgrec, param_.path_imgidx, param_.part_index, param_.num_parts,
+        record_param_.shuffle, record_param_.seed, threadget));
+  } else {
+    source_.reset(dmlc::InputSplit::Create(
+        param_.path_imgrec.c_str(), param_.part_index,
+        param_.num_parts, "recordio"));
+  }
+  if (param_.path_imgidx.length() != 0) {
+    // the whole part is already permuted, chunk shuffling is not needed
+  } else if (param_.shuffle_chunk_size > 0) {
     if (param_.shuffle_chunk_size > 4096) {
       LOG(INFO) << "Chunk size: " << param_.shuffle_chunk_size
                  << " MB which is larger than 4096 MB, please set "
@@ -213,17 +265,9 @@ inline bool ImageRecordIOParser2<DType>::ParseNext(DataBatch *out) {
     int n_to_copy;
     if (n_parsed_ == 0) {
       if (source_->NextChunk(&chunk)) {
-        inst_order_.clear();
         inst_index_ = 0;
         ParseChunk(&chunk);
-        unsigned n_read = 0;
-        for (unsigned i = 0; i < temp_.size(); ++i) {
-          const InstVector<DType>& tmp = temp_[i];
-          for (unsigned j = 0; j < tmp.Size(); ++j) {
-            inst_order_.push_back(std::make_pair(i, j));
-          }
-          n_read += tmp.Size();
-        }
+        unsigned n_read = inst_order_.size();
         n_to_copy = std::min(n_read, batch_param_.batch_size - current_size);
         n_parsed_ = n_read - n_to_copy;
         // shuffle instance order if needed
@@ -249,41 +293,32 @@ inline bool ImageRecordIOParser2<DType>::ParseNext(DataBatch *out) {
 
     // InitBatch
     if (out->data.size() == 0 && n_to_copy != 0) {
-      std::pair<unsigned, unsigned> place = inst_order_[inst_index_];
-      const DataInst& first_batch = temp_[place.first][place.second];
-      out->data.resize(first_batch.data.size());
-      unit_size_.resize(first_batch.data.size());
-      for (size_t i = 0; i < out->data.size(); ++i) {
-        TShape src_shape = first_batch.data[i].shape_;
-        int src_type_flag = first_batch.data[i].type_flag_;
-        // init object attributes
-        std::vector<index_t> shape_vec;
-        shape_vec.push_back(batch_param_.batch_size);
-        for (index_t dim = 0; dim < src_shape.ndim(); ++dim) {
-          shape_vec.push_back(src_shape[dim]);
-        }
-        TShape dst_shape(shape_vec.begin(), shape_vec.end());
-        auto dtype = prefetch_param_.dtype
-          ? prefetch_param_.dtype.value()
-          : first_batch.data[i].type_flag_;
-        out->data.at(i) = NDArray(dst_shape, Context::CPU(), false , src_type_flag);
-        unit_size_[i] = src_shape.Size();
+      TShape data_shape = mshadow::Shape4(batch_param_.batch_size, param_.data_shape[0],
+                                          param_.data_shape[1], param_.data_shape[2]);
+      if (param_.layout == mshadow::kNHWC) {
+        data_shape = mshadow::Shape4(batch_param_.batch_size, param_.data_shape[1],
+                                     param_.data_shape[2], param_.data_shape[0]);
       }
+      out->data.resize(2);
+      out->data[0] = NDArray(data_shape, PrefetchContext(prefetch_param_), false,
+                             mshadow::DataType<DType>::kFlag);
+      out->data[1] = NDArray(mshadow::Shape2(batch_param_.batch_size, param_.label_width),
+                             PrefetchContext(prefetch_param_), false, mshadow::kFloat32);
     }
 
-    // Copy
-    #pragma omp parallel for num_threads(param_.preprocess_threads)
-    for (int i = 0; i < n_to_copy; ++i) {
-      std::pair<unsigned, unsigned> place = inst_order_[inst_index_ + i];
-      const DataInst& batch = temp_[place.first][place.second];
-      for (unsigned j = 0; j < batch.data.size(); ++j) {
-        CHECK_EQ(unit_size_[j], batch.data[j].Size());
-        MSHADOW_TYPE_SWITCH(out->data[j].data().type_flag_, dtype, {
-        mshadow::Copy(
-            out->data[j].data().FlatTo1D<cpu, dtype>().Slice((current_size + i) * unit_size_[j],
-              (current_size + i + 1) * unit_size_[j]),
-            batch.data[j].get_with_shape<cpu, 1, dtype>(mshadow::Shape1(unit_size_[j])));
-        });
+    // decode and augment every image directly into its slot of the batch.
+    // With the static schedule the random stream drawn by an image depends on
+    // its position in the batch, so the augmentations are reproducible for a
+    // given seed and preprocess_threads, but differ from the ones drawn when
+    // each thread augmented its part of the chunk in ParseChunk
+    if (n_to_copy != 0) {
+      mshadow::Tensor<cpu, 4, DType> data = out->data[0].data().get<cpu, 4, DType>();
+      mshadow::Tensor<cpu, 2> label = out->data[1].data().get<cpu, 2, real_t>();
+      #pragma omp parallel for num_threads(param_.preprocess_threads) schedule(static)
+      for (int i = 0; i < n_to_copy; ++i) {
+        const unsigned pos = current_size + i;
+        out->index[pos] = ProcessImage(records_[inst_order_[inst_index_ + i]],
+                                       omp_get_thread_num(), data[pos], label[pos]);
       }
     }
     inst_index_ += n_to_copy;
@@ -294,147 +329,187 @@ inline bool ImageRecordIOParser2<DType>::ParseNext(DataBatch *out) {
 
 template<typename DType>
 inline void ImageRecordIOParser2<DType>::ParseChunk(dmlc::InputSplit::Blob * chunk) {
-  temp_.resize(param_.preprocess_threads);
+  // only locate the records, decoding happens when they are written to a batch
+  records_.clear();
+  record_copies_.clear();
+  inst_order_.clear();
+  dmlc::RecordIOChunkReader reader(*chunk, 0, 1);
+  dmlc::InputSplit::Blob blob;
+  const char *begin = static_cast<const char*>(chunk->dptr);
+  const char *end = begin + chunk->size;
+  while (reader.NextRecord(&blob)) {
+    const char *p = static_cast<const char*>(blob.dptr);
+    if (p < begin || p >= end) {
+      // a record split into several parts is assembled in a buffer of the reader,
+      // which is overwritten by the next record
+      record_copies_.emplace_back(p, blob.size);
+      blob.dptr = &record_copies_.back()[0];
+    }
+    inst_order_.push_back(records_.size());
+    records_.push_back(blob);
+  }
+}
+
 #if MXNET_USE_OPENCV
-  // save opencv out
-  #pragma omp parallel num_threads(param_.preprocess_threads)
-  {
-    CHECK(omp_get_num_threads() == param_.preprocess_threads);
-    int tid = omp_get_thread_num();
-    dmlc::RecordIOChunkReader reader(*chunk, tid, param_.preprocess_threads);
-    ImageRecordIO rec;
-    dmlc::InputSplit::Blob blob;
-    // image data
-    InstVector<DType> &out = temp_[tid];
-    out.Clear();
-    while (reader.NextRecord(&blob)) {
-      // Opencv decode and augments
-      cv::Mat res;
-      rec.Load(blob.dptr, blob.size);
-      cv::Mat buf(1, rec.content_size, CV_8U, rec.content);
-      switch (param_.data_shape[0]) {
-       case 1:
-        res = cv::imdecode(buf, 0);
-        break;
-       case 3:
-        res = cv::imdecode(buf, 1);
-        break;
-       case 4:
-        // -1 to keep the number of channel of the encoded image, and not force gray or color.
-        res = cv::imdecode(buf, -1);
-        CHECK_EQ(res.channels(), 4)
-          << "Invalid image with index " << rec.image_index()
-          << ". Expected 4 channels, got " << res.channels();
-        break;
-       default:
-        LOG(FATAL) << "Invalid output shape " << param_.data_shape;
+template<typename DType>
+inline cv::Mat ImageRecordIOParser2<DType>::DecodeImage(const ImageRecordIO &rec) {
+  cv::Mat res;
+  const uint64_t key = rec.image_index();
+  if (cache_ != nullptr && cache_->Get(key, rec.content_size, &res)) return res;
+  cv::Mat buf(1, rec.content_size, CV_8U, rec.content);
+  switch (param_.data_shape[0]) {
+   case 1:
+    res = ImdecodeAtLeast(buf, 0, decode_short_edge_);
+    break;
+   case 3:
+    res = ImdecodeAtLeast(buf, 1, decode_short_edge_);
+    break;
+   case 4:
+    // -1 to keep the number of channel of the encoded image, and not force gray or color.
+    res = cv::imdecode(buf, -1);
+    CHECK_EQ(res.channels(), 4)
+      << "Invalid image with index " << rec.image_index()
+      << ". Expected 4 channels, got " << res.channels();
+    break;
+   default:
+    LOG(FATAL) << "Invalid output shape " << param_.data_shape;
+  }
+  if (cache_ != nullptr) {
+    // store the image at the size the default augmenter resizes it to, so that
+    // later epochs only run the random part of the augmentation
+    if (decode_short_edge_ > 0) {
+      int new_height, new_width;
+      if (res.rows > res.cols) {
+        new_height = decode_short_edge_ * res.rows / res.cols;
+        new_width = decode_short_edge_;
+      } else {
+        new_height = decode_short_edge_;
+        new_width = decode_short_edge_ * res.cols / res.rows;
       }
-      const int n_channels = res.channels();
-      for (auto& aug : augmenters_[tid]) {
-        res = aug->Process(res, nullptr, prnds_[tid].get());
+      if (new_height != res.rows || new_width != res.cols) {
+        int interpolation_method = decode_inter_method_;
+        if (interpolation_method < 1 || interpolation_method > 4) {
+          // auto or random selection, use the choice auto makes for the common shrink
+          interpolation_method = new_width < res.cols ? cv::INTER_AREA : cv::INTER_LINEAR;
+        }
+        cv::resize(res, res, cv::Size(new_width, new_height), 0, 0, interpolation_method);
       }
-      out.Push(static_cast<unsigned>(rec.image_index()),
-               mshadow::Shape3(n_channels, res.rows, res.cols),
-               mshadow::Shape1(param_.label_width));
-
-      mshadow::Tensor<cpu, 3, DType> data = out.data().Back();
-
-      // For RGB or RGBA data, swap the B and R channel:
-      // OpenCV store as BGR (or BGRA) and we want RGB (or RGBA)
-      std::vector<int> swap_indices;
-      if (n_channels == 1) swap_indices = {0};
-      if (n_channels == 3) swap_indices = {2, 1, 0};
-      if (n_channels == 4) swap_indices = {2, 1, 0, 3};
-
-      std::uniform_real_distribution<float> rand_uniform(0, 1);
-      std::bernoulli_distribution coin_flip(0.5);
-      bool is_mirrored = (normalize_param_.rand_mirror && coin_flip(*(prnds_[tid])))
-                         || normalize_param_.mirror;
-      float contrast_scaled;
-      float illumination_scaled;
-      if (!std::is_same<DType, uint8_t>::value) {
-        contrast_scaled =
-          (rand_uniform(*(prnds_[tid])) * normalize_param_.max_random_contrast * 2
-          - normalize_param_.max_random_contrast + 1)*normalize_param_.scale;
-        illumination_scaled =
-          (rand_uniform(*(prnds_[tid])) * normalize_param_.max_random_illumination * 2
-          - normalize_param_.max_random_illumination) * normalize_param_.scale;
+    }
+    cache_->Put(key, rec.content_size, res);
+  }
+  return res;
+}
+#endif  // MXNET_USE_OPENCV
+
+template<typename DType>
+inline unsigned ImageRecordIOParser2<DType>::ProcessImage(const dmlc::InputSplit::Blob &blob,
+                                                         int tid,
+                                                         mshadow::Tensor<cpu, 3, DType> data,
+                                                         mshadow::Tensor<cpu, 1> label) {
+#if MXNET_USE_OPENCV
+  ImageRecordIO rec;
+  rec.Load(blob.dptr, blob.size);
+  // Opencv decode and augments
+  cv::Mat res = DecodeImage(rec);
+  const int n_channels = res.channels();
+  for (auto& aug : augmenters_[tid]) {
+    res = aug->Process(res, nullptr, prnds_[tid].get());
+  }
+  const bool nhwc = param_.layout == mshadow::kNHWC;
+  CHECK(static_cast<index_t>(res.rows) == data.size(nhwc ? 0 : 1) &&
+        static_cast<index_t>(res.cols) == data.size(nhwc ? 1 : 2))
+    << "Augmented image with index " << rec.image_index() << " has shape ("
+    << res.rows << ", " << res.cols << "), expected data_shape " << param_.data_shape;
+
+  // For RGB or RGBA data, swap the B and R channel:
+  // OpenCV store as BGR (or BGRA) and we want RGB (or RGBA)
+  std::vector<int> swap_indices;
+  if (n_channels == 1) swap_indices = {0};
+  if (n_channels == 3) swap_indices = {2, 1, 0};
+  if (n_channels == 4) swap_indices = {2, 1, 0, 3};
+
+  std::uniform_real_distribution<float> rand_uniform(0, 1);
+  std::bernoulli_distribution coin_flip(0.5);
+  bool is_mirrored = (normalize_param_.rand_mirror && coin_flip(*(prnds_[tid])))
+                     || normalize_param_.mirror;
+  float contrast_scaled;
+  float illumination_scaled;
+  if (!std::is_same<DType, uint8_t>::value) {
+    contrast_scaled =
+      (rand_uniform(*(prnds_[tid])) * normalize_param_.max_random_contrast * 2
+      - normalize_param_.max_random_contrast + 1)*normalize_param_.scale;
+    illumination_scaled =
+      (rand_uniform(*(prnds_[tid])) * normalize_param_.max_random_illumination * 2
+      - normalize_param_.max_random_illumination) * normalize_param_.scale;
+  }
+  for (int i = 0; i < res.rows; ++i) {
+    uchar* im_data = res.ptr<uchar>(i);
+    for (int j = 0; j < res.cols; ++j) {
+      DType RGBA[4];
+      for (int k = 0; k < n_channels; ++k) {
+        RGBA[k] = im_data[swap_indices[k]];
       }
-      for (int i = 0; i < res.rows; ++i) {
-        uchar* im_data = res.ptr<uchar>(i);
-        for (int j = 0; j < res.cols; ++j) {
-          DType RGBA[4];
+      if (!std::is_same<DType, uint8_t>::value) {
+        // normalize/mirror here to avoid memory copies
+        // logic from iter_normalize.h, function SetOutImg
+
+        if (normalize_param_.mean_r > 0.0f || normalize_param_.mean_g > 0.0f ||
+            normalize_param_.mean_b > 0.0f || normalize_param_.mean_a > 0.0f) {
+          // subtract mean per channel
+          RGBA[0] -= normalize_param_.mean_r;
+          if (n_channels >= 3) {
+            RGBA[1] -= normalize_param_.mean_g;
+            RGBA[2] -= normalize_param_.mean_b;
+          }
+          if (n_channels == 4) {
+            RGBA[3] -= normalize_param_.mean_a;
+          }
           for (int k = 0; k < n_channels; ++k) {
-            RGBA[k] = im_data[swap_indices[k]];
+            RGBA[k] = RGBA[k] * contrast_scaled + illumination_scaled;
           }
-          if (!std::is_same<DType, uint8_t>::value) {
-            // normalize/mirror here to avoid memory copies
-            // logic from iter_normalize.h, function SetOutImg
-
-            if (normalize_param_.mean_r > 0.0f || normalize_param_.mean_g > 0.0f ||
-                normalize_param_.mean_b > 0.0f || normalize_param_.mean_a > 0.0f) {
-              // subtract mean per channel
-              RGBA[0] -= normalize_param_.mean_r;
-              if (n_channels >= 3) {
-                RGBA[1] -= normalize_param_.mean_g;
-                RGBA[2] -= normalize_param_.mean_b;
-              }
-              if (n_channels == 4) {
-                RGBA[3] -= normalize_param_.mean_a;
-              }
-              for (int k = 0; k < n_channels; ++k) {
-                RGBA[k] = RGBA[k] * contrast_scaled + illumination_scaled;
-              }
-            } else if (!meanfile_ready_ || normalize_param_.mean_img.length() == 0) {
-              // do not subtract anything
-              for (int k = 0; k < n_channels; ++k) {
-                RGBA[k] = RGBA[k] * normalize_param_.scale;
-              }
-            } else {
-              CHECK(meanfile_ready_);
-              for (int k = 0; k < n_channels; ++k) {
-                  RGBA[k] = (RGBA[k] - meanimg_[k][i][j]) * contrast_scaled + illumination_scaled;
-              }
-            }
+        } else if (!meanfile_ready_ || normalize_param_.mean_img.length() == 0) {
+          // do not subtract anything
+          for (int k = 0; k < n_channels; ++k) {
+            RGBA[k] = RGBA[k] * normalize_param_.scale;
           }
+        } else {
+          CHECK(meanfile_ready_);
           for (int k = 0; k < n_channels; ++k) {
-            if (!std::is_same<DType, uint8_t>::value) {
-              // normalize/mirror here to avoid memory copies
-              // logic from iter_normalize.h, function SetOutImg
-              if (is_mirrored) {
-                data[k][i][res.cols - j - 1] = RGBA[k];
-              } else {
-                data[k][i][j] = RGBA[k];
-              }
-            } else {
-              // do not do normalization in Uint8 reader
-              data[k][i][j] = RGBA[k];
-            }
+              RGBA[k] = (RGBA[k] - meanimg_[k][i][j]) * contrast_scaled + illumination_scaled;
           }
-          im_data += n_channels;
         }
       }
-
-      mshadow::Tensor<cpu, 1> label = out.label().Back();
-      if (label_map_ != nullptr) {
-        mshadow::Copy(label, label_map_->Find(rec.image_index()));
-      } else if (rec.label != NULL) {
-        CHECK_EQ(param_.label_width, rec.num_label)
-          << "rec file provide " << rec.num_label << "-dimensional label "
-             "but label_width is set to " << param_.label_width;
-        mshadow::Copy(label, mshadow::Tensor<cpu, 1>(rec.label,
-                                                     mshadow::Shape1(rec.num_label)));
-      } else {
-        CHECK_EQ(param_.label_width, 1)
-          << "label_width must be 1 unless an imglist is provided "
-             "or the rec file is packed with multi dimensional label";
-        label[0] = rec.header.label;
+      // mirror here to avoid memory copies, the Uint8 reader only skips normalization
+      const int col = is_mirrored ? res.cols - j - 1 : j;
+      for (int k = 0; k < n_channels; ++k) {
+        if (nhwc) {
+          data[i][col][k] = RGBA[k];
+        } else {
+          data[k][i][col] = RGBA[k];
+        }
       }
-      res.release();
+      im_data += n_channels;
     }
   }
+
+  if (label_map_ != nullptr) {
+    mshadow::Copy(label, label_map_->Find(rec.image_index()));
+  } else if (rec.label != NULL) {
+    CHECK_EQ(param_.label_width, rec.num_label)
+      << "rec file provide " << rec.num_label << "-dimensional label "
+         "but label_width is set to " << param_.label_width;
+    mshadow::Copy(label, mshadow::Tensor<cpu, 1>(rec.label,
+                                                 mshadow::Shape1(rec.num_label)));
+  } else {
+    CHECK_EQ(param_.label_width, 1)
+      << "label_width must be 1 unless an imglist is provided "
+         "or the rec file is packed with multi dimensional label";
+    label[0] = rec.header.label;
+  }
+  return static_cast<unsigned>(rec.image_index());
 #else
-      LOG(FATAL) << "Opencv is needed for image decoding and augmenting.";
+  LOG(FATAL) << "Opencv is needed for image decoding and augmenting.";
+  return 0;
 #endif
 }
 
@@ -445,34 +520,40 @@ inline void ImageRecordIOParser2<DType>::CreateMeanImg(void) {
       LOG(INFO) << "Cannot find " << normalize_param_.mean_img
                 << ": create mean image, this will take some time...";
     }
+    CHECK_EQ(param_.layout, mshadow::kNCHW)
+      << "mean image can only be created with NCHW layout";
     double start = dmlc::GetTime();
     dmlc::InputSplit::Blob chunk;
     size_t imcnt = 0;  // NOLINT(*)
+    const int nthread = param_.preprocess_threads;
+    const mshadow::Shape<3> shape = param_.data_shape.get<3>();
+    // per thread output image, label and sum, reduced at the end
+    std::vector<mshadow::TensorContainer<cpu, 3, DType> > img(nthread);
+    std::vector<mshadow::TensorContainer<cpu, 1> > label(nthread);
+    std::vector<mshadow::TensorContainer<cpu, 3, real_t> > sum(nthread);
+    for (int i = 0; i < nthread; ++i) {
+      img[i].Resize(shape);
+      label[i].Resize(mshadow::Shape1(param_.label_width));
+      sum[i].Resize(shape, 0.0f);
+    }
     while (source_->NextChunk(&chunk)) {
       ParseChunk(&chunk);
-      inst_order_.clear();
-      for (unsigned i = 0; i < temp_.size(); ++i) {
-        const InstVector<DType>& tmp = temp_[i];
-        for (unsigned j = 0; j < tmp.Size(); ++j) {
-          inst_order_.push_back(std::make_pair(i, j));
-        }
+      const int n_read = static_cast<int>(records_.size());
+      #pragma omp parallel for num_threads(nthread) schedule(static)
+      for (int i = 0; i < n_read; ++i) {
+        const int tid = omp_get_thread_num();
+        ProcessImage(records_[i], tid, img[tid], label[tid]);
+        sum[tid] += mshadow::expr::tcast<real_t>(img[tid]);
       }
-      for (unsigned i = 0; i < inst_order_.size(); ++i) {
-        std::pair<unsigned, unsigned> place = inst_order_[i];
-        mshadow::Tensor<cpu, 3> outimg =
-          temp_[place.first][place.second].data[0].template get<cpu, 3, real_t>();
-        if (imcnt == 0) {
-          meanimg_.Resize(outimg.shape_);
-          mshadow::Copy(meanimg_, outimg);
-        } else {
-          meanimg_ += outimg;
-        }
-        imcnt += 1;
-        double elapsed = dmlc::GetTime() - start;
-        if (imcnt % 10000L == 0 && param_.verbose) {
-          LOG(INFO) << imcnt << " images processed, " << elapsed << " sec elapsed";
-        }
+      double elapsed = dmlc::GetTime() - start;
+      if ((imcnt + n_read) / 10000L != imcnt / 10000L && param_.verbose) {
+        LOG(INFO) << imcnt + n_read << " images processed, " << elapsed << " sec elapsed";
       }
+      imcnt += n_read;
+    }
+    meanimg_.Resize(shape, 0.0f);
+    for (int i = 0; i < nthread; ++i) {
+      meanimg_ += sum[i];
     }
     meanimg_ *= (1.0f / imcnt);
     // save as mxnet python compatible format.
@@ -494,10 +575,10 @@ inline void ImageRecordIOParser2<DType>::CreateMeanImg(void) {
 template<typename DType = real_t>
 class ImageRecordIter2 : public IIterator<DataBatch> {
  public:
-    ImageRecordIter2() : out_(nullptr) { }
+    ImageRecordIter2() : out_(nullptr), value_(nullptr) { }
 
     virtual ~ImageRecordIter2(void) {
-      iter_.Destroy();
+      if (!prefetch_param_.use_engine) iter_.Destroy();
     }
 
     virtual void Init(const std::vector<std::pair<std::string, std::string> >& kwargs) {
@@ -507,22 +588,51 @@ class ImageRecordIter2 : public IIterator<DataBatch> {
       const int kMaxPrefetchBuffer = 16;
       // init thread iter
       iter_.set_max_capacity(kMaxPrefetchBuffer);
-      // init thread iter
-      iter_.Init([this](DataBatch **dptr) {
+      stager_.Init(prefetch_param_);
+      auto next = [this](DataBatch **dptr) {
           if (*dptr == nullptr) {
             *dptr = new DataBatch();
           }
           return parser_.ParseNext(*dptr);
-          },
-          [this]() { parser_.BeforeFirst(); });
+      };
+      if (prefetch_param_.use_engine) {
+        std::function<void(DataBatch *)> on_push = nullptr;
+        if (stager_.enabled()) {
+          on_push = [this](DataBatch *batch) { stager_.Stage(batch); };
+        }
+        engine_iter_.Init(prefetch_param_.prefetch_buffer, next,
+                          [this]() { parser_.BeforeFirst(); }, on_push);
+        return;
+      }
+      // init thread iter
+      iter_.Init([this, next](DataBatch **dptr) {
+          if (!next(dptr)) return false;
+          if (stager_.enabled()) stager_.Stage(*dptr);
+          return true;
+        }, [this]() { parser_.BeforeFirst(); });
     }
 
     virtual void BeforeFirst(void) {
+      if (prefetch_param_.use_engine) {
+        engine_iter_.BeforeFirst();
+        return;
+      }
       iter_.BeforeFirst();
     }
 
-    // From iter_prefetcher.h
     virtual bool Next(void) {
+      bool ret = prefetch_param_.use_engine ? engine_iter_.Next(&out_) : this->NextOnThread();
+      value_ = ret && stager_.enabled() ? stager_.Get(out_) : out_;
+      return ret;
+    }
+
+    virtual const DataBatch &Value(void) const {
+      return *value_;
+    }
+
+ private:
+    // From iter_prefetcher.h
+    inline bool NextOnThread(void) {
       if (out_ != nullptr) {
         recycle_queue_.push(out_); out_ = nullptr;
       }
@@ -538,22 +648,22 @@ class ImageRecordIter2 : public IIterator<DataBatch> {
       }
       return iter_.Next(&out_);
     }
-
-    virtual const DataBatch &Value(void) const {
-      return *out_;
-    }
-
- private:
     /*! \brief Backend thread */
     dmlc::ThreadedIter<DataBatch> iter_;
     /*! \brief Parameters */
     PrefetcherParam prefetch_param_;
     /*! \brief output data */
     DataBatch *out_;
+    /*! \brief batch given by Value, out_ or its copy on the device */
+    DataBatch *value_;
     /*! \brief queue to be recycled */
     std::queue<DataBatch*> recycle_queue_;
     /* \brief parser */
     ImageRecordIOParser2<DType> parser_;
+    /*! \brief batches produced by the engine, if use_engine */
+    EngineIter engine_iter_;
+    /*! \brief copies of the batches on the device */
+    BatchStager stager_;
 };
 
 MXNET_REGISTER_IO_ITER(ImageRecordIter)
@@ -582,6 +692,10 @@ MXNET_REGISTER_IO_ITER(ImageRecordUInt8Iter)
 This iterator is identical to ``ImageRecordIter`` except for using ``uint8`` as
 the data type instead of ``float``.
 
+Batches are 4 times smaller to copy to the device than ``float`` ones. Together
+with ``layout='NHWC'``, the cast, normalization and transpose can be done on the
+device by ``contrib.normalize_image`` as the first operator of the network.
+
 )code" ADD_FILELINE)
 .add_arguments(ImageRecParserParam::__FIELDS__())
 .add_arguments(ImageRecordParam::__FIELDS__())
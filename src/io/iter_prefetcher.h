@@ -9,6 +9,7 @@
 #include <mxnet/io.h>
 #include <mxnet/base.h>
 #include <mxnet/ndarray.h>
+#include <mxnet/engine.h>
 #include <dmlc/logging.h>
 #include <dmlc/threadediter.h>
 #include <dmlc/optional.h>
@@ -19,19 +20,218 @@
 #include <vector>
 #include <queue>
 #include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include "./inst_vector.h"
 #include "./image_iter_common.h"
 
 namespace mxnet {
 namespace io {
+/*!
+ * \brief produces batches with operations pushed to the engine, an alternative
+ *  to dmlc::ThreadedIter with the same next and before first functions.
+ *
+ *  Every batch of the ring is refilled by an operation that mutates its arrays,
+ *  so the refill waits for the operations reading the batch, e.g. copies to a
+ *  device, without blocking the caller, and whatever reads the batch waits for
+ *  the refill. All loads also mutate a variable of their own, which keeps them
+ *  in order since the next function is usually not thread safe.
+ */
+class EngineIter {
+ public:
+  EngineIter() : loader_var_(nullptr), started_(false), head_(0) {}
+
+  ~EngineIter() {
+    if (loader_var_ == nullptr) return;
+    Engine::Get()->WaitForVar(loader_var_);
+    Engine::Get()->DeleteVariable([](RunContext ctx) {}, Context::CPU(), loader_var_);
+    for (DataBatch *batch : slots_) delete batch;
+  }
+  /*!
+   * \param capacity number of batches in the ring
+   * \param next fills the batch, allocating it if it is nullptr,
+   *  returns false at the end of the data
+   * \param before_first rewinds the data
+   * \param on_push called with the batch of each load once it is pushed, to push
+   *  operations reading the batch
+   */
+  inline void Init(size_t capacity,
+                   std::function<bool(DataBatch **)> next,
+                   std::function<void()> before_first,
+                   std::function<void(DataBatch *)> on_push = nullptr) {
+    capacity_ = std::max<size_t>(capacity, 1);
+    next_ = next;
+    before_first_ = before_first;
+    on_push_ = on_push;
+    loader_var_ = Engine::Get()->NewVariable();
+  }
+  /*! \brief rewind, dropping the batches prefetched for the current epoch */
+  inline void BeforeFirst(void) {
+    Engine::Get()->WaitForVar(loader_var_);
+    before_first_();
+    started_ = false;
+  }
+  /*!
+   * \brief release the batch returned last time and get the next one, which stays
+   *  valid until the next call
+   * \return false at the end of the data
+   */
+  inline bool Next(DataBatch **out) {
+    if (!started_) {
+      if (slots_.size() == 0) {
+        // the first batch is loaded here to learn the shapes of the arrays
+        DataBatch *first = nullptr;
+        if (!next_(&first)) return false;
+        slots_.push_back(first);
+        for (size_t k = 1; k < capacity_; ++k) {
+          DataBatch *batch = new DataBatch();
+          batch->index.resize(first->index.size());
+          for (const NDArray& arr : first->data) {
+            batch->data.push_back(NDArray(arr.shape(), arr.ctx(), false, arr.dtype()));
+          }
+          slots_.push_back(batch);
+        }
+        valid_.assign(slots_.size(), 0);
+        valid_[0] = 1;
+        if (on_push_) on_push_(first);
+        for (size_t k = 1; k < slots_.size(); ++k) this->PushLoad(k);
+      } else {
+        for (size_t k = 0; k < slots_.size(); ++k) this->PushLoad(k);
+      }
+      head_ = 0;
+      started_ = true;
+    } else {
+      this->PushLoad(head_);
+      head_ = (head_ + 1) % slots_.size();
+    }
+    DataBatch *batch = slots_[head_];
+    for (NDArray& arr : batch->data) arr.WaitToRead();
+    *out = valid_[head_] ? batch : nullptr;
+    return *out != nullptr;
+  }
+
+ private:
+  /*! \brief push the load of the next batch into slot k */
+  inline void PushLoad(size_t k) {
+    DataBatch *batch = slots_[k];
+    std::vector<Engine::VarHandle> mutate_vars{loader_var_};
+    for (const NDArray& arr : batch->data) mutate_vars.push_back(arr.var());
+    valid_[k] = 0;
+    Engine::Get()->PushSync([this, batch, k](RunContext ctx) {
+        DataBatch *dptr = batch;
+        valid_[k] = next_(&dptr);
+      }, Context::CPU(), {}, mutate_vars, FnProperty::kCPUPrioritized, 0,
+      PROFILER_MESSAGE("PrefetcherLoad"));
+    if (on_push_) on_push_(batch);
+  }
+  /*! \brief number of batches in the ring */
+  size_t capacity_;
+  /*! \brief functions producing the data */
+  std::function<bool(DataBatch **)> next_;
+  std::function<void()> before_first_;
+  std::function<void(DataBatch *)> on_push_;
+  /*! \brief variable serializing the loads */
+  Engine::VarHandle loader_var_;
+  /*! \brief the ring of batches */
+  std::vector<DataBatch*> slots_;
+  /*! \brief whether the last load of each slot got a batch */
+  std::vector<int> valid_;
+  /*! \brief whether the loads of the current epoch are pushed */
+  bool started_;
+  /*! \brief slot of the current batch */
+  size_t head_;
+};
+
+/*!
+ * \brief context of the prefetched batches, page locked memory when they are
+ *  copied to a GPU and pin_memory is set
+ */
+inline Context PrefetchContext(const PrefetcherParam &param) {
+#if MXNET_USE_CUDA
+  if (param.pin_memory) {
+    return Context::CPUPinned(param.device_type == Context::kGPU ? param.device_id : 0);
+  }
+#endif  // MXNET_USE_CUDA
+  return Context::CPU();
+}
+
+/*!
+ * \brief keeps a copy of every prefetched batch on the device given by the
+ *  parameters, so that a batch is copied as soon as it is produced instead of
+ *  when the training loop gets to it.
+ *
+ *  Each host batch of the ring has a batch on the device it is copied to.
+ *  Copies are engine operations, hence a host batch is refilled only after its
+ *  copy is done, and a device batch is overwritten only after the operations
+ *  reading its last content are done.
+ */
+class BatchStager {
+ public:
+  /*! \brief whether batches are copied */
+  inline bool enabled(void) const {
+    return enabled_;
+  }
+  inline void Init(const PrefetcherParam &param) {
+    enabled_ = param.device_type != 0;
+    if (enabled_) ctx_ = Context::Create(static_cast<Context::DeviceType>(param.device_type),
+                                         param.device_id);
+  }
+  /*!
+   * \brief push the copy of the arrays of a host batch to the device, the copy
+   *  waits for the pending writes to the host arrays. Thread safe.
+   */
+  inline void Stage(DataBatch *batch) {
+    DataBatch *staged;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::unique_ptr<DataBatch> &ptr = staged_[batch];
+      if (ptr == nullptr) {
+        ptr.reset(new DataBatch());
+        for (const NDArray &arr : batch->data) {
+          ptr->data.push_back(NDArray(arr.shape(), ctx_, false, arr.dtype()));
+        }
+      }
+      staged = ptr.get();
+    }
+    for (size_t i = 0; i < batch->data.size(); ++i) {
+      CopyFromTo(batch->data[i], &(staged->data[i]));
+    }
+  }
+  /*! \brief the device batch of a host batch that is loaded and staged */
+  inline DataBatch *Get(const DataBatch *batch) {
+    DataBatch *staged;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = staged_.find(batch);
+      CHECK(it != staged_.end()) << "batch is not staged";
+      staged = it->second.get();
+    }
+    staged->index = batch->index;
+    staged->num_batch_padd = batch->num_batch_padd;
+    return staged;
+  }
+
+ private:
+  bool enabled_ = false;
+  /*! \brief device the batches are copied to */
+  Context ctx_;
+  /*! \brief protects staged_, since batches are staged by the producer */
+  std::mutex mutex_;
+  /*! \brief device batch of each host batch */
+  std::unordered_map<const DataBatch*, std::unique_ptr<DataBatch> > staged_;
+};
+
 // iterator on image recordio
 class PrefetcherIter : public IIterator<DataBatch> {
  public:
   explicit PrefetcherIter(IIterator<TBlobBatch>* base)
-      : loader_(base), out_(nullptr) {
+      : loader_(base), out_(nullptr), value_(nullptr) {
   }
 
   ~PrefetcherIter() {
+    if (param_.use_engine) return;
     while (recycle_queue_.size() != 0) {
       DataBatch *batch = recycle_queue_.front();
       recycle_queue_.pop();
@@ -51,50 +251,46 @@ class PrefetcherIter : public IIterator<DataBatch> {
     const int kMaxPrefetchBuffer = 16;
     // init thread iter
     iter_.set_max_capacity(kMaxPrefetchBuffer);
+    stager_.Init(param_);
 
+    if (param_.use_engine) {
+      std::function<void(DataBatch *)> on_push = nullptr;
+      if (stager_.enabled()) {
+        on_push = [this](DataBatch *batch) { stager_.Stage(batch); };
+      }
+      engine_iter_.Init(param_.prefetch_buffer,
+                        [this](DataBatch **dptr) { return this->LoadBatch(dptr); },
+                        [this]() { loader_->BeforeFirst(); }, on_push);
+      return;
+    }
     iter_.Init([this](DataBatch **dptr) {
-        if (!loader_->Next()) return false;
-        const TBlobBatch& batch = loader_->Value();
-        if (*dptr == nullptr) {
-          // allocate databatch
-          *dptr = new DataBatch();
-          (*dptr)->num_batch_padd = batch.num_batch_padd;
-          (*dptr)->data.resize(batch.data.size());
-          (*dptr)->index.resize(batch.batch_size);
-          for (size_t i = 0; i < batch.data.size(); ++i) {
-            auto dtype = param_.dtype
-                             ? param_.dtype.value()
-                             : batch.data[i].type_flag_;
-            (*dptr)->data.at(i) = NDArray(batch.data[i].shape_,
-                                          Context::CPU(), false,
-                                          dtype);
-          }
-        }
-        CHECK(batch.data.size() == (*dptr)->data.size());
-        // copy data over
-        for (size_t i = 0; i < batch.data.size(); ++i) {
-          CHECK_EQ((*dptr)->data.at(i).shape(), batch.data[i].shape_);
-          MSHADOW_TYPE_SWITCH(batch.data[i].type_flag_, DType, {
-              mshadow::Copy(((*dptr)->data)[i].data().FlatTo2D<cpu, DType>(),
-                        batch.data[i].FlatTo2D<cpu, DType>());
-          });
-          (*dptr)->num_batch_padd = batch.num_batch_padd;
-        }
-        if (batch.inst_index) {
-          std::copy(batch.inst_index,
-                    batch.inst_index + batch.batch_size,
-                    (*dptr)->index.begin());
-        }
-       return true;
-      },
-      [this]() { loader_->BeforeFirst(); });
+        if (!this->LoadBatch(dptr)) return false;
+        // start the copy to the device right away, in the producer thread
+        if (stager_.enabled()) stager_.Stage(*dptr);
+        return true;
+      }, [this]() { loader_->BeforeFirst(); });
   }
 
   virtual void BeforeFirst(void) {
+    if (param_.use_engine) {
+      engine_iter_.BeforeFirst();
+      return;
+    }
     iter_.BeforeFirst();
   }
 
   virtual bool Next(void) {
+    bool ret = param_.use_engine ? engine_iter_.Next(&out_) : this->NextOnThread();
+    value_ = ret && stager_.enabled() ? stager_.Get(out_) : out_;
+    return ret;
+  }
+  virtual const DataBatch &Value(void) const {
+    return *value_;
+  }
+
+ protected:
+  /*! \brief get the next batch from the thread, recycling the oldest one */
+  inline bool NextOnThread(void) {
     if (out_ != nullptr) {
       recycle_queue_.push(out_); out_ = nullptr;
     }
@@ -110,11 +306,45 @@ class PrefetcherIter : public IIterator<DataBatch> {
     }
     return iter_.Next(&out_);
   }
-  virtual const DataBatch &Value(void) const {
-    return *out_;
+  /*!
+   * \brief read the next batch of the loader into *dptr, allocated on first use
+   * \return false at the end of the data
+   */
+  inline bool LoadBatch(DataBatch **dptr) {
+    if (!loader_->Next()) return false;
+    const TBlobBatch& batch = loader_->Value();
+    if (*dptr == nullptr) {
+      // allocate databatch
+      *dptr = new DataBatch();
+      (*dptr)->num_batch_padd = batch.num_batch_padd;
+      (*dptr)->data.resize(batch.data.size());
+      (*dptr)->index.resize(batch.batch_size);
+      for (size_t i = 0; i < batch.data.size(); ++i) {
+        auto dtype = param_.dtype
+                         ? param_.dtype.value()
+                         : batch.data[i].type_flag_;
+        (*dptr)->data.at(i) = NDArray(batch.data[i].shape_,
+                                      PrefetchContext(param_), false,
+                                      dtype);
+      }
+    }
+    CHECK(batch.data.size() == (*dptr)->data.size());
+    // copy data over
+    for (size_t i = 0; i < batch.data.size(); ++i) {
+      CHECK_EQ((*dptr)->data.at(i).shape(), batch.data[i].shape_);
+      MSHADOW_TYPE_SWITCH(batch.data[i].type_flag_, DType, {
+          mshadow::Copy(((*dptr)->data)[i].data().FlatTo2D<cpu, DType>(),
+                    batch.data[i].FlatTo2D<cpu, DType>());
+      });
+      (*dptr)->num_batch_padd = batch.num_batch_padd;
+    }
+    if (batch.inst_index) {
+      std::copy(batch.inst_index,
+                batch.inst_index + batch.batch_size,
+                (*dptr)->index.begin());
+    }
+    return true;
   }
-
- protected:
   /*! \brief prefetcher parameters */
   PrefetcherParam param_;
   /*! \brief internal batch loader */
@@ -123,10 +353,16 @@ class PrefetcherIter : public IIterator<DataBatch> {
  private:
   /*! \brief output data */
   DataBatch *out_;
+  /*! \brief batch given by Value, out_ or its copy on the device */
+  DataBatch *value_;
   /*! \brief queue to be recycled */
   std::queue<DataBatch*> recycle_queue_;
   /*! \brief backend thread */
   dmlc::ThreadedIter<DataBatch> iter_;
+  /*! \brief batches produced by the engine, if use_engine */
+  EngineIter engine_iter_;
+  /*! \brief copies of the batches on the device */
+  BatchStager stager_;
 };
 }  // namespace io
 }  // namespace mxnet
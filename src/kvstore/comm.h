@@ -10,6 +10,7 @@
 #include <vector>
 #include <tuple>
 #include "mxnet/ndarray.h"
+#include "../operator/tensor/elemwise_sum.h"
 namespace mxnet {
 namespace kvstore {
 /**
@@ -122,72 +123,19 @@ class CommCPU : public Comm {
   // reduce sum into val[0]
   inline void ReduceSumCPU(const std::vector<NDArray> &in_data) {
     MSHADOW_TYPE_SWITCH(in_data[0].dtype(), DType, {
-      std::vector<DType*> dptr(in_data.size());
+      std::vector<const DType*> dptr(in_data.size());
       for (size_t i = 0; i < in_data.size(); ++i) {
         TBlob data = in_data[i].data();
         CHECK(data.CheckContiguous());
         dptr[i] = data.FlatTo2D<cpu, DType>().dptr_;
       }
+      DType *out = in_data[0].data().FlatTo2D<cpu, DType>().dptr_;
       size_t total = in_data[0].shape().Size();
-      ReduceSumCPUImpl(dptr, total);
+      int nthread = total < bigarray_bound_ ? 1 : nthread_reduction_;
+      op::ElementwiseSumCPU(dptr, out, total, kWriteInplace, nthread);
     });
   }
 
-  template<typename DType>
-  inline static void ReduceSumCPU(
-      const std::vector<DType*> &dptr, size_t offset, index_t size) {
-    using namespace mshadow;  // NOLINT(*)
-    Tensor<cpu, 1, DType> in_0(dptr[0] + offset, Shape1(size));
-    for (size_t i = 1; i < dptr.size(); i+=4) {
-      switch (dptr.size() - i) {
-        case 1: {
-          Tensor<cpu, 1, DType> in_1(dptr[i] + offset, Shape1(size));
-          in_0 += in_1;
-          break;
-        }
-        case 2: {
-          Tensor<cpu, 1, DType> in_1(dptr[i] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_2(dptr[i+1] + offset, Shape1(size));
-          in_0 += in_1 + in_2;
-          break;
-        }
-        case 3: {
-          Tensor<cpu, 1, DType> in_1(dptr[i] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_2(dptr[i+1] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_3(dptr[i+2] + offset, Shape1(size));
-          in_0 += in_1 + in_2 + in_3;
-          break;
-        }
-        default: {
-          Tensor<cpu, 1, DType> in_1(dptr[i] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_2(dptr[i+1] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_3(dptr[i+2] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_4(dptr[i+3] + offset, Shape1(size));
-          in_0 += in_1 + in_2 + in_3 + in_4;
-          break;
-        }
-      }
-    }
-  }
-
-  template<typename DType>
-  inline void ReduceSumCPUImpl(std::vector<DType*> dptr, size_t total) {
-    const size_t step = std::min(bigarray_bound_, static_cast<size_t>(4 << 10));
-    long ntask = (total + step - 1) / step; // NOLINT(*)
-    if (total < bigarray_bound_ || nthread_reduction_ <= 1) {
-      ReduceSumCPU(dptr, 0, total);
-    } else {
-      #pragma omp parallel for schedule(static) num_threads(nthread_reduction_)
-      for (long j = 0; j < ntask; ++j) { // NOLINT(*)
-        size_t k = static_cast<size_t>(j);
-        size_t begin = std::min(k * step, total);
-        size_t end = std::min((k + 1) * step, total);
-        if (j == ntask - 1) CHECK_EQ(end, total);
-        ReduceSumCPU(dptr, begin, static_cast<index_t>(end - begin));
-      }
-    }
-  }
-
   /// \brief temporal space for pushing and pulling
   struct BufferEntry {
     /// \brief the merged value
@@ -132,6 +132,20 @@ class KVStoreDist : public KVStoreLocal {
     }
   }
 
+  void PushRowSparse(const std::vector<int>& keys,
+                     const std::vector<NDArray>& row_ids,
+                     const std::vector<NDArray>& values,
+                     int priority) override {
+    LOG(FATAL) << "row-sparse push is not supported by kvstore " << type_;
+  }
+
+  void PullRowSparse(const std::vector<int>& keys,
+                     const std::vector<NDArray>& row_ids,
+                     const std::vector<NDArray*>& values,
+                     int priority) override {
+    LOG(FATAL) << "row-sparse pull is not supported by kvstore " << type_;
+  }
+
   void set_updater(const Updater& updater) override {
     CHECK(updater) << "invalid updater";
     if (IsServerNode()) {
@@ -13,6 +13,7 @@
 #include <utility>
 #include <algorithm>
 #include "./comm.h"
+#include "../operator/tensor/indexing_op.h"
 
 namespace mxnet {
 namespace kvstore {
@@ -87,6 +88,64 @@ class KVStoreLocal : public KVStore {
     }
   }
 
+  void PushRowSparse(const std::vector<int>& keys,
+                     const std::vector<NDArray>& row_ids,
+                     const std::vector<NDArray>& values,
+                     int priority) override {
+    CHECK_EQ(keys.size(), row_ids.size());
+    std::vector<std::pair<NDArray, NDArray> > pairs(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      pairs[i] = std::make_pair(row_ids[i], values[i]);
+    }
+    std::vector<int> uniq_keys;
+    std::vector<std::vector<std::pair<NDArray, NDArray> > > grouped_vals;
+    GroupKVPairs(keys, pairs, &uniq_keys, &grouped_vals);
+
+    for (size_t i = 0; i < uniq_keys.size(); ++i) {
+      int key = uniq_keys[i];
+      NDArray& local = local_[key];
+      CHECK(!local.is_none()) << "key " << key << " has not been inited";
+      CHECK_EQ(local.shape().ndim(), 2U) << "row-sparse push needs a 2D value on key " << key;
+      NDArray merged_ids, merged_vals;
+      MergeRowSparse(grouped_vals[i], local.shape()[1], &merged_ids, &merged_vals, priority);
+      if (row_sparse_updater_ != nullptr) {
+        if (local.ctx().dev_mask() != cpu::kDevMask) {
+          merged_ids = merged_ids.Copy(local.ctx());
+          merged_vals = merged_vals.Copy(local.ctx());
+        }
+        row_sparse_updater_(key, merged_ids, merged_vals, &local);
+      } else {
+        AssignRows(merged_ids, merged_vals, &local, priority);
+      }
+    }
+  }
+
+  void PullRowSparse(const std::vector<int>& keys,
+                     const std::vector<NDArray>& row_ids,
+                     const std::vector<NDArray*>& values,
+                     int priority) override {
+    CHECK_EQ(keys.size(), row_ids.size());
+    CHECK_EQ(keys.size(), values.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      const NDArray& local = local_[keys[i]];
+      CHECK(!local.is_none()) << "key " << keys[i] << " has not been inited";
+      CHECK_EQ(local.ctx().dev_mask(), cpu::kDevMask)
+          << "row-sparse pull needs the value of key " << keys[i] << " on cpu";
+      NDArray* out = values[i];
+      CHECK_EQ(out->shape().ndim(), 2U);
+      CHECK_EQ(out->shape()[0], row_ids[i].shape().Size());
+      CHECK_EQ(out->shape()[1], local.shape()[1]);
+      NDArray ids = ToPinned(row_ids[i], priority);
+      if (out->ctx().dev_mask() == cpu::kDevMask) {
+        GatherRows(ids, local, out, priority);
+      } else {
+        NDArray buf(out->shape(), pinned_ctx_, false, out->dtype());
+        GatherRows(ids, local, &buf, priority);
+        CopyFromTo(buf, out, priority);
+      }
+    }
+  }
+
  protected:
   /**
    * \brief group values on keys
@@ -118,6 +177,121 @@ class KVStoreLocal : public KVStore {
       }
     }
   }
+  /**
+   * \brief copy src to the pinned context unless it is already on cpu
+   */
+  NDArray ToPinned(const NDArray& src, int priority) {
+    if (src.ctx().dev_mask() == cpu::kDevMask) return src;
+    NDArray buf(src.shape(), pinned_ctx_, false, src.dtype());
+    CopyFromTo(src, &buf, priority);
+    return buf;
+  }
+  /**
+   * \brief concatenate the row-sparse values pushed by several devices and sum
+   * the rows sharing an id, so that the updater sees every row only once
+   */
+  void MergeRowSparse(const std::vector<std::pair<NDArray, NDArray> >& src,
+                      index_t row_length, NDArray* merged_ids, NDArray* merged_vals,
+                      int priority) {
+    const int id_type = src[0].first.dtype();
+    const int val_type = src[0].second.dtype();
+    CHECK_NE(id_type, mshadow::kUint8) << "row ids cannot be uint8";
+    std::vector<NDArray> ids, vals;
+    std::vector<Engine::VarHandle> const_vars;
+    index_t num_rows = 0;
+    for (const auto& p : src) {
+      CHECK_EQ(p.first.dtype(), id_type) << "row ids of one key must have the same type";
+      CHECK_EQ(p.second.dtype(), val_type) << "values of one key must have the same type";
+      CHECK_EQ(p.second.shape().ndim(), 2U);
+      CHECK_EQ(p.second.shape()[1], row_length);
+      CHECK_EQ(p.first.shape().Size(), p.second.shape()[0]);
+      ids.push_back(ToPinned(p.first, priority));
+      vals.push_back(ToPinned(p.second, priority));
+      const_vars.push_back(ids.back().var());
+      const_vars.push_back(vals.back().var());
+      num_rows += p.second.shape()[0];
+    }
+    *merged_ids = NDArray(mshadow::Shape1(num_rows), pinned_ctx_, false, id_type);
+    *merged_vals = NDArray(mshadow::Shape2(num_rows, row_length), pinned_ctx_, false, val_type);
+    NDArray out_ids = *merged_ids, out_vals = *merged_vals;
+    Engine::Get()->PushSync([ids, vals, out_ids, out_vals, num_rows, row_length](RunContext) {
+        MSHADOW_TYPE_SWITCH(out_vals.dtype(), DType, {
+          MSHADOW_TYPE_SWITCH(out_ids.dtype(), IType, {
+            std::vector<IType> all_ids;
+            std::vector<DType> all_vals;
+            all_ids.reserve(num_rows);
+            all_vals.reserve(num_rows * row_length);
+            for (size_t i = 0; i < ids.size(); ++i) {
+              const IType* id = ids[i].data().dptr<IType>();
+              const DType* val = vals[i].data().dptr<DType>();
+              const index_t n = ids[i].shape().Size();
+              all_ids.insert(all_ids.end(), id, id + n);
+              all_vals.insert(all_vals.end(), val, val + n * row_length);
+            }
+            op::RowSparseMerge(all_ids.data(), all_vals.data(), num_rows, row_length, 0,
+                               out_ids.data().dptr<IType>(), out_vals.data().dptr<DType>());
+          });
+        });
+      }, Context::CPU(), const_vars, {out_ids.var(), out_vals.var()},
+      FnProperty::kCPUPrioritized, priority, PROFILER_MESSAGE("KVStoreMergeRowSparse"));
+  }
+  /**
+   * \brief dst[ids[i]] = vals[i] for every valid id
+   */
+  void AssignRows(const NDArray& ids, const NDArray& vals, NDArray* dst, int priority) {
+    CHECK_EQ(dst->ctx().dev_mask(), cpu::kDevMask)
+        << "row-sparse push without updater needs the stored value on cpu";
+    CHECK_EQ(vals.dtype(), dst->dtype());
+    NDArray out = *dst;
+    Engine::Get()->PushSync([ids, vals, out](RunContext) {
+        MSHADOW_TYPE_SWITCH(out.dtype(), DType, {
+          MSHADOW_TYPE_SWITCH(ids.dtype(), IType, {
+            const IType* id = ids.data().dptr<IType>();
+            const DType* src = vals.data().dptr<DType>();
+            DType* dptr = out.data().dptr<DType>();
+            const int num_ids = static_cast<int>(ids.shape().Size());
+            const index_t num_rows = out.shape()[0], row_length = out.shape()[1];
+            #pragma omp parallel for
+            for (int i = 0; i < num_ids; ++i) {
+              const int64_t row = static_cast<int64_t>(id[i]);
+              if (row < 0 || row >= static_cast<int64_t>(num_rows)) continue;
+              std::copy(src + i * row_length, src + (i + 1) * row_length,
+                        dptr + row * row_length);
+            }
+          });
+        });
+      }, Context::CPU(), {ids.var(), vals.var()}, {out.var()},
+      FnProperty::kCPUPrioritized, priority, PROFILER_MESSAGE("KVStoreAssignRows"));
+  }
+  /**
+   * \brief dst[i] = src[ids[i]] for every valid id, zeros otherwise
+   */
+  void GatherRows(const NDArray& ids, const NDArray& src, NDArray* dst, int priority) {
+    CHECK_EQ(src.dtype(), dst->dtype());
+    NDArray out = *dst;
+    Engine::Get()->PushSync([ids, src, out](RunContext) {
+        MSHADOW_TYPE_SWITCH(out.dtype(), DType, {
+          MSHADOW_TYPE_SWITCH(ids.dtype(), IType, {
+            const IType* id = ids.data().dptr<IType>();
+            const DType* sptr = src.data().dptr<DType>();
+            DType* dptr = out.data().dptr<DType>();
+            const int num_ids = static_cast<int>(ids.shape().Size());
+            const index_t num_rows = src.shape()[0], row_length = src.shape()[1];
+            #pragma omp parallel for
+            for (int i = 0; i < num_ids; ++i) {
+              const int64_t row = static_cast<int64_t>(id[i]);
+              DType* row_out = dptr + i * row_length;
+              if (row < 0 || row >= static_cast<int64_t>(num_rows)) {
+                std::fill(row_out, row_out + row_length, DType(0));
+              } else {
+                std::copy(sptr + row * row_length, sptr + (row + 1) * row_length, row_out);
+              }
+            }
+          });
+        });
+      }, Context::CPU(), {ids.var(), src.var()}, {out.var()},
+      FnProperty::kCPUPrioritized, priority, PROFILER_MESSAGE("KVStoreGatherRows"));
+  }
   /// reducer and broadcaster
   Comm* comm_;
   /// pinned context
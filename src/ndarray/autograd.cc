@@ -7,8 +7,11 @@
 #include <mxnet/operator.h>
 #include <mxnet/executor.h>
 #include <nnvm/pass_functions.h>
+#include <algorithm>
+#include <map>
 #include <unordered_set>
 #include <iostream>
+#include <sstream>
 #include "../executor/graph_executor.h"
 #include "./autograd.h"
 
@@ -49,7 +52,24 @@ nnvm::NodeEntry AGNodeEntry::nn_entry() const {
   return nnvm::NodeEntry{ag_node->nn_node, index, version};
 }
 
-AutogradRuntime::AutogradRuntime() {}
+AutogradRuntime::AutogradRuntime() {
+  engine_ref_ = Engine::_GetSharedRef();
+  storage_ref_ = Storage::_GetSharedRef();
+}
+
+AutogradRuntime::~AutogradRuntime() {
+  backward_cache_.clear();
+}
+
+/*! \brief append the shape, type and context of an array to a graph signature */
+inline void AppendSignature(const NDArray& arr, std::ostringstream *os) {
+  if (arr.is_none()) {
+    *os << "none;";
+    return;
+  }
+  *os << arr.shape() << ',' << arr.dtype() << ',' << arr.ctx().dev_type << ','
+      << arr.ctx().dev_id << ';';
+}
 
 void AutogradRuntime::MarkVariables(
     const std::vector<NDArray*>& variables,
@@ -130,6 +150,7 @@ AGNodePtr AutogradRuntime::RecordOp(const nnvm::Op* op,
 }
 
 void AutogradRuntime::ComputeGradient(const std::vector<NDArray>& outputs) {
+  static size_t cache_size = dmlc::GetEnv("MXNET_AUTOGRAD_CACHE_SIZE", 16);
   std::vector<AGNodeEntry> heads;
   Symbol sym;
   NodeEntryMap<NDArray> feed_dict;
@@ -145,7 +166,14 @@ void AutogradRuntime::ComputeGradient(const std::vector<NDArray>& outputs) {
   std::vector<NDArray> args, args_grad;
   std::vector<OpReqType> grad_reqs;
   std::unordered_map<const nnvm::Node*, std::shared_ptr<Operator>> saved_opr;
+  // the nodes in visiting order, and a signature of the structure of the graph
+  // and of the shapes, types and contexts of its arrays
+  std::vector<NodePtr> nodes;
+  std::unordered_map<const nnvm::Node*, size_t> node_pos;
+  std::ostringstream sig;
   AGDFSVisit(heads, [&](const AGNodePtr& n) {
+      node_pos[n->nn_node.get()] = nodes.size();
+      nodes.push_back(n->nn_node);
       if (n->opr != nullptr) {
         saved_opr.insert({n->nn_node.get(), n->opr});
       } else if (n->nn_node->is_variable()) {
@@ -156,18 +184,71 @@ void AutogradRuntime::ComputeGradient(const std::vector<NDArray>& outputs) {
       for (const auto& i : n->inputs) {
         feed_dict.insert({i.nn_entry(), i.ag_node->outputs[i.index]});
       }
+      if (n->nn_node->is_variable()) {
+        sig << "var" << n->grad_req << '(';
+        AppendSignature(n->outputs[0], &sig);
+        AppendSignature(n->out_grads[0], &sig);
+      } else {
+        sig << n->nn_node->op()->name << '{';
+        std::map<std::string, std::string> dict(n->nn_node->attrs.dict.begin(),
+                                                n->nn_node->attrs.dict.end());
+        for (const auto& kv : dict) {
+          sig << kv.first.size() << ':' << kv.first << kv.second.size() << ':' << kv.second;
+        }
+        sig << "}[";
+        for (const auto& i : n->inputs) {
+          sig << node_pos.at(i.ag_node->nn_node.get()) << ':' << i.index << ';';
+        }
+        sig << "](";
+        for (const auto& arr : n->outputs) AppendSignature(arr, &sig);
+      }
+      sig << ')';
     });
-
+  sig << "->";
+  for (const auto& i : heads) {
+    sig << node_pos.at(i.ag_node->nn_node.get()) << ':' << i.index << ';';
+  }
 
   if (args.size()) {
     std::map<std::string, Context> ctx_map;
     std::vector<NDArray> aux_states;
-    auto exec = new exec::GraphExecutor();
-    // (TODO) too hack here
-    exec->saved_opr_ = saved_opr;
-    exec->Init(sym, args[0].ctx(), ctx_map,
-               args, args_grad, grad_reqs,
-               aux_states, nullptr, feed_dict);
+    const std::string key = sig.str();
+    std::lock_guard<std::mutex> lock(backward_cache_mutex_);
+    std::shared_ptr<GraphExecutor> exec;
+    bool cached = cache_size != 0;
+    NodeEntryMap<NDArray> cached_feed_dict;
+    auto it = cache_size != 0 ? backward_cache_.find(key) : backward_cache_.end();
+    if (it != backward_cache_.end()) {
+      // the same graph was recorded before, bind the arrays of this recording
+      // to the nodes of the graph the executor was built from
+      const std::vector<NodePtr>& cached_nodes = it->second.nodes;
+      for (const auto& kv : feed_dict) {
+        const NodePtr& node = cached_nodes[node_pos.at(kv.first.node.get())];
+        cached_feed_dict.insert({NodeEntry{node, kv.first.index, kv.first.version}, kv.second});
+      }
+      NodeOperatorMap cached_opr;
+      for (const auto& kv : saved_opr) {
+        cached_opr.insert({cached_nodes[node_pos.at(kv.first)].get(), kv.second});
+      }
+      exec = it->second.exec;
+      exec->Rebind(args, args_grad, grad_reqs, cached_feed_dict, cached_opr);
+    } else {
+      exec = std::make_shared<GraphExecutor>();
+      // (TODO) too hack here
+      exec->saved_opr_ = saved_opr;
+      exec->Init(sym, args[0].ctx(), ctx_map,
+                 args, args_grad, grad_reqs,
+                 aux_states, nullptr, feed_dict);
+      if (cached) {
+        cached_feed_dict = feed_dict;
+        backward_cache_[key] = CachedBackward{exec, nodes};
+        backward_cache_keys_.push_back(key);
+        if (backward_cache_keys_.size() > cache_size) {
+          backward_cache_.erase(backward_cache_keys_.front());
+          backward_cache_keys_.pop_front();
+        }
+      }
+    }
 
     std::vector<NDArray> head_grads;
     head_grads.reserve(exec->head_grad_array_.size());
@@ -179,7 +260,8 @@ void AutogradRuntime::ComputeGradient(const std::vector<NDArray>& outputs) {
     }
 
     exec->Backward(head_grads);
-    delete exec;
+    // the cache keeps the graph and its memory, not the arrays of this recording
+    if (cached) exec->ReleaseBound(cached_feed_dict);
   }
 
   for (auto& i : heads) {
@@ -8,16 +8,26 @@
 
 #include <dmlc/logging.h>
 #include <mxnet/base.h>
+#include <mxnet/engine.h>
 #include <mxnet/ndarray.h>
+#include <mxnet/storage.h>
 #include <mxnet/op_attr_types.h>
 #include <nnvm/symbolic.h>
 #include <nnvm/op.h>
 #include <nnvm/graph.h>
 #include <vector>
 #include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_map>
 
 namespace mxnet {
+namespace exec {
+class GraphExecutor;
+}  // namespace exec
+
 namespace autograd {
 class AGNode {
  public:
@@ -50,6 +60,8 @@ class AGNode {
  */
 class AutogradRuntime {
  public:
+  /*! \brief release the cached executors before the engine. */
+  ~AutogradRuntime();
   /*! \brief turn on or turn off operator recording for autograd. */
   bool SetIsTraining(bool is_train) {
       bool old = is_train_;
@@ -100,8 +112,27 @@ class AutogradRuntime {
                      std::vector<NDArray>* p_inputs,
                      std::vector<NDArray>* p_outputs,
                      const std::shared_ptr<Operator>& opr);
+  /*!
+   * \brief a backward executor compiled for a recorded graph, reused when a
+   *  graph with the same structure, shapes and types is recorded again
+   */
+  struct CachedBackward {
+    /*! \brief the executor, bound to the arrays of the last use */
+    std::shared_ptr<exec::GraphExecutor> exec;
+    /*! \brief nodes of the graph the executor was built from, in visiting order */
+    std::vector<nnvm::NodePtr> nodes;
+  };
   /*! \brief AutogradRuntime singleton. */
   static AutogradRuntime* instance_;
+  /*! \brief compiled backward executors keyed by the signature of the graph */
+  std::unordered_map<std::string, CachedBackward> backward_cache_;
+  /*! \brief keys of backward_cache_ in insertion order, for eviction */
+  std::deque<std::string> backward_cache_keys_;
+  /*! \brief protects the backward cache */
+  std::mutex backward_cache_mutex_;
+  /*! \brief keep the engine and storage alive for the cached executors */
+  std::shared_ptr<Engine> engine_ref_;
+  std::shared_ptr<Storage> storage_ref_;
   /*! \brief indicate whether is training. */
 #if DMLC_CXX11_THREAD_LOCAL
   static thread_local bool is_train_;
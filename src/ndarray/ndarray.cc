@@ -10,7 +10,14 @@
 #include <mxnet/ndarray.h>
 #include <mxnet/resource.h>
 #include <mshadow/tensor.h>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 #include "./ndarray_function.h"
+#include "../io/columnar_format.h"
 
 #if MXNET_USE_OPENCV
 #include <opencv2/opencv.hpp>
@@ -660,33 +667,347 @@ bool NDArray::Load(dmlc::Stream *strm) {
 
 
 const uint64_t kMXAPINDArrayListMagic = 0x112;
+/*! \brief magic of lists whose arrays are stored by compressed chunks */
+const uint64_t kMXAPINDArrayListCompressedMagic = 0x113;
+/*! \brief magic of the checksums appended after a list */
+const uint64_t kMXAPINDArrayListChecksumMagic = 0x114;
+/*! \brief bytes of the chunks compressed in parallel */
+const size_t kSaveChunkBytes = 1 << 22;
 
-void NDArray::Save(dmlc::Stream* fo,
-                   const std::vector<NDArray>& data,
-                   const std::vector<std::string>& names) {
-  uint64_t header = kMXAPINDArrayListMagic, reserved = 0;
+namespace {
+/*! \brief CRC-32 (IEEE 802.3) of size bytes */
+uint32_t CRC32(const void *data, size_t size) {
+  static const std::vector<uint32_t> table = []() {
+    std::vector<uint32_t> t(256);
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+      t[i] = c;
+    }
+    return t;
+  }();
+  const unsigned char *p = static_cast<const unsigned char*>(data);
+  uint32_t crc = 0xFFFFFFFFU;
+  for (size_t i = 0; i < size; ++i) crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+  return crc ^ 0xFFFFFFFFU;
+}
+
+/*! \brief bytes of the data of a CPU array */
+inline size_t NumBytes(const TBlob &blob) {
+  return blob.Size() * mshadow::mshadow_sizeof(blob.type_flag_);
+}
+
+/*!
+ * \brief copy the arrays to CPU through the engine, the copies only read them.
+ *  The copies of GPU arrays go to pinned memory.
+ * \param copy_cpu whether to also copy the CPU arrays, so that they can be
+ *  written while they are modified
+ */
+std::vector<NDArray> SnapshotToCPU(const std::vector<NDArray> &data, bool copy_cpu) {
+  std::vector<NDArray> ret(data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    const NDArray &arr = data[i];
+    if (arr.is_none()) continue;
+    if (arr.ctx().dev_mask() == cpu::kDevMask && !copy_cpu) {
+      ret[i] = arr;
+      continue;
+    }
+#if MXNET_USE_CUDA
+    Context ctx = arr.ctx().dev_mask() == gpu::kDevMask ? Context::CPUPinned(0) : Context::CPU();
+#else
+    Context ctx = Context::CPU();
+#endif
+    ret[i] = NDArray(arr.shape(), ctx, false, arr.dtype());
+    CopyFromTo(arr, &ret[i]);
+  }
+  return ret;
+}
+
+/*! \brief a chunk of an array, compressed or decompressed in parallel */
+struct SaveChunk {
+  size_t array;
+  size_t begin, count;
+  std::string packed;
+};
+
+/*! \brief cut the arrays into chunks of kSaveChunkBytes */
+std::vector<SaveChunk> MakeChunks(const std::vector<NDArray> &data) {
+  std::vector<SaveChunk> chunks;
+  for (size_t i = 0; i < data.size(); ++i) {
+    if (data[i].is_none()) continue;
+    const size_t elem_size = mshadow::mshadow_sizeof(data[i].dtype());
+    const size_t step = std::max(kSaveChunkBytes / elem_size, static_cast<size_t>(1));
+    const size_t size = data[i].shape().Size();
+    for (size_t begin = 0; begin < size; begin += step) {
+      chunks.push_back(SaveChunk{i, begin, std::min(step, size - begin), std::string()});
+    }
+  }
+  return chunks;
+}
+
+/*!
+ * \brief write a list of arrays, ready on CPU, followed by their checksums.
+ *  Without compression the list is laid out as by NDArray::Save of each array,
+ *  older versions read it and ignore the checksums.
+ * \param ctxs the contexts the arrays are loaded to
+ */
+void WriteList(dmlc::Stream *fo, const std::vector<NDArray> &data,
+               const std::vector<Context> &ctxs, const std::vector<std::string> &names,
+               bool compress) {
+  std::vector<uint32_t> checksums(data.size(), 0);
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (long i = 0; i < static_cast<long>(data.size()); ++i) {  // NOLINT(*)
+    if (data[i].is_none()) continue;
+    const TBlob blob = data[i].data();
+    checksums[i] = CRC32(blob.dptr_, NumBytes(blob));
+  }
+  std::vector<SaveChunk> chunks;
+  if (compress) {
+    chunks = MakeChunks(data);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (long c = 0; c < static_cast<long>(chunks.size()); ++c) {  // NOLINT(*)
+      SaveChunk &chunk = chunks[c];
+      const TBlob blob = data[chunk.array].data();
+      const size_t elem_size = mshadow::mshadow_sizeof(blob.type_flag_);
+      const char *src = static_cast<const char*>(blob.dptr_) + chunk.begin * elem_size;
+      io::columnar::ShuffleRLEEncode(src, chunk.count, elem_size, &chunk.packed);
+      // a chunk that does not get smaller is stored as is
+      if (chunk.packed.size() >= chunk.count * elem_size) chunk.packed.clear();
+    }
+  }
+  uint64_t header = compress ? kMXAPINDArrayListCompressedMagic : kMXAPINDArrayListMagic;
+  uint64_t reserved = 0, num_arrays = data.size();
   fo->Write(&header, sizeof(header));
   fo->Write(&reserved, sizeof(reserved));
-  fo->Write(data);
+  fo->Write(&num_arrays, sizeof(num_arrays));
+  size_t next_chunk = 0;
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i].shape().Save(fo);
+    if (data[i].is_none()) continue;
+    ctxs[i].Save(fo);
+    const TBlob blob = data[i].data();
+    CHECK(blob.CheckContiguous());
+    int32_t type_flag = blob.type_flag_;
+    fo->Write(&type_flag, sizeof(type_flag));
+    if (!compress) {
+      fo->Write(blob.dptr_, NumBytes(blob));
+      continue;
+    }
+    const size_t elem_size = mshadow::mshadow_sizeof(type_flag);
+    size_t end_chunk = next_chunk;
+    std::vector<uint64_t> sizes;
+    for (; end_chunk < chunks.size() && chunks[end_chunk].array == i; ++end_chunk) {
+      const SaveChunk &chunk = chunks[end_chunk];
+      sizes.push_back(chunk.packed.empty() ? chunk.count * elem_size : chunk.packed.size());
+    }
+    fo->Write(sizes);
+    for (; next_chunk < end_chunk; ++next_chunk) {
+      const SaveChunk &chunk = chunks[next_chunk];
+      if (chunk.packed.empty()) {
+        fo->Write(static_cast<const char*>(blob.dptr_) + chunk.begin * elem_size,
+                  chunk.count * elem_size);
+      } else {
+        fo->Write(chunk.packed.data(), chunk.packed.size());
+      }
+    }
+  }
   fo->Write(names);
+  uint64_t checksum_magic = kMXAPINDArrayListChecksumMagic;
+  fo->Write(&checksum_magic, sizeof(checksum_magic));
+  fo->Write(checksums);
+}
+
+/*! \brief the contexts of the arrays */
+std::vector<Context> GetContexts(const std::vector<NDArray> &data) {
+  std::vector<Context> ctxs(data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    if (!data[i].is_none()) ctxs[i] = data[i].ctx();
+  }
+  return ctxs;
+}
+}  // namespace
+
+void NDArray::Save(dmlc::Stream* fo,
+                   const std::vector<NDArray>& data,
+                   const std::vector<std::string>& names) {
+  // stage all the arrays before waiting for any of them
+  std::vector<NDArray> staged = SnapshotToCPU(data, false);
+  for (const NDArray &arr : staged) {
+    if (!arr.is_none()) arr.WaitToRead();
+  }
+  WriteList(fo, staged, GetContexts(data), names, false);
+}
+
+namespace {
+/*! \brief errors of the background saves not reported yet */
+std::mutex background_save_mutex;
+std::vector<std::string> background_save_errors;
+
+void AddBackgroundSaveError(const std::string &fname, const char *what) {
+  std::lock_guard<std::mutex> lock(background_save_mutex);
+  background_save_errors.push_back("Failed to save " + fname + " in background: " + what);
+}
+}  // namespace
+
+void NDArray::CheckBackgroundSaves() {
+  std::vector<std::string> errors;
+  {
+    std::lock_guard<std::mutex> lock(background_save_mutex);
+    errors.swap(background_save_errors);
+  }
+  if (errors.empty()) return;
+  std::string msg = errors[0];
+  for (size_t i = 1; i < errors.size(); ++i) msg += "\n" + errors[i];
+  LOG(FATAL) << msg;
+}
+
+void NDArray::Save(const std::string& fname,
+                   const std::vector<NDArray>& data,
+                   const std::vector<std::string>& names,
+                   bool compress, bool background) {
+  CheckBackgroundSaves();
+  std::vector<NDArray> staged = SnapshotToCPU(data, background);
+  std::vector<Context> ctxs = GetContexts(data);
+  if (!background) {
+    for (const NDArray &arr : staged) {
+      if (!arr.is_none()) arr.WaitToRead();
+    }
+    std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(fname.c_str(), "w"));
+    WriteList(fo.get(), staged, ctxs, names, compress);
+    return;
+  }
+  std::vector<Engine::VarHandle> const_vars;
+  for (const NDArray &arr : staged) {
+    if (!arr.is_none()) const_vars.push_back(arr.var());
+  }
+  // the write is an engine operation, so that WaitForAll waits for it, but it
+  // runs on its own thread instead of holding an engine worker
+  Engine::Get()->PushAsync(
+    [staged, ctxs, names, fname, compress](RunContext rctx,
+                                            Engine::CallbackOnComplete on_complete) {
+      std::thread([staged, ctxs, names, fname, compress, on_complete]() {
+          try {
+            std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(fname.c_str(), "w"));
+            WriteList(fo.get(), staged, ctxs, names, compress);
+          } catch (const std::exception &e) {
+            AddBackgroundSaveError(fname, e.what());
+          } catch (...) {
+            AddBackgroundSaveError(fname, "unknown error");
+          }
+          on_complete();
+        }).detach();
+    }, Context::CPU(), const_vars, {},
+    FnProperty::kNormal, 0, PROFILER_MESSAGE("NDArraySaveBackground"));
 }
 
 void NDArray::Load(dmlc::Stream* fi,
                    std::vector<NDArray>* data,
                    std::vector<std::string>* keys) {
-  uint64_t header, reserved;
+  uint64_t header, reserved, num_arrays;
   CHECK(fi->Read(&header))
       << "Invalid NDArray file format";
   CHECK(fi->Read(&reserved))
       << "Invalid NDArray file format";
-  CHECK(header == kMXAPINDArrayListMagic)
+  CHECK(header == kMXAPINDArrayListMagic || header == kMXAPINDArrayListCompressedMagic)
       << "Invalid NDArray file format";
-  CHECK(fi->Read(data))
+  const bool compressed = header == kMXAPINDArrayListCompressedMagic;
+  CHECK(fi->Read(&num_arrays))
       << "Invalid NDArray file format";
+  // the arrays are loaded into CPU, checked, then copied to their contexts
+  std::vector<NDArray> cpu_data(num_arrays);
+  std::vector<Context> ctxs(num_arrays);
+  std::vector<SaveChunk> chunks;
+  for (size_t i = 0; i < num_arrays; ++i) {
+    TShape shape;
+    CHECK(shape.Load(fi)) << "Invalid NDArray file format";
+    if (shape.ndim() == 0) continue;
+    CHECK(ctxs[i].Load(fi)) << "Invalid NDArray file format";
+    int32_t type_flag;
+    CHECK_EQ(fi->Read(&type_flag, sizeof(type_flag)), sizeof(type_flag))
+        << "Invalid NDArray file format";
+    cpu_data[i] = NDArray(shape, Context::CPU(), false, type_flag);
+    const TBlob blob = cpu_data[i].data();
+    char *dptr = static_cast<char*>(blob.dptr_);
+    if (!compressed) {
+      CHECK_EQ(fi->Read(dptr, NumBytes(blob)), NumBytes(blob))
+          << "Invalid NDArray file format";
+      continue;
+    }
+    std::vector<uint64_t> sizes;
+    CHECK(fi->Read(&sizes)) << "Invalid NDArray file format";
+    const size_t elem_size = mshadow::mshadow_sizeof(type_flag);
+    const size_t step = std::max(kSaveChunkBytes / elem_size, static_cast<size_t>(1));
+    CHECK_EQ(sizes.size(), (shape.Size() + step - 1) / step) << "Invalid NDArray file format";
+    for (size_t c = 0; c < sizes.size(); ++c) {
+      SaveChunk chunk{i, c * step, std::min(step, shape.Size() - c * step), std::string()};
+      CHECK_LE(sizes[c], chunk.count * elem_size)
+          << "NDArray " << i << " is corrupted, invalid compressed chunk size";
+      if (sizes[c] == chunk.count * elem_size) {
+        CHECK_EQ(fi->Read(dptr + chunk.begin * elem_size, sizes[c]), sizes[c])
+            << "Invalid NDArray file format";
+      } else {
+        chunk.packed.resize(sizes[c]);
+        CHECK_EQ(fi->Read(&chunk.packed[0], sizes[c]), sizes[c])
+            << "Invalid NDArray file format";
+        chunks.push_back(std::move(chunk));
+      }
+    }
+  }
   CHECK(fi->Read(keys))
       << "Invalid NDArray file format";
-  CHECK(keys->size() == 0 || keys->size() == data->size())
+  CHECK(keys->size() == 0 || keys->size() == num_arrays)
       << "Invalid NDArray file format";
+  auto array_name = [keys](size_t i) {
+    return keys->size() != 0 ? (*keys)[i] : std::to_string(i);
+  };
+  // errors cannot leave the parallel region, they are checked after it
+  std::vector<int> decoded(chunks.size(), 1);
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (long c = 0; c < static_cast<long>(chunks.size()); ++c) {  // NOLINT(*)
+    const SaveChunk &chunk = chunks[c];
+    const TBlob blob = cpu_data[chunk.array].data();
+    const size_t elem_size = mshadow::mshadow_sizeof(blob.type_flag_);
+    std::vector<char> buf(chunk.count * elem_size);
+    try {
+      io::columnar::ShuffleRLEDecode(chunk.packed.data(), chunk.packed.size(), chunk.count,
+                                     elem_size, buf.data(),
+                                     static_cast<char*>(blob.dptr_) + chunk.begin * elem_size);
+    } catch (const dmlc::Error &) {
+      decoded[c] = 0;
+    }
+  }
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    CHECK(decoded[c]) << "NDArray " << array_name(chunks[c].array)
+                      << " is corrupted, its compressed data cannot be decoded";
+  }
+  // files saved by older versions end here
+  uint64_t checksum_magic;
+  if (fi->Read(&checksum_magic, sizeof(checksum_magic)) == sizeof(checksum_magic)) {
+    std::vector<uint32_t> checksums;
+    CHECK(checksum_magic == kMXAPINDArrayListChecksumMagic && fi->Read(&checksums) &&
+          checksums.size() == num_arrays) << "Invalid NDArray file format";
+    std::vector<int> valid(num_arrays, 1);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (long i = 0; i < static_cast<long>(num_arrays); ++i) {  // NOLINT(*)
+      if (cpu_data[i].is_none()) continue;
+      const TBlob blob = cpu_data[i].data();
+      valid[i] = CRC32(blob.dptr_, NumBytes(blob)) == checksums[i];
+    }
+    for (size_t i = 0; i < num_arrays; ++i) {
+      CHECK(valid[i]) << "Checksum mismatch of NDArray " << array_name(i)
+                      << ", the file is corrupted";
+    }
+  }
+  data->resize(num_arrays);
+  for (size_t i = 0; i < num_arrays; ++i) {
+#if MXNET_USE_CUDA
+    if (!cpu_data[i].is_none() && ctxs[i].dev_mask() != cpu::kDevMask) {
+      (*data)[i] = cpu_data[i].Copy(ctxs[i]);
+      continue;
+    }
+#endif
+    (*data)[i] = std::move(cpu_data[i]);
+  }
 }
 
 NDArray NDArray::Copy(Context ctx) const {
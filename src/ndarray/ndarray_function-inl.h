@@ -356,6 +356,8 @@ void Eval<DEVICE>(const real_t &rhs, TBlob *ret, RunContext ctx) {
   });
 }
 
+// the CPU version is in ndarray_function.cc
+#if defined(__HIPCC__)
 template<>
 void ElementwiseSum<DEVICE>(const std::vector<TBlob> source,
                             TBlob *dst,
@@ -404,6 +406,7 @@ void ElementwiseSum<DEVICE>(const std::vector<TBlob> source,
     }
   });
 }
+#endif  // defined(__HIPCC__)
 
 template <>
 void EvalBroadcast<DEVICE>(TBlob const& src, TBlob* ret, int size, RunContext ctx) {
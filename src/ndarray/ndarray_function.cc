@@ -7,6 +7,7 @@
 // this will be invoked by gcc and compile CPU version
 #include "./ndarray_function.h"
 #include "./ndarray_function-inl.h"
+#include "../operator/tensor/elemwise_sum.h"
 
 namespace mxnet {
 namespace ndarray {
@@ -26,5 +27,20 @@ void Copy<cpu, cpu>(const TBlob &from, TBlob *to,
     }
   })
 }
+
+template<>
+void ElementwiseSum<cpu>(const std::vector<TBlob> source,
+                         TBlob *dst,
+                         RunContext ctx) {
+  for (size_t i = 1; i < source.size(); ++i) {
+    CHECK_EQ(source[i].type_flag_, dst->type_flag_)
+      << "Only support input/output with the same data type";
+  }
+  MSHADOW_TYPE_SWITCH(dst->type_flag_, DType, {
+    std::vector<const DType*> in(source.size());
+    for (size_t i = 0; i < source.size(); ++i) in[i] = source[i].dptr<DType>();
+    op::ElementwiseSumCPU(in, dst->dptr<DType>(), dst->Size(), kWriteTo);
+  });
+}
 }  // namespace ndarray
 }  // namespace mxnet
@@ -36,6 +36,21 @@ struct dequantize {
   }
 };
 
+/*!
+ * \brief int32 accumulators of the quantized layers are symmetric, [-R, R]
+ *  maps onto [-INT32_MAX, INT32_MAX]. The product is done in double, float
+ *  cannot hold int32 values exactly.
+ */
+struct dequantize_int32 {
+  template<typename DstDType>
+  MSHADOW_XINLINE static void Map(int i, DstDType *out, const int32_t *in,
+                                  const float *imin_range, const float *imax_range) {
+    const double range = fmax(fabs(static_cast<double>(*imin_range)),
+                              fabs(static_cast<double>(*imax_range)));
+    out[i] = static_cast<DstDType>(static_cast<double>(in[i]) * (range / 2147483647.0));
+  }
+};
+
 template<typename xpu>
 void DequantizeCompute(const nnvm::NodeAttrs& attrs,
                      const OpContext& ctx,
@@ -47,6 +62,13 @@ void DequantizeCompute(const nnvm::NodeAttrs& attrs,
   Stream<xpu> *s = ctx.get_stream<xpu>();
 
   const DequantizeParam& param = nnvm::get<DequantizeParam>(attrs.parsed);
+  if (inputs[0].type_flag_ == mshadow::kInt32) {
+    MSHADOW_TYPE_SWITCH(outputs[0].type_flag_, DstDType, {
+      Kernel<dequantize_int32, xpu>::Launch(s, outputs[0].Size(), outputs[0].dptr<DstDType>(),
+        inputs[0].dptr<int32_t>(), inputs[1].dptr<float>(), inputs[2].dptr<float>());
+    });
+    return;
+  }
   MSHADOW_TYPE_SWITCH(outputs[0].type_flag_, DstDType, {
   MSHADOW_TYPE_SWITCH(inputs[0].type_flag_, SrcDType, {
     double min_limit = static_cast<double>(std::numeric_limits<SrcDType>::min());
@@ -84,8 +106,8 @@ inline bool DequantizeType(const nnvm::NodeAttrs& attrs,
   const DequantizeParam& param = nnvm::get<DequantizeParam>(attrs.parsed);
   CHECK_EQ(in_attrs->size(), 3U);
   CHECK_EQ(out_attrs->size(), 1U);
-  CHECK_EQ((*in_attrs)[0], mshadow::kUint8)
-    << "`dequantize` only supports uint8 input for now";
+  CHECK((*in_attrs)[0] == mshadow::kUint8 || (*in_attrs)[0] == mshadow::kInt32)
+    << "`dequantize` only supports uint8 and int32 input for now";
   CHECK_EQ((*in_attrs)[1], mshadow::kFloat32)
     << "the second input of `dequantize` should be a tensor with type of float";
   CHECK_EQ((*in_attrs)[2], mshadow::kFloat32)
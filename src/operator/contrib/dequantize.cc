@@ -19,6 +19,10 @@ Each value of the tensor will undergo the following:
 `out[i] = min_range + (in[i] * (max_range - min_range) / range(INPUT_TYPE))`
 
 here `range(T) = numeric_limits<T>::max() - numeric_limits<T>::min()`
+
+int32 input, the output of the quantized layers, is symmetric:
+
+`out[i] = in[i] * max(abs(min_range), abs(max_range)) / numeric_limits<int32>::max()`
 )code" ADD_FILELINE)
 .set_attr_parser(ParamParser<DequantizeParam>)
 .set_num_inputs(3)
@@ -27,7 +31,7 @@ here `range(T) = numeric_limits<T>::max() - numeric_limits<T>::min()`
 .set_attr<nnvm::FInferType>("FInferType", DequantizeType)
 .set_attr<FCompute>("FCompute<cpu>", DequantizeCompute<cpu>)
 .set_attr<nnvm::FGradient>("FGradient", ElemwiseGradUseNone{"_dequantize"})
-.add_argument("input", "NDArray-or-Symbol", "A ndarray/symbol of type `uint8`")
+.add_argument("input", "NDArray-or-Symbol", "A ndarray/symbol of type `uint8` or `int32`")
 .add_argument("min_range", "NDArray-or-Symbol", "The minimum scalar value "
   "possibly produced for the input")
 .add_argument("max_range", "NDArray-or-Symbol", "The maximum scalar value "
@@ -0,0 +1,137 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file normalize_image-inl.h
+ * \brief cast, normalize and transpose a batch of images in one pass
+ */
+#ifndef MXNET_OPERATOR_CONTRIB_NORMALIZE_IMAGE_INL_H_
+#define MXNET_OPERATOR_CONTRIB_NORMALIZE_IMAGE_INL_H_
+
+#include <mxnet/operator_util.h>
+#include <vector>
+#include "../elemwise_op_common.h"
+#include "../mxnet_op.h"
+#include "../operator_common.h"
+
+namespace mxnet {
+namespace op {
+
+struct NormalizeImageParam : public dmlc::Parameter<NormalizeImageParam> {
+  nnvm::Tuple<float> mean;
+  nnvm::Tuple<float> std;
+  int in_layout;
+  int dtype;
+  DMLC_DECLARE_PARAMETER(NormalizeImageParam) {
+    DMLC_DECLARE_FIELD(mean).set_default({0.0f})
+    .describe("Mean subtracted from each channel, either one value for all channels "
+              "or one per channel.");
+    DMLC_DECLARE_FIELD(std).set_default({1.0f})
+    .describe("Standard deviation each channel is divided by, either one value for "
+              "all channels or one per channel.");
+    DMLC_DECLARE_FIELD(in_layout).set_default(mshadow::kNHWC)
+    .add_enum("NCHW", mshadow::kNCHW)
+    .add_enum("NHWC", mshadow::kNHWC)
+    .describe("Layout of the input batch. The output is always NCHW.");
+    DMLC_DECLARE_FIELD(dtype).set_default(mshadow::kFloat32)
+    .add_enum("float32", mshadow::kFloat32)
+    .add_enum("float64", mshadow::kFloat64)
+    .add_enum("float16", mshadow::kFloat16)
+    .describe("Output data type.");
+  }
+};
+
+/*! \brief per channel coefficients, passed to the kernel by value */
+struct NormalizeImageCoef {
+  static const int kMaxChannel = 4;
+  float mean[kMaxChannel];
+  float inv_std[kMaxChannel];
+};
+
+template<int in_layout>
+struct normalize_image {
+  // i is the index in the NCHW output
+  template<typename DType, typename IType>
+  MSHADOW_XINLINE static void Map(int i, DType *out, const IType *in,
+                                  const NormalizeImageCoef coef,
+                                  const int channel, const int height, const int width) {
+    const int c = (i / (height * width)) % channel;
+    int j = i;
+    if (in_layout == mshadow::kNHWC) {
+      const int hw = i % (height * width);
+      const int n = i / (channel * height * width);
+      j = (n * height * width + hw) * channel + c;
+    }
+    out[i] = DType((static_cast<float>(in[j]) - coef.mean[c]) * coef.inv_std[c]);
+  }
+};
+
+template<typename xpu>
+void NormalizeImageCompute(const nnvm::NodeAttrs& attrs,
+                           const OpContext& ctx,
+                           const std::vector<TBlob>& inputs,
+                           const std::vector<OpReqType>& req,
+                           const std::vector<TBlob>& outputs) {
+  using namespace mshadow;
+  using namespace mxnet_op;
+  CHECK_EQ(req[0], kWriteTo) << "normalize_image only supports kWriteTo";
+  Stream<xpu> *s = ctx.get_stream<xpu>();
+  const NormalizeImageParam& param = nnvm::get<NormalizeImageParam>(attrs.parsed);
+  const TShape& oshape = outputs[0].shape_;
+  const int channel = oshape[1];
+  NormalizeImageCoef coef;
+  for (int c = 0; c < channel; ++c) {
+    coef.mean[c] = param.mean[param.mean.ndim() == 1 ? 0 : c];
+    coef.inv_std[c] = 1.0f / param.std[param.std.ndim() == 1 ? 0 : c];
+  }
+  MSHADOW_REAL_TYPE_SWITCH(outputs[0].type_flag_, DType, {
+    MSHADOW_TYPE_SWITCH(inputs[0].type_flag_, IType, {
+      if (param.in_layout == kNHWC) {
+        Kernel<normalize_image<kNHWC>, xpu>::Launch(s, outputs[0].Size(),
+          outputs[0].dptr<DType>(), inputs[0].dptr<IType>(), coef,
+          channel, static_cast<int>(oshape[2]), static_cast<int>(oshape[3]));
+      } else {
+        Kernel<normalize_image<kNCHW>, xpu>::Launch(s, outputs[0].Size(),
+          outputs[0].dptr<DType>(), inputs[0].dptr<IType>(), coef,
+          channel, static_cast<int>(oshape[2]), static_cast<int>(oshape[3]));
+      }
+    });
+  });
+}
+
+inline bool NormalizeImageShape(const nnvm::NodeAttrs& attrs,
+                                std::vector<TShape> *in_attrs,
+                                std::vector<TShape> *out_attrs) {
+  const NormalizeImageParam& param = nnvm::get<NormalizeImageParam>(attrs.parsed);
+  CHECK_EQ(in_attrs->size(), 1U);
+  CHECK_EQ(out_attrs->size(), 1U);
+  const TShape& ishape = in_attrs->at(0);
+  if (ishape.ndim() == 0) return false;
+  CHECK_EQ(ishape.ndim(), 4U)
+    << "normalize_image expects a batch of images, got shape " << ishape;
+  TShape oshape = ishape;
+  if (param.in_layout == mshadow::kNHWC) {
+    oshape = mshadow::Shape4(ishape[0], ishape[3], ishape[1], ishape[2]);
+  }
+  const index_t channel = oshape[1];
+  CHECK_LE(channel, static_cast<index_t>(NormalizeImageCoef::kMaxChannel))
+    << "normalize_image supports up to " << NormalizeImageCoef::kMaxChannel << " channels";
+  CHECK(param.mean.ndim() == 1 || param.mean.ndim() == channel)
+    << "mean must have 1 or " << channel << " values";
+  CHECK(param.std.ndim() == 1 || param.std.ndim() == channel)
+    << "std must have 1 or " << channel << " values";
+  SHAPE_ASSIGN_CHECK(*out_attrs, 0, oshape);
+  return true;
+}
+
+inline bool NormalizeImageType(const nnvm::NodeAttrs& attrs,
+                               std::vector<int> *in_attrs,
+                               std::vector<int> *out_attrs) {
+  const NormalizeImageParam& param = nnvm::get<NormalizeImageParam>(attrs.parsed);
+  CHECK_EQ(in_attrs->size(), 1U);
+  CHECK_EQ(out_attrs->size(), 1U);
+  TYPE_ASSIGN_CHECK(*out_attrs, 0, param.dtype);
+  return (*in_attrs)[0] != -1;
+}
+
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_CONTRIB_NORMALIZE_IMAGE_INL_H_
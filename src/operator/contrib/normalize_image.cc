@@ -0,0 +1,40 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file normalize_image.cc
+ * \brief
+ */
+#include "./normalize_image-inl.h"
+
+namespace mxnet {
+namespace op {
+DMLC_REGISTER_PARAMETER(NormalizeImageParam);
+
+NNVM_REGISTER_OP(_contrib_normalize_image)
+.describe(R"code(Casts, normalizes and transposes a batch of images in one pass.
+
+The input is typically the ``uint8`` batch of ``ImageRecordUInt8Iter`` with
+``layout='NHWC'``. Used as the first operator of the network, the conversion
+to floating point runs on the training device, so the host only decodes and
+copies raw pixels. For a NHWC input the output has shape ``(N, C, H, W)`` and::
+
+  out[n, c, h, w] = (float(data[n, h, w, c]) - mean[c]) / std[c]
+
+Examples::
+
+  x = [[[[0, 255]]]]    // shape (1, 1, 1, 2), NHWC with 2 channels
+
+  normalize_image(x, mean=(0, 127.5), std=(1, 127.5)) = [[[[0.]], [[1.]]]]
+
+)code" ADD_FILELINE)
+.set_attr_parser(ParamParser<NormalizeImageParam>)
+.set_num_inputs(1)
+.set_num_outputs(1)
+.set_attr<nnvm::FInferShape>("FInferShape", NormalizeImageShape)
+.set_attr<nnvm::FInferType>("FInferType", NormalizeImageType)
+.set_attr<FCompute>("FCompute<cpu>", NormalizeImageCompute<cpu>)
+.set_attr<nnvm::FGradient>("FGradient", MakeZeroGradNodes)
+.add_argument("data", "NDArray-or-Symbol", "A batch of images")
+.add_arguments(NormalizeImageParam::__FIELDS__());
+
+}  // namespace op
+}  // namespace mxnet
@@ -0,0 +1,15 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file normalize_image.cu
+ * \brief
+ */
+#include "./normalize_image-inl.h"
+
+namespace mxnet {
+namespace op {
+
+NNVM_REGISTER_OP(_contrib_normalize_image)
+.set_attr<FCompute>("FCompute<gpu>", NormalizeImageCompute<gpu>);
+
+}  // namespace op
+}  // namespace mxnet
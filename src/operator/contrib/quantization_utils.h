@@ -0,0 +1,166 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file quantization_utils.h
+ * \brief common helpers of the quantized operators
+ */
+#ifndef MXNET_OPERATOR_CONTRIB_QUANTIZATION_UTILS_H_
+#define MXNET_OPERATOR_CONTRIB_QUANTIZATION_UTILS_H_
+
+#include <mxnet/base.h>
+#if MSHADOW_USE_MKL
+#include <mkl.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include "../operator_common.h"
+
+namespace mxnet {
+namespace op {
+
+/*!
+ * \brief affine mapping of a uint8 tensor produced by `_contrib_quantize`:
+ *  real = scale * (q - zero_point). The zero point is rounded to an integer
+ *  so that real zero, and therefore padding, is exactly representable.
+ */
+struct QuantizedRange {
+  float scale;
+  int32_t zero_point;
+
+  QuantizedRange(float min_range, float max_range) {
+    const float kLimit = std::numeric_limits<uint8_t>::max();
+    scale = (max_range - min_range) / kLimit;
+    if (scale <= 0.0f) scale = 1.0f;
+    zero_point = static_cast<int32_t>(std::round(-min_range / scale));
+    zero_point = std::max(0, std::min(static_cast<int32_t>(kLimit), zero_point));
+  }
+};
+
+/*!
+ * \brief range of an int32 accumulator whose unit is out_scale, in the
+ *  convention of `_contrib_dequantize`: [-R, R] maps onto [-INT32_MAX, INT32_MAX].
+ */
+inline void QuantizedAccumRange(float out_scale, float *min_range, float *max_range) {
+  const double kLimit = std::numeric_limits<int32_t>::max();
+  *max_range = static_cast<float>(out_scale * kLimit);
+  *min_range = -(*max_range);
+}
+
+/*! \brief unit of an int32 accumulator of range [min_range, max_range] */
+inline double QuantizedAccumScale(float min_range, float max_range) {
+  const double kLimit = std::numeric_limits<int32_t>::max();
+  return std::max(std::fabs(static_cast<double>(min_range)),
+                  std::fabs(static_cast<double>(max_range))) / kLimit;
+}
+
+/*! \brief subtract the zero point and widen to int16, ready for the int32 dot products */
+inline void QuantizedCenter(const uint8_t *in, int16_t *out, index_t size, int32_t zero_point) {
+  #pragma omp parallel for
+  for (index_t i = 0; i < size; ++i) {
+    out[i] = static_cast<int16_t>(static_cast<int32_t>(in[i]) - zero_point);
+  }
+}
+
+/*! \brief convert a quantized bias into units of out_scale */
+inline void QuantizedBias(const uint8_t *in, int32_t *out, index_t size,
+                          const QuantizedRange &range, float out_scale) {
+  for (index_t i = 0; i < size; ++i) {
+    float real = range.scale * (static_cast<int32_t>(in[i]) - range.zero_point);
+    out[i] = static_cast<int32_t>(std::round(real / out_scale));
+  }
+}
+
+#if MSHADOW_USE_MKL && defined(INTEL_MKL_VERSION) && INTEL_MKL_VERSION >= 20180000
+#define MXNET_QUANTIZED_USE_MKL_IGEMM 1
+#else
+#define MXNET_QUANTIZED_USE_MKL_IGEMM 0
+#endif
+
+/*!
+ * \brief c += a * op(b) on centered int16 values with int32 accumulation.
+ *  a is m x k, op(b) is k x n, stored as b (k x n), or as b (n x k) when
+ *  trans_b is set, all row major. Uses the integer GEMM of MKL when available.
+ */
+inline void QuantizedGemm(index_t m, index_t n, index_t k, const int16_t *a,
+                          const int16_t *b, bool trans_b, int32_t *c) {
+#if MXNET_QUANTIZED_USE_MKL_IGEMM
+  const MKL_INT32 c_offset = 0;
+  cblas_gemm_s16s16s32(CblasRowMajor, CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans,
+                       CblasFixOffset, m, n, k, 1.0f, a, k, 0, b, trans_b ? k : n, 0,
+                       1.0f, c, n, &c_offset);
+#else
+  if (trans_b) {
+    // dot products of rows, the inner loop is a vectorizable reduction
+    const int total = static_cast<int>(m * n);
+    #pragma omp parallel for
+    for (int i = 0; i < total; ++i) {
+      const int16_t *x = a + (i / n) * k;
+      const int16_t *w = b + (i % n) * k;
+      int32_t acc = 0;
+      for (index_t p = 0; p < k; ++p) {
+        acc += static_cast<int32_t>(x[p]) * static_cast<int32_t>(w[p]);
+      }
+      c[i] += acc;
+    }
+  } else {
+    // a row of c is accumulated over blocks of the rows of b that stay in cache
+    const index_t kBlock = 64;
+    #pragma omp parallel for
+    for (int i = 0; i < static_cast<int>(m); ++i) {
+      int32_t *dst = c + i * n;
+      for (index_t p0 = 0; p0 < k; p0 += kBlock) {
+        const index_t p1 = std::min(k, p0 + kBlock);
+        for (index_t p = p0; p < p1; ++p) {
+          const int32_t ap = a[i * k + p];
+          if (ap == 0) continue;
+          const int16_t *src = b + p * n;
+          for (index_t j = 0; j < n; ++j) {
+            dst[j] += ap * static_cast<int32_t>(src[j]);
+          }
+        }
+      }
+    }
+  }
+#endif
+}
+
+/*! \brief number of data inputs (without ranges) of a quantized layer */
+inline int QuantizedNumData(bool no_bias) {
+  return no_bias ? 2 : 3;
+}
+
+/*!
+ * \brief type inference of quantized layers: data inputs are uint8,
+ *  ranges float32, the output int32 with float32 ranges.
+ */
+inline bool QuantizedLayerType(int num_data,
+                               std::vector<int> *in_attrs,
+                               std::vector<int> *out_attrs) {
+  CHECK_EQ(in_attrs->size(), static_cast<size_t>(3 * num_data));
+  CHECK_EQ(out_attrs->size(), 3U);
+  for (int i = 0; i < num_data; ++i) {
+    TYPE_ASSIGN_CHECK(*in_attrs, i, mshadow::kUint8);
+  }
+  for (int i = num_data; i < 3 * num_data; ++i) {
+    TYPE_ASSIGN_CHECK(*in_attrs, i, mshadow::kFloat32);
+  }
+  TYPE_ASSIGN_CHECK(*out_attrs, 0, mshadow::kInt32);
+  TYPE_ASSIGN_CHECK(*out_attrs, 1, mshadow::kFloat32);
+  TYPE_ASSIGN_CHECK(*out_attrs, 2, mshadow::kFloat32);
+  return true;
+}
+
+/*! \brief names of the inputs of quantized layers */
+inline std::vector<std::string> QuantizedLayerInputNames(bool no_bias) {
+  if (no_bias) {
+    return {"data", "weight", "min_data", "max_data", "min_weight", "max_weight"};
+  }
+  return {"data", "weight", "bias", "min_data", "max_data",
+          "min_weight", "max_weight", "min_bias", "max_bias"};
+}
+
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_CONTRIB_QUANTIZATION_UTILS_H_
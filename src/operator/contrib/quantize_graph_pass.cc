@@ -0,0 +1,189 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file quantize_graph_pass.cc
+ * \brief replace Convolution and FullyConnected by their quantized versions
+ */
+#include <nnvm/graph.h>
+#include <nnvm/pass.h>
+#include <mxnet/op_attr_types.h>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mxnet {
+namespace op {
+
+using nnvm::Node;
+using nnvm::NodePtr;
+using nnvm::NodeEntry;
+using nnvm::Graph;
+
+inline NodePtr CreateNode(const std::string& op_name, const std::string& node_name) {
+  NodePtr node = Node::Create();
+  node->attrs.op = nnvm::Op::Get(op_name);
+  node->attrs.name = node_name;
+  return node;
+}
+
+inline void ParseNode(const NodePtr& node) {
+  if (node->op()->attr_parser != nullptr) {
+    node->op()->attr_parser(&(node->attrs));
+  }
+}
+
+/*! \brief a quantized entry together with its range entries */
+struct QuantizedEntry {
+  NodeEntry data;
+  NodeEntry min_range;
+  NodeEntry max_range;
+};
+
+/*!
+ * \brief quantize a float entry with the range observed at runtime.
+ *  If the entry is the dequantized value of a quantized tensor, the float
+ *  round trip is removed: a uint8 tensor is reused directly, the int32 output
+ *  of a quantized layer is converted by `_contrib_requantize`.
+ */
+QuantizedEntry QuantizeEntry(const NodeEntry& e, const std::string& name) {
+  static const nnvm::Op* quantize_op = nnvm::Op::Get("_contrib_quantize");
+  static const nnvm::Op* dequantize_op = nnvm::Op::Get("_contrib_dequantize");
+  static const nnvm::Op* quantized_conv_op = nnvm::Op::Get("_contrib_quantized_conv");
+  static const nnvm::Op* quantized_fc_op = nnvm::Op::Get("_contrib_quantized_fully_connected");
+  if (e.node->op() == dequantize_op) {
+    const NodeEntry& src = e.node->inputs[0];
+    if (src.node->op() == quantize_op && src.index == 0) {
+      return QuantizedEntry{src, e.node->inputs[1], e.node->inputs[2]};
+    }
+    if ((src.node->op() == quantized_conv_op || src.node->op() == quantized_fc_op) &&
+        src.index == 0) {
+      NodePtr rq = CreateNode("_contrib_requantize", name + "_requantize");
+      rq->inputs = e.node->inputs;
+      ParseNode(rq);
+      return QuantizedEntry{NodeEntry{rq, 0, 0}, NodeEntry{rq, 1, 0}, NodeEntry{rq, 2, 0}};
+    }
+  }
+  NodePtr min_node = CreateNode("min", name + "_min");
+  min_node->inputs.push_back(e);
+  ParseNode(min_node);
+  NodePtr max_node = CreateNode("max", name + "_max");
+  max_node->inputs.push_back(e);
+  ParseNode(max_node);
+  NodePtr q = CreateNode("_contrib_quantize", name + "_quantize");
+  q->inputs = {e, NodeEntry{min_node, 0, 0}, NodeEntry{max_node, 0, 0}};
+  q->attrs.dict["out_type"] = "uint8";
+  ParseNode(q);
+  return QuantizedEntry{NodeEntry{q, 0, 0}, NodeEntry{q, 1, 0}, NodeEntry{q, 2, 0}};
+}
+
+/*!
+ * \brief a parameter of a quantized layer, quantized once at conversion time
+ *  by `quantize_params` and fed through the variables <name>_quantized,
+ *  <name>_min and <name>_max.
+ */
+QuantizedEntry QuantizedVariable(const NodeEntry& e) {
+  const std::string& name = e.node->attrs.name;
+  NodePtr data = Node::Create();
+  data->attrs.name = name + "_quantized";
+  NodePtr min_range = Node::Create();
+  min_range->attrs.name = name + "_min";
+  NodePtr max_range = Node::Create();
+  max_range->attrs.name = name + "_max";
+  return QuantizedEntry{NodeEntry{data, 0, 0}, NodeEntry{min_range, 0, 0},
+                        NodeEntry{max_range, 0, 0}};
+}
+
+/*! \brief whether a node can be replaced by its quantized version */
+bool NeedQuantize(const NodePtr& node, std::string* quantized_op) {
+  if (node->is_variable()) return false;
+  const std::string& name = node->op()->name;
+  const auto& dict = node->attrs.dict;
+  if (name == "FullyConnected") {
+    *quantized_op = "_contrib_quantized_fully_connected";
+    return true;
+  }
+  if (name == "Convolution") {
+    auto kernel = dict.find("kernel");
+    if (kernel == dict.end()) return false;
+    // 2D kernel "(h, w)"
+    if (std::count(kernel->second.begin(), kernel->second.end(), ',') != 1) return false;
+    auto layout = dict.find("layout");
+    if (layout != dict.end() && layout->second != "NCHW" && layout->second != "None") {
+      return false;
+    }
+    *quantized_op = "_contrib_quantized_conv";
+    return true;
+  }
+  return false;
+}
+
+Graph QuantizeGraph(Graph src) {
+  std::unordered_map<Node*, NodePtr> mirror_map;
+  // entries that replace output 0 of the original node
+  std::unordered_map<Node*, NodeEntry> replaced;
+  // quantized version of each float entry, shared by all of its readers
+  std::unordered_map<Node*, std::unordered_map<uint32_t, QuantizedEntry> > quantized;
+  auto mirror_entry = [&](const NodeEntry& e) {
+    auto it = replaced.find(e.node.get());
+    if (it != replaced.end() && e.index == 0) return it->second;
+    return NodeEntry{mirror_map.at(e.node.get()), e.index, e.version};
+  };
+
+  DFSVisit(src.outputs, [&](const NodePtr& node) {
+    NodePtr new_node = Node::Create();
+    *new_node = *node;
+    new_node->inputs.clear();
+    for (const auto& e : node->inputs) {
+      new_node->inputs.emplace_back(mirror_entry(e));
+    }
+    new_node->control_deps.clear();
+    for (const auto& dep : node->control_deps) {
+      new_node->control_deps.emplace_back(mirror_map.at(dep.get()));
+    }
+    mirror_map[node.get()] = new_node;
+
+    std::string quantized_op;
+    if (!NeedQuantize(node, &quantized_op)) return;
+    NodePtr qnode = CreateNode(quantized_op, node->attrs.name + "_quantized");
+    qnode->attrs.dict = node->attrs.dict;
+    ParseNode(qnode);
+    std::vector<QuantizedEntry> qinputs;
+    for (size_t i = 0; i < new_node->inputs.size(); ++i) {
+      const NodeEntry& e = new_node->inputs[i];
+      auto& cache = quantized[e.node.get()];
+      if (cache.count(e.index) == 0) {
+        // the weight and bias are parameters, only the data changes between runs
+        cache.emplace(e.index, i != 0 && e.node->is_variable() ? QuantizedVariable(e) :
+                      QuantizeEntry(e, node->attrs.name + "_in" + std::to_string(i)));
+      }
+      qinputs.push_back(cache.at(e.index));
+    }
+    for (const auto& q : qinputs) qnode->inputs.push_back(q.data);
+    for (const auto& q : qinputs) {
+      qnode->inputs.push_back(q.min_range);
+      qnode->inputs.push_back(q.max_range);
+    }
+    NodePtr dq = CreateNode("_contrib_dequantize", node->attrs.name + "_dequantize");
+    dq->inputs = {NodeEntry{qnode, 0, 0}, NodeEntry{qnode, 1, 0}, NodeEntry{qnode, 2, 0}};
+    dq->attrs.dict["out_type"] = "float32";
+    ParseNode(dq);
+    replaced[node.get()] = NodeEntry{dq, 0, 0};
+  });
+
+  Graph ret;
+  for (const auto& e : src.outputs) {
+    ret.outputs.emplace_back(mirror_entry(e));
+  }
+  return ret;
+}
+
+NNVM_REGISTER_PASS(QuantizeGraph)
+.describe("Replace Convolution and FullyConnected by uint8 quantized operators, "
+          "inserting quantize/dequantize nodes. Weights and biases become variables "
+          "holding their quantized values. Consecutive quantized layers are "
+          "connected by requantize instead of a float round trip.")
+.set_body(QuantizeGraph)
+.set_change_graph(true);
+
+}  // namespace op
+}  // namespace mxnet
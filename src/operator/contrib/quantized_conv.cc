@@ -0,0 +1,198 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file quantized_conv.cc
+ * \brief uint8 2D convolution with int32 accumulation on CPU
+ */
+#include <mxnet/operator_util.h>
+#include <algorithm>
+#include <vector>
+#include "./quantization_utils.h"
+#include "../convolution-inl.h"
+
+namespace mxnet {
+namespace op {
+
+void QuantizedConvParamParser(nnvm::NodeAttrs* attrs) {
+  ConvolutionParam param;
+  param.Init(attrs->dict);
+  CHECK_EQ(param.kernel.ndim(), 2U) << "quantized_conv only supports 2D convolution";
+  param.layout = param.layout ? param.layout.value() : mshadow::kNCHW;
+  CHECK_EQ(param.layout.value(), mshadow::kNCHW) << "quantized_conv only supports NCHW layout";
+  if (param.stride.ndim() == 0) param.stride = mshadow::Shape2(1, 1);
+  if (param.dilate.ndim() == 0) param.dilate = mshadow::Shape2(1, 1);
+  if (param.pad.ndim() == 0) param.pad = mshadow::Shape2(0, 0);
+  attrs->parsed = std::move(param);
+}
+
+bool QuantizedConvShape(const nnvm::NodeAttrs& attrs,
+                        std::vector<TShape> *in_attrs,
+                        std::vector<TShape> *out_attrs) {
+  const ConvolutionParam& param = nnvm::get<ConvolutionParam>(attrs.parsed);
+  const int num_data = QuantizedNumData(param.no_bias);
+  CHECK_EQ(in_attrs->size(), static_cast<size_t>(3 * num_data));
+  CHECK_EQ(out_attrs->size(), 3U);
+  for (int i = num_data; i < 3 * num_data; ++i) {
+    SHAPE_ASSIGN_CHECK(*in_attrs, i, TShape(1));
+  }
+  const TShape& dshape = (*in_attrs)[conv::kData];
+  if (dshape.ndim() == 0) return false;
+  CHECK_EQ(dshape.ndim(), 4U) << "Input data should be 4D in batch-num_filter-y-x";
+  CHECK_EQ(dshape[1] % param.num_group, 0U) << "input num_filter must divide group size";
+  CHECK_EQ(param.num_filter % param.num_group, 0U) << "output num_filter must divide group size";
+  SHAPE_ASSIGN_CHECK(*in_attrs, conv::kWeight,
+                     mshadow::Shape4(param.num_filter, dshape[1] / param.num_group,
+                                     param.kernel[0], param.kernel[1]));
+  if (!param.no_bias) {
+    SHAPE_ASSIGN_CHECK(*in_attrs, conv::kBias, mshadow::Shape1(param.num_filter));
+  }
+  const index_t dilated_kh = param.DilatedKernelSize(0);
+  const index_t dilated_kw = param.DilatedKernelSize(1);
+  CHECK_LE(dilated_kh, dshape[2] + 2 * param.pad[0]) << "kernel size exceed input";
+  CHECK_LE(dilated_kw, dshape[3] + 2 * param.pad[1]) << "kernel size exceed input";
+  SHAPE_ASSIGN_CHECK(*out_attrs, 0, mshadow::Shape4(
+      dshape[0], param.num_filter,
+      (dshape[2] + 2 * param.pad[0] - dilated_kh) / param.stride[0] + 1,
+      (dshape[3] + 2 * param.pad[1] - dilated_kw) / param.stride[1] + 1));
+  SHAPE_ASSIGN_CHECK(*out_attrs, 1, TShape(1));
+  SHAPE_ASSIGN_CHECK(*out_attrs, 2, TShape(1));
+  return true;
+}
+
+bool QuantizedConvType(const nnvm::NodeAttrs& attrs,
+                       std::vector<int> *in_attrs,
+                       std::vector<int> *out_attrs) {
+  const ConvolutionParam& param = nnvm::get<ConvolutionParam>(attrs.parsed);
+  return QuantizedLayerType(QuantizedNumData(param.no_bias), in_attrs, out_attrs);
+}
+
+void QuantizedConvForwardCPU(const nnvm::NodeAttrs& attrs,
+                             const OpContext& ctx,
+                             const std::vector<TBlob>& inputs,
+                             const std::vector<OpReqType>& req,
+                             const std::vector<TBlob>& outputs) {
+  using namespace mshadow;
+  const ConvolutionParam& param = nnvm::get<ConvolutionParam>(attrs.parsed);
+  const int num_data = QuantizedNumData(param.no_bias);
+  CHECK_EQ(inputs.size(), static_cast<size_t>(3 * num_data));
+  CHECK_EQ(outputs.size(), 3U);
+  CHECK_EQ(req[0], kWriteTo);
+  Stream<cpu> *s = ctx.get_stream<cpu>();
+
+  const QuantizedRange data_range(*inputs[num_data].dptr<float>(),
+                                  *inputs[num_data + 1].dptr<float>());
+  const QuantizedRange weight_range(*inputs[num_data + 2].dptr<float>(),
+                                    *inputs[num_data + 3].dptr<float>());
+  const float out_scale = data_range.scale * weight_range.scale;
+
+  const TShape& ishape = inputs[conv::kData].shape_;
+  const TShape& oshape = outputs[0].shape_;
+  const index_t batch = ishape[0], in_c = ishape[1], in_h = ishape[2], in_w = ishape[3];
+  const index_t out_c = oshape[1], out_h = oshape[2], out_w = oshape[3];
+  const index_t kh = param.kernel[0], kw = param.kernel[1];
+  const index_t group = param.num_group;
+  const index_t group_in_c = in_c / group, group_out_c = out_c / group;
+  // rows of the column buffer and of the weight matrix within one group
+  const index_t col_k = group_in_c * kh * kw;
+  const index_t col_n = out_h * out_w;
+
+  // workspace: centered weight, int32 bias, then the column buffer of one image
+  const index_t weight_size = out_c * col_k;
+  const index_t bias_offset = (weight_size + 1) / 2 * 2;
+  const index_t col_offset = bias_offset + 2 * out_c;
+  Tensor<cpu, 1, int16_t> workspace = ctx.requested[0].get_space_typed<cpu, 1, int16_t>(
+      Shape1(col_offset + group * col_k * col_n), s);
+  int16_t *weight = workspace.dptr_;
+  int32_t *bias = reinterpret_cast<int32_t*>(weight + bias_offset);
+  int16_t *col = weight + col_offset;
+  QuantizedCenter(inputs[conv::kWeight].dptr<uint8_t>(), weight, weight_size,
+                  weight_range.zero_point);
+  if (param.no_bias) {
+    std::fill(bias, bias + out_c, 0);
+  } else {
+    const QuantizedRange bias_range(*inputs[num_data + 4].dptr<float>(),
+                                    *inputs[num_data + 5].dptr<float>());
+    QuantizedBias(inputs[conv::kBias].dptr<uint8_t>(), bias, out_c, bias_range, out_scale);
+  }
+
+  const uint8_t *data = inputs[conv::kData].dptr<uint8_t>();
+  int32_t *out = outputs[0].dptr<int32_t>();
+  const int16_t data_zero = static_cast<int16_t>(data_range.zero_point);
+  for (index_t n = 0; n < batch; ++n) {
+    const uint8_t *img = data + n * in_c * in_h * in_w;
+    // im2col of the centered image, padding is real zero
+    const int num_rows = static_cast<int>(in_c * kh * kw);
+    #pragma omp parallel for
+    for (int row = 0; row < num_rows; ++row) {
+      const index_t c = row / (kh * kw);
+      const index_t ky = (row / kw) % kh;
+      const index_t kx = row % kw;
+      int16_t *dst = col + row * col_n;
+      for (index_t oy = 0; oy < out_h; ++oy) {
+        const int iy = static_cast<int>(oy * param.stride[0] + ky * param.dilate[0])
+                       - static_cast<int>(param.pad[0]);
+        for (index_t ox = 0; ox < out_w; ++ox) {
+          const int ix = static_cast<int>(ox * param.stride[1] + kx * param.dilate[1])
+                         - static_cast<int>(param.pad[1]);
+          int16_t v = 0;
+          if (iy >= 0 && iy < static_cast<int>(in_h) && ix >= 0 && ix < static_cast<int>(in_w)) {
+            v = static_cast<int16_t>(img[(c * in_h + iy) * in_w + ix]) - data_zero;
+          }
+          dst[oy * out_w + ox] = v;
+        }
+      }
+    }
+    // out[oc, :] = bias[oc] + weight[oc, :] * col, one int32 GEMM per group
+    int32_t *img_out = out + n * out_c * col_n;
+    for (index_t oc = 0; oc < out_c; ++oc) {
+      std::fill(img_out + oc * col_n, img_out + (oc + 1) * col_n, bias[oc]);
+    }
+    for (index_t g = 0; g < group; ++g) {
+      QuantizedGemm(group_out_c, col_n, col_k, weight + g * group_out_c * col_k,
+                    col + g * col_k * col_n, false, img_out + g * group_out_c * col_n);
+    }
+  }
+  QuantizedAccumRange(out_scale, outputs[1].dptr<float>(), outputs[2].dptr<float>());
+}
+
+NNVM_REGISTER_OP(_contrib_quantized_conv)
+.describe(R"code(2D convolution for uint8 input, weight and bias in NCHW layout.
+
+The inputs are produced by `_contrib_quantize` together with their ranges.
+Products are accumulated in int32 and the output range is set such that
+`_contrib_dequantize` recovers the float result.
+)code" ADD_FILELINE)
+.set_num_inputs([](const NodeAttrs& attrs) {
+    const ConvolutionParam& param = nnvm::get<ConvolutionParam>(attrs.parsed);
+    return static_cast<uint32_t>(3 * QuantizedNumData(param.no_bias));
+  })
+.set_num_outputs(3)
+.set_attr_parser(QuantizedConvParamParser)
+.set_attr<nnvm::FListInputNames>("FListInputNames",
+  [](const NodeAttrs& attrs) {
+    const ConvolutionParam& param = nnvm::get<ConvolutionParam>(attrs.parsed);
+    return QuantizedLayerInputNames(param.no_bias);
+  })
+.set_attr<nnvm::FListOutputNames>("FListOutputNames",
+  [](const NodeAttrs& attrs) {
+    return std::vector<std::string>{"output", "min_output", "max_output"};
+  })
+.set_attr<nnvm::FInferShape>("FInferShape", QuantizedConvShape)
+.set_attr<nnvm::FInferType>("FInferType", QuantizedConvType)
+.set_attr<FResourceRequest>("FResourceRequest",
+  [](const NodeAttrs& attrs) {
+    return std::vector<ResourceRequest>{ResourceRequest::kTempSpace};
+  })
+.set_attr<FCompute>("FCompute<cpu>", QuantizedConvForwardCPU)
+.add_argument("data", "NDArray-or-Symbol", "Input data, uint8.")
+.add_argument("weight", "NDArray-or-Symbol", "Weight matrix, uint8.")
+.add_argument("bias", "NDArray-or-Symbol", "Bias parameter, uint8.")
+.add_argument("min_data", "NDArray-or-Symbol", "Minimum value of data.")
+.add_argument("max_data", "NDArray-or-Symbol", "Maximum value of data.")
+.add_argument("min_weight", "NDArray-or-Symbol", "Minimum value of weight.")
+.add_argument("max_weight", "NDArray-or-Symbol", "Maximum value of weight.")
+.add_argument("min_bias", "NDArray-or-Symbol", "Minimum value of bias.")
+.add_argument("max_bias", "NDArray-or-Symbol", "Maximum value of bias.")
+.add_arguments(ConvolutionParam::__FIELDS__());
+
+}  // namespace op
+}  // namespace mxnet
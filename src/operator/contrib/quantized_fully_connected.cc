@@ -0,0 +1,141 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file quantized_fully_connected.cc
+ * \brief uint8 fully connected layer with int32 accumulation on CPU
+ */
+#include <mxnet/operator_util.h>
+#include <algorithm>
+#include <vector>
+#include "./quantization_utils.h"
+#include "../fully_connected-inl.h"
+
+namespace mxnet {
+namespace op {
+
+bool QuantizedFullyConnectedShape(const nnvm::NodeAttrs& attrs,
+                                  std::vector<TShape> *in_attrs,
+                                  std::vector<TShape> *out_attrs) {
+  const FullyConnectedParam& param = nnvm::get<FullyConnectedParam>(attrs.parsed);
+  const int num_data = QuantizedNumData(param.no_bias);
+  CHECK_EQ(in_attrs->size(), static_cast<size_t>(3 * num_data));
+  CHECK_EQ(out_attrs->size(), 3U);
+  for (int i = num_data; i < 3 * num_data; ++i) {
+    SHAPE_ASSIGN_CHECK(*in_attrs, i, TShape(1));
+  }
+  const TShape& dshape = (*in_attrs)[fullc::kData];
+  if (dshape.ndim() == 0) return false;
+  const index_t num_input = dshape.ProdShape(1, dshape.ndim());
+  SHAPE_ASSIGN_CHECK(*in_attrs, fullc::kWeight, mshadow::Shape2(param.num_hidden, num_input));
+  if (!param.no_bias) {
+    SHAPE_ASSIGN_CHECK(*in_attrs, fullc::kBias, mshadow::Shape1(param.num_hidden));
+  }
+  SHAPE_ASSIGN_CHECK(*out_attrs, 0, mshadow::Shape2(dshape[0], param.num_hidden));
+  SHAPE_ASSIGN_CHECK(*out_attrs, 1, TShape(1));
+  SHAPE_ASSIGN_CHECK(*out_attrs, 2, TShape(1));
+  return true;
+}
+
+bool QuantizedFullyConnectedType(const nnvm::NodeAttrs& attrs,
+                                 std::vector<int> *in_attrs,
+                                 std::vector<int> *out_attrs) {
+  const FullyConnectedParam& param = nnvm::get<FullyConnectedParam>(attrs.parsed);
+  return QuantizedLayerType(QuantizedNumData(param.no_bias), in_attrs, out_attrs);
+}
+
+void QuantizedFullyConnectedForwardCPU(const nnvm::NodeAttrs& attrs,
+                                       const OpContext& ctx,
+                                       const std::vector<TBlob>& inputs,
+                                       const std::vector<OpReqType>& req,
+                                       const std::vector<TBlob>& outputs) {
+  using namespace mshadow;
+  const FullyConnectedParam& param = nnvm::get<FullyConnectedParam>(attrs.parsed);
+  const int num_data = QuantizedNumData(param.no_bias);
+  CHECK_EQ(inputs.size(), static_cast<size_t>(3 * num_data));
+  CHECK_EQ(outputs.size(), 3U);
+  CHECK_EQ(req[0], kWriteTo);
+  Stream<cpu> *s = ctx.get_stream<cpu>();
+
+  const QuantizedRange data_range(*inputs[num_data].dptr<float>(),
+                                  *inputs[num_data + 1].dptr<float>());
+  const QuantizedRange weight_range(*inputs[num_data + 2].dptr<float>(),
+                                    *inputs[num_data + 3].dptr<float>());
+  const float out_scale = data_range.scale * weight_range.scale;
+
+  const TShape& dshape = inputs[fullc::kData].shape_;
+  const index_t batch = dshape[0];
+  const index_t num_input = dshape.ProdShape(1, dshape.ndim());
+  const index_t num_hidden = param.num_hidden;
+
+  // centered int16 copies of data and weight, followed by the int32 bias
+  const index_t data_size = batch * num_input;
+  const index_t weight_size = num_hidden * num_input;
+  const index_t bias_offset = (data_size + weight_size + 1) / 2 * 2;
+  Tensor<cpu, 1, int16_t> workspace = ctx.requested[0].get_space_typed<cpu, 1, int16_t>(
+      Shape1(bias_offset + 2 * num_hidden), s);
+  int16_t *data = workspace.dptr_;
+  int16_t *weight = data + data_size;
+  int32_t *bias = reinterpret_cast<int32_t*>(data + bias_offset);
+  QuantizedCenter(inputs[fullc::kData].dptr<uint8_t>(), data, data_size,
+                  data_range.zero_point);
+  QuantizedCenter(inputs[fullc::kWeight].dptr<uint8_t>(), weight, weight_size,
+                  weight_range.zero_point);
+  if (param.no_bias) {
+    std::fill(bias, bias + num_hidden, 0);
+  } else {
+    const QuantizedRange bias_range(*inputs[num_data + 4].dptr<float>(),
+                                    *inputs[num_data + 5].dptr<float>());
+    QuantizedBias(inputs[fullc::kBias].dptr<uint8_t>(), bias, num_hidden,
+                  bias_range, out_scale);
+  }
+
+  // out = bias + data * weight^T
+  int32_t *out = outputs[0].dptr<int32_t>();
+  for (index_t n = 0; n < batch; ++n) {
+    std::copy(bias, bias + num_hidden, out + n * num_hidden);
+  }
+  QuantizedGemm(batch, num_hidden, num_input, data, weight, true, out);
+  QuantizedAccumRange(out_scale, outputs[1].dptr<float>(), outputs[2].dptr<float>());
+}
+
+NNVM_REGISTER_OP(_contrib_quantized_fully_connected)
+.describe(R"code(Fully connected layer for uint8 input, weight and bias.
+
+The inputs are produced by `_contrib_quantize` together with their ranges.
+Products are accumulated in int32 and the output range is set such that
+`_contrib_dequantize` recovers the float result.
+)code" ADD_FILELINE)
+.set_num_inputs([](const NodeAttrs& attrs) {
+    const FullyConnectedParam& param = nnvm::get<FullyConnectedParam>(attrs.parsed);
+    return static_cast<uint32_t>(3 * QuantizedNumData(param.no_bias));
+  })
+.set_num_outputs(3)
+.set_attr_parser(ParamParser<FullyConnectedParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames",
+  [](const NodeAttrs& attrs) {
+    const FullyConnectedParam& param = nnvm::get<FullyConnectedParam>(attrs.parsed);
+    return QuantizedLayerInputNames(param.no_bias);
+  })
+.set_attr<nnvm::FListOutputNames>("FListOutputNames",
+  [](const NodeAttrs& attrs) {
+    return std::vector<std::string>{"output", "min_output", "max_output"};
+  })
+.set_attr<nnvm::FInferShape>("FInferShape", QuantizedFullyConnectedShape)
+.set_attr<nnvm::FInferType>("FInferType", QuantizedFullyConnectedType)
+.set_attr<FResourceRequest>("FResourceRequest",
+  [](const NodeAttrs& attrs) {
+    return std::vector<ResourceRequest>{ResourceRequest::kTempSpace};
+  })
+.set_attr<FCompute>("FCompute<cpu>", QuantizedFullyConnectedForwardCPU)
+.add_argument("data", "NDArray-or-Symbol", "Input data, uint8.")
+.add_argument("weight", "NDArray-or-Symbol", "Weight matrix, uint8.")
+.add_argument("bias", "NDArray-or-Symbol", "Bias parameter, uint8.")
+.add_argument("min_data", "NDArray-or-Symbol", "Minimum value of data.")
+.add_argument("max_data", "NDArray-or-Symbol", "Maximum value of data.")
+.add_argument("min_weight", "NDArray-or-Symbol", "Minimum value of weight.")
+.add_argument("max_weight", "NDArray-or-Symbol", "Maximum value of weight.")
+.add_argument("min_bias", "NDArray-or-Symbol", "Minimum value of bias.")
+.add_argument("max_bias", "NDArray-or-Symbol", "Maximum value of bias.")
+.add_arguments(FullyConnectedParam::__FIELDS__());
+
+}  // namespace op
+}  // namespace mxnet
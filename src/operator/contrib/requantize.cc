@@ -0,0 +1,93 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file requantize.cc
+ * \brief convert the int32 output of a quantized layer to uint8 on CPU
+ */
+#include <mxnet/operator_util.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "./quantization_utils.h"
+
+namespace mxnet {
+namespace op {
+
+bool RequantizeShape(const nnvm::NodeAttrs& attrs,
+                     std::vector<TShape> *in_attrs,
+                     std::vector<TShape> *out_attrs) {
+  CHECK_EQ(in_attrs->size(), 3U);
+  CHECK_EQ(out_attrs->size(), 3U);
+  SHAPE_ASSIGN_CHECK(*in_attrs, 1, TShape(1));
+  SHAPE_ASSIGN_CHECK(*in_attrs, 2, TShape(1));
+  SHAPE_ASSIGN_CHECK(*out_attrs, 0, (*in_attrs)[0]);
+  SHAPE_ASSIGN_CHECK(*out_attrs, 1, TShape(1));
+  SHAPE_ASSIGN_CHECK(*out_attrs, 2, TShape(1));
+  return !shape_is_none((*out_attrs)[0]);
+}
+
+bool RequantizeType(const nnvm::NodeAttrs& attrs,
+                    std::vector<int> *in_attrs,
+                    std::vector<int> *out_attrs) {
+  CHECK_EQ(in_attrs->size(), 3U);
+  CHECK_EQ(out_attrs->size(), 3U);
+  TYPE_ASSIGN_CHECK(*in_attrs, 0, mshadow::kInt32);
+  TYPE_ASSIGN_CHECK(*in_attrs, 1, mshadow::kFloat32);
+  TYPE_ASSIGN_CHECK(*in_attrs, 2, mshadow::kFloat32);
+  TYPE_ASSIGN_CHECK(*out_attrs, 0, mshadow::kUint8);
+  TYPE_ASSIGN_CHECK(*out_attrs, 1, mshadow::kFloat32);
+  TYPE_ASSIGN_CHECK(*out_attrs, 2, mshadow::kFloat32);
+  return true;
+}
+
+void RequantizeForwardCPU(const nnvm::NodeAttrs& attrs,
+                          const OpContext& ctx,
+                          const std::vector<TBlob>& inputs,
+                          const std::vector<OpReqType>& req,
+                          const std::vector<TBlob>& outputs) {
+  const index_t size = inputs[0].Size();
+  const int32_t *in = inputs[0].dptr<int32_t>();
+  uint8_t *out = outputs[0].dptr<uint8_t>();
+  const double in_scale = QuantizedAccumScale(*inputs[1].dptr<float>(),
+                                              *inputs[2].dptr<float>());
+  // the range of the values actually present, keeping zero representable
+  int32_t lo = 0, hi = 0;
+  for (index_t i = 0; i < size; ++i) {
+    lo = std::min(lo, in[i]);
+    hi = std::max(hi, in[i]);
+  }
+  const float min_range = static_cast<float>(lo * in_scale);
+  const float max_range = static_cast<float>(hi * in_scale);
+  const QuantizedRange range(min_range, max_range);
+  const double ratio = in_scale / range.scale;
+  #pragma omp parallel for
+  for (index_t i = 0; i < size; ++i) {
+    const double q = std::round(in[i] * ratio) + range.zero_point;
+    out[i] = static_cast<uint8_t>(std::max(0.0, std::min(255.0, q)));
+  }
+  *outputs[1].dptr<float>() = min_range;
+  *outputs[2].dptr<float>() = max_range;
+}
+
+NNVM_REGISTER_OP(_contrib_requantize)
+.describe(R"code(Convert the int32 output of a quantized layer, with its range, to uint8.
+
+The uint8 range is the range of the values present in the input, widened to
+contain zero, so that the output can be fed to the next quantized layer without
+a dequantize/quantize round trip through float32.
+)code" ADD_FILELINE)
+.set_num_inputs(3)
+.set_num_outputs(3)
+.set_attr<nnvm::FListInputNames>("FListInputNames",
+  [](const NodeAttrs& attrs) {
+    return std::vector<std::string>{"data", "min_range", "max_range"};
+  })
+.set_attr<nnvm::FInferShape>("FInferShape", RequantizeShape)
+.set_attr<nnvm::FInferType>("FInferType", RequantizeType)
+.set_attr<FCompute>("FCompute<cpu>", RequantizeForwardCPU)
+.add_argument("data", "NDArray-or-Symbol", "int32 output of a quantized layer")
+.add_argument("min_range", "NDArray-or-Symbol", "The minimum scalar value of data")
+.add_argument("max_range", "NDArray-or-Symbol", "The maximum scalar value of data");
+
+}  // namespace op
+}  // namespace mxnet
@@ -6,6 +6,7 @@
 */
 
 #include "./convolution-inl.h"
+#include "./cpu_algoreg-inl.h"
 #if MXNET_USE_MKL2017 == 1
 #include <mkl_memory.h>
 #include "./mkl/mkl_memory-inl.h"
@@ -32,19 +33,27 @@ Operator* CreateOp<cpu>(ConvolutionParam param, int dtype,
     })
     return op;
   }
+  // candidates in order of preference, the first one is used without autotuning
+  std::vector<CPUAlgoCandidate> candidates;
 #if MXNET_USE_MKL2017 == 1
   if ((param.dilate[0] == 1 && param.dilate[1] == 1)
       && param.kernel.ndim() == 2) {
     switch (dtype) {
     case mshadow::kFloat32:
-      return new MKLConvolutionOp<cpu, float>(param);
+      candidates.push_back({"mkl", [param]() -> Operator* {
+            return new MKLConvolutionOp<cpu, float>(param); }});
+      break;
     case mshadow::kFloat64:
-      return new MKLConvolutionOp<cpu, double>(param);
+      candidates.push_back({"mkl", [param]() -> Operator* {
+            return new MKLConvolutionOp<cpu, double>(param); }});
+      break;
     default:
       break;
     }
   }
-  LOG(INFO) << MKLConvolutionOp<cpu, float>::getName() << " Skip MKL optimization";
+  if (candidates.size() == 0) {
+    LOG(INFO) << MKLConvolutionOp<cpu, float>::getName() << " Skip MKL optimization";
+  }
 #endif
 #if MXNET_USE_NNPACK == 1
   const size_t batch_size = (*in_shape)[0][0];
@@ -55,16 +64,23 @@ Operator* CreateOp<cpu>(ConvolutionParam param, int dtype,
       (param.stride[1] == 1)))) {
     switch (dtype) {
     case mshadow::kFloat32:
-      return new NNPACKConvolutionOp<cpu, float>(param);
+      candidates.push_back({"nnpack", [param]() -> Operator* {
+            return new NNPACKConvolutionOp<cpu, float>(param); }});
+      break;
     default:
       break;
     }
   }
 #endif
-  MSHADOW_REAL_TYPE_SWITCH(dtype, DType, {
-    op = new ConvolutionOp<cpu, DType>(param);
-  })
-  return op;
+  candidates.push_back({"im2col_gemm", [param, dtype]() -> Operator* {
+        Operator *op = NULL;
+        MSHADOW_REAL_TYPE_SWITCH(dtype, DType, {
+          op = new ConvolutionOp<cpu, DType>(param);
+        })
+        return op;
+      }});
+  std::string key = CPUAlgoReg::Get()->GetKey("Convolution", param, *in_shape, dtype);
+  return CreateCPUAutoTunedOp(key, candidates);
 }
 
 // DO_BIND_DISPATCH comes from operator_common.h
@@ -0,0 +1,144 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file cpu_algoreg-inl.h
+ * \brief registry of the fastest CPU implementation of an operator,
+ *  selected by timing the candidates on first use.
+ */
+#ifndef MXNET_OPERATOR_CPU_ALGOREG_INL_H_
+#define MXNET_OPERATOR_CPU_ALGOREG_INL_H_
+
+#include <dmlc/logging.h>
+#include <mxnet/operator.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mxnet {
+namespace op {
+
+/*! \brief a candidate implementation of an operator */
+struct CPUAlgoCandidate {
+  /*! \brief name of the algorithm, stored in the registry file */
+  std::string name;
+  /*! \brief create the operator */
+  std::function<Operator*()> create;
+};
+
+/*!
+ * \brief Registry of the fastest algorithm for each (op, param, shape, dtype, threads).
+ *  When MXNET_CPU_AUTOTUNE_FILE is set the table is loaded from that file at
+ *  startup and written back once no operator is being tuned, so that the
+ *  operators of an executor tuned in the same forward pass write it once.
+ */
+class CPUAlgoReg {
+ public:
+  template <typename Param>
+  std::string GetKey(const std::string &op_name, const Param &param,
+                     const std::vector<TShape> &in_shape, int dtype) {
+    std::ostringstream oss;
+    oss << "op=" << op_name << ";";
+    oss << "inputs=";
+    for (auto &i : in_shape)
+      oss << i << ";";
+    auto dict = param.__DICT__();
+    for (auto &k : dict)
+      oss << k.first << "=" << k.second << ";";
+    oss << "dtype=" << dtype << ";";
+    oss << "threads=" << NumThreads() << ";";
+    return oss.str();
+  }
+
+  bool Find(const std::string &key, std::string *algo) {
+    std::lock_guard<std::mutex> guard(lock_);
+    auto i = reg_.find(key);
+    if (i == reg_.end()) return false;
+    *algo = i->second;
+    return true;
+  }
+
+  void Register(const std::string &key, const std::string &algo);
+  /*! \brief an operator starts tuning */
+  void BeginTuning();
+  /*! \brief an operator is done tuning, saves the new entries if it was the last one */
+  void EndTuning();
+  /*! \brief load entries from file, entries already present are kept */
+  void Load(const std::string &fname);
+  /*! \brief save all entries to file */
+  void Save(const std::string &fname);
+
+  static CPUAlgoReg *Get();
+
+ private:
+  static int NumThreads();
+  void SaveLocked(const std::string &fname);
+
+  std::mutex lock_;
+  std::unordered_map<std::string, std::string> reg_;
+  std::string file_;
+  /*! \brief number of operators being tuned */
+  int pending_ = 0;
+  /*! \brief whether entries were registered since the last save */
+  bool dirty_ = false;
+};
+
+/*!
+ * \brief operator that times all candidates on the first forward pass,
+ *  registers the fastest one and delegates to it afterwards.
+ *  Candidates must not mutate their aux states in Forward.
+ *  The candidates are timed at the current OpenMP thread count only, the count
+ *  is part of the key but is not searched, since MKL, NNPACK and BLAS size their
+ *  own thread pools.
+ */
+class CPUAutoTuneOp : public Operator {
+ public:
+  CPUAutoTuneOp(const std::string &key, const std::vector<CPUAlgoCandidate> &candidates)
+    : key_(key), candidates_(candidates) {
+    CPUAlgoReg::Get()->BeginTuning();
+  }
+
+  virtual ~CPUAutoTuneOp() {
+    if (selected_ == nullptr) CPUAlgoReg::Get()->EndTuning();
+  }
+
+  virtual void Forward(const OpContext &ctx,
+                       const std::vector<TBlob> &in_data,
+                       const std::vector<OpReqType> &req,
+                       const std::vector<TBlob> &out_data,
+                       const std::vector<TBlob> &aux_args);
+
+  virtual void Backward(const OpContext &ctx,
+                        const std::vector<TBlob> &out_grad,
+                        const std::vector<TBlob> &in_data,
+                        const std::vector<TBlob> &out_data,
+                        const std::vector<OpReqType> &req,
+                        const std::vector<TBlob> &in_grad,
+                        const std::vector<TBlob> &aux_args) {
+    CHECK(selected_ != nullptr) << "Backward called before Forward";
+    selected_->Backward(ctx, out_grad, in_data, out_data, req, in_grad, aux_args);
+  }
+
+ private:
+  std::string key_;
+  std::vector<CPUAlgoCandidate> candidates_;
+  std::unique_ptr<Operator> selected_;
+};
+
+/*!
+ * \brief create an operator from a list of candidates.
+ *  The first candidate is the default. If there is only one candidate, or
+ *  MXNET_CPU_AUTOTUNE is 0, it is created directly. If the key is already
+ *  in the registry the registered candidate is created, otherwise the
+ *  selection is deferred to the first forward pass.
+ */
+Operator *CreateCPUAutoTunedOp(const std::string &key,
+                               const std::vector<CPUAlgoCandidate> &candidates);
+
+}  // namespace op
+}  // namespace mxnet
+
+#endif  // MXNET_OPERATOR_CPU_ALGOREG_INL_H_
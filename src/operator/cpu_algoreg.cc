@@ -0,0 +1,160 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file cpu_algoreg.cc
+ * \brief registry of the fastest CPU implementation of an operator.
+*/
+#include "./cpu_algoreg-inl.h"
+#include <dmlc/parameter.h>
+#include <mxnet/base.h>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+namespace mxnet {
+namespace op {
+
+CPUAlgoReg *CPUAlgoReg::Get() {
+  static CPUAlgoReg *ptr = []() {
+    CPUAlgoReg *reg = new CPUAlgoReg();
+    std::string fname = dmlc::GetEnv("MXNET_CPU_AUTOTUNE_FILE", std::string());
+    if (fname.length() != 0) {
+      reg->Load(fname);
+      reg->file_ = fname;
+    }
+    return reg;
+  }();
+  return ptr;
+}
+
+int CPUAlgoReg::NumThreads() {
+#if defined(_OPENMP)
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+void CPUAlgoReg::Register(const std::string &key, const std::string &algo) {
+  std::lock_guard<std::mutex> guard(lock_);
+  reg_[key] = algo;
+  dirty_ = true;
+}
+
+void CPUAlgoReg::BeginTuning() {
+  std::lock_guard<std::mutex> guard(lock_);
+  ++pending_;
+}
+
+void CPUAlgoReg::EndTuning() {
+  std::lock_guard<std::mutex> guard(lock_);
+  CHECK_GT(pending_, 0);
+  if (--pending_ == 0 && dirty_ && file_.length() != 0) {
+    SaveLocked(file_);
+    dirty_ = false;
+  }
+}
+
+void CPUAlgoReg::Load(const std::string &fname) {
+  std::ifstream is(fname);
+  if (!is.good()) return;
+  std::lock_guard<std::mutex> guard(lock_);
+  std::string line;
+  size_t count = 0;
+  while (std::getline(is, line)) {
+    size_t pos = line.rfind('\t');
+    if (pos == std::string::npos) continue;
+    std::string key = line.substr(0, pos);
+    if (reg_.count(key) == 0) {
+      reg_[key] = line.substr(pos + 1);
+      ++count;
+    }
+  }
+  LOG(INFO) << "Loaded " << count << " CPU algorithm entries from " << fname;
+}
+
+void CPUAlgoReg::Save(const std::string &fname) {
+  std::lock_guard<std::mutex> guard(lock_);
+  SaveLocked(fname);
+}
+
+void CPUAlgoReg::SaveLocked(const std::string &fname) {
+  // write to a temporary file first so that a crash never leaves a truncated table
+  std::string tmp = fname + ".tmp";
+  {
+    std::ofstream os(tmp);
+    if (!os.good()) {
+      LOG(WARNING) << "Cannot write CPU algorithm registry to " << fname;
+      return;
+    }
+    for (const auto &kv : reg_) {
+      os << kv.first << '\t' << kv.second << '\n';
+    }
+  }
+  std::rename(tmp.c_str(), fname.c_str());
+}
+
+void CPUAutoTuneOp::Forward(const OpContext &ctx,
+                            const std::vector<TBlob> &in_data,
+                            const std::vector<OpReqType> &req,
+                            const std::vector<TBlob> &out_data,
+                            const std::vector<TBlob> &aux_args) {
+  if (selected_ == nullptr) {
+    bool can_tune = true;
+    for (OpReqType r : req) {
+      if (r != kWriteTo && r != kNullOp) can_tune = false;
+    }
+    if (!can_tune) {
+      // running the candidates repeatedly would accumulate into the output
+      selected_.reset(candidates_[0].create());
+    } else {
+      const int kRuns = 3;
+      double best_time = std::numeric_limits<double>::max();
+      size_t best = 0;
+      for (size_t i = 0; i < candidates_.size(); ++i) {
+        std::unique_ptr<Operator> op(candidates_[i].create());
+        // warm up, the first call sets up internal buffers
+        op->Forward(ctx, in_data, req, out_data, aux_args);
+        double t = std::numeric_limits<double>::max();
+        for (int k = 0; k < kRuns; ++k) {
+          auto start = std::chrono::high_resolution_clock::now();
+          op->Forward(ctx, in_data, req, out_data, aux_args);
+          std::chrono::duration<double> d = std::chrono::high_resolution_clock::now() - start;
+          t = std::min(t, d.count());
+        }
+        if (t < best_time) {
+          best_time = t;
+          best = i;
+          selected_ = std::move(op);
+        }
+      }
+      CPUAlgoReg::Get()->Register(key_, candidates_[best].name);
+    }
+    CPUAlgoReg::Get()->EndTuning();
+    candidates_.clear();
+  }
+  selected_->Forward(ctx, in_data, req, out_data, aux_args);
+}
+
+Operator *CreateCPUAutoTunedOp(const std::string &key,
+                               const std::vector<CPUAlgoCandidate> &candidates) {
+  CHECK_GT(candidates.size(), 0U);
+  static bool autotune = dmlc::GetEnv("MXNET_CPU_AUTOTUNE", true);
+  if (candidates.size() == 1 || !autotune) {
+    return candidates[0].create();
+  }
+  std::string algo;
+  if (CPUAlgoReg::Get()->Find(key, &algo)) {
+    for (const auto &c : candidates) {
+      if (c.name == algo) return c.create();
+    }
+  }
+  return new CPUAutoTuneOp(key, candidates);
+}
+
+}  // namespace op
+}  // namespace mxnet
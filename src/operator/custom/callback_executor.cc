@@ -0,0 +1,139 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file callback_executor.cc
+ * \brief process wide pool of threads running the frontend callbacks
+ */
+#include "./callback_executor.h"
+#include <dmlc/logging.h>
+#include <dmlc/parameter.h>
+#include <mxnet/base.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <utility>
+#include "../../engine/profiler.h"
+
+namespace mxnet {
+namespace op {
+namespace {
+/*! \return current clock time in microsecond */
+uint64_t NowInMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+}
+/*! \brief how long all the workers may be busy without progress before one is added */
+const std::chrono::milliseconds kStallTimeout(1000);
+}  // namespace
+
+CallbackExecutor::CallbackExecutor()
+    : idle_workers_(0), queue_depth_(0), num_completed_(0), shutdown_(false) {
+  max_workers_ = std::max(dmlc::GetEnv("MXNET_CUSTOM_OP_NUM_THREADS", 4), 1);
+}
+
+CallbackExecutor::~CallbackExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  ready_cv_.notify_all();
+  monitor_cv_.notify_all();
+  if (monitor_.joinable()) monitor_.join();
+  for (std::thread& worker : workers_) worker.join();
+}
+
+CallbackExecutor* CallbackExecutor::Get() {
+  static CallbackExecutor inst;
+  return &inst;
+}
+
+void CallbackExecutor::Push(const std::shared_ptr<Strand>& strand, std::function<void()> fn,
+                            const char *name) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  strand->tasks_.push(Strand::Task{std::move(fn), name, NowInMicros()});
+  ++queue_depth_;
+#if MXNET_USE_PROFILER
+  engine::Profiler::Get()->AddCounter("CustomOpQueueDepth", queue_depth_);
+#endif
+  if (strand->scheduled_) return;
+  strand->scheduled_ = true;
+  ready_.push_back(strand);
+  // threads are only started when no thread is waiting, up to the bound
+  if (idle_workers_ == 0 && workers_.size() < max_workers_) {
+    workers_.emplace_back([this]() { this->RunWorker(); });
+    if (!monitor_.joinable()) monitor_ = std::thread([this]() { this->RunMonitor(); });
+  } else {
+    lock.unlock();
+    ready_cv_.notify_one();
+  }
+}
+
+void CallbackExecutor::RunWorker() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    ++idle_workers_;
+    ready_cv_.wait(lock, [this]() { return !ready_.empty() || shutdown_; });
+    --idle_workers_;
+    if (ready_.empty()) break;
+    std::shared_ptr<Strand> strand = std::move(ready_.front());
+    ready_.pop_front();
+    Strand::Task task = std::move(strand->tasks_.front());
+    strand->tasks_.pop();
+    --queue_depth_;
+#if MXNET_USE_PROFILER
+    engine::Profiler *profiler = engine::Profiler::Get();
+    profiler->AddCounter("CustomOpQueueDepth", queue_depth_);
+    profiler->AddCounter("CustomOpQueueLatency(us)",
+                         static_cast<int64_t>(NowInMicros() - task.push_time));
+    engine::OprExecStat *opr_stat = nullptr;
+    if (profiler->GetState() == engine::Profiler::kRunning) {
+      opr_stat = profiler->AddOprStat(Context::kCPU, 0);
+      opr_stat->thread_id = std::hash<std::thread::id>()(std::this_thread::get_id());
+      strncpy(opr_stat->opr_name, task.name, sizeof(opr_stat->opr_name) - 1);
+      engine::SetOprStart(opr_stat);
+    }
+#endif
+    strand->running_thread_ = std::this_thread::get_id();
+    lock.unlock();
+    task.fn();
+    lock.lock();
+    strand->running_thread_ = std::thread::id();
+    ++num_completed_;
+#if MXNET_USE_PROFILER
+    if (opr_stat != nullptr) engine::SetOprEnd(opr_stat);
+#endif
+    // the strand goes back to the end of the queue so that one busy
+    // operator does not hold a thread
+    if (strand->tasks_.empty()) {
+      strand->scheduled_ = false;
+      strand->idle_cv_.notify_all();
+    } else {
+      ready_.push_back(std::move(strand));
+    }
+  }
+}
+
+void CallbackExecutor::RunMonitor() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  uint64_t last_completed = num_completed_;
+  while (!shutdown_) {
+    monitor_cv_.wait_for(lock, kStallTimeout);
+    if (shutdown_) break;
+    // every worker runs a callback that may wait for a queued one
+    if (!ready_.empty() && idle_workers_ == 0 && num_completed_ == last_completed) {
+      LOG(INFO) << "All " << workers_.size() << " custom operator threads are blocked, "
+                << "adding one. Consider increasing MXNET_CUSTOM_OP_NUM_THREADS";
+      workers_.emplace_back([this]() { this->RunWorker(); });
+    }
+    last_completed = num_completed_;
+  }
+}
+
+void CallbackExecutor::Strand::WaitForAll() {
+  CallbackExecutor *executor = CallbackExecutor::Get();
+  std::unique_lock<std::mutex> lock(executor->mutex_);
+  // the operator is released by its own callback, which cannot wait for itself
+  if (running_thread_ == std::this_thread::get_id()) return;
+  idle_cv_.wait(lock, [this]() { return !scheduled_; });
+}
+}  // namespace op
+}  // namespace mxnet
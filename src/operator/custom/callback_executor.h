@@ -0,0 +1,98 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file callback_executor.h
+ * \brief process wide pool of threads running the frontend callbacks of
+ *  Custom and NDArrayOp operators
+ */
+#ifndef MXNET_OPERATOR_CUSTOM_CALLBACK_EXECUTOR_H_
+#define MXNET_OPERATOR_CUSTOM_CALLBACK_EXECUTOR_H_
+#include <dmlc/base.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace mxnet {
+namespace op {
+/*!
+ * \brief runs callbacks on MXNET_CUSTOM_OP_NUM_THREADS threads shared by all the
+ *  operators. Each operator queues its callbacks on its own strand, the
+ *  callbacks of a strand run one at a time in the order they were pushed.
+ *  A callback may wait for another callback, e.g. of a nested custom operator.
+ *  When every thread has been busy without completing a callback for a while
+ *  and callbacks are queued, a thread is added past the bound.
+ */
+class CallbackExecutor {
+ public:
+  /*! \brief the callbacks of one operator */
+  class Strand {
+   public:
+    /*!
+     * \brief block until every callback pushed to the strand has run. Called from
+     *  a callback of the strand itself, it returns without waiting.
+     */
+    void WaitForAll();
+
+   private:
+    friend class CallbackExecutor;
+    struct Task {
+      std::function<void()> fn;
+      const char *name;
+      uint64_t push_time;
+    };
+    /*! \brief callbacks not run yet */
+    std::queue<Task> tasks_;
+    /*! \brief whether the strand is in the ready queue or running */
+    bool scheduled_ = false;
+    /*! \brief signaled when the strand becomes idle */
+    std::condition_variable idle_cv_;
+    /*! \brief the thread running a callback of the strand */
+    std::thread::id running_thread_;
+  };
+  ~CallbackExecutor();
+  /*! \brief create a strand for the callbacks of a new operator */
+  std::shared_ptr<Strand> NewStrand() {
+    return std::make_shared<Strand>();
+  }
+  /*!
+   * \brief queue fn after the callbacks already pushed to strand
+   * \param name name of the callback in the profiler
+   */
+  void Push(const std::shared_ptr<Strand>& strand, std::function<void()> fn,
+            const char *name);
+  /*! \return the executor singleton */
+  static CallbackExecutor* Get();
+
+ private:
+  CallbackExecutor();
+  /*! \brief the loop of a worker thread */
+  void RunWorker();
+  /*! \brief the loop of the thread adding workers when all of them are blocked */
+  void RunMonitor();
+  /*! \brief maximum number of threads */
+  size_t max_workers_;
+  /*! \brief number of threads waiting for a strand */
+  size_t idle_workers_;
+  /*! \brief number of callbacks queued and not started */
+  int64_t queue_depth_;
+  /*! \brief number of callbacks completed */
+  uint64_t num_completed_;
+  /*! \brief whether the executor is being destroyed */
+  bool shutdown_;
+  /*! \brief strands with callbacks to run, each one appears at most once */
+  std::deque<std::shared_ptr<Strand> > ready_;
+  std::vector<std::thread> workers_;
+  std::thread monitor_;
+  /*! \brief protects all the states above and the strands */
+  std::mutex mutex_;
+  std::condition_variable ready_cv_;
+  std::condition_variable monitor_cv_;
+};
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_CUSTOM_CALLBACK_EXECUTOR_H_
@@ -16,12 +16,9 @@
 #include <string>
 #include <utility>
 #include <sstream>
-#include <thread>
-#include <mutex>
-#include <functional>
-#include <condition_variable>
-#include <queue>
+#include <memory>
 #include "../operator_common.h"
+#include "./callback_executor.h"
 
 namespace mxnet {
 namespace op {
@@ -44,28 +41,14 @@ class CustomOp : public Operator {
       sync_mode_ = true;
     } else {
       sync_mode_ = false;
-      destructing_ = false;
-      worker_ = std::thread([&]() {
-          std::unique_lock<std::mutex> lock(mtx_);
-          while (!q_.empty() || !destructing_) {
-            cv_.wait(lock, [&] {return !q_.empty() || destructing_;});
-            while (!q_.empty()) {
-              q_.front()();
-              q_.pop();
-            }
-          }
-        });
+      strand_ = CallbackExecutor::Get()->NewStrand();
     }
   }
 
   ~CustomOp() {
     if (!sync_mode_) {
-      {
-        std::unique_lock<std::mutex> lock(mtx_);
-        destructing_ = true;
-        cv_.notify_all();
-      }
-      worker_.join();
+      // the queued callbacks use op_info_
+      strand_->WaitForAll();
     }
   }
 
@@ -90,11 +73,8 @@ class CustomOp : public Operator {
  private:
   Context get_ctx();
   std::shared_ptr<MXCallbackList> op_info_;
-  std::mutex mtx_;
-  std::condition_variable cv_;
-  std::thread worker_;
-  std::queue<std::function<void(void)> > q_;
-  bool destructing_;
+  /*! \brief orders the callbacks of this operator in the callback executor */
+  std::shared_ptr<CallbackExecutor::Strand> strand_;
   bool sync_mode_;
 };  // CustomOp
 
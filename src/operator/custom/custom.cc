@@ -86,9 +86,7 @@ void CustomOp<xpu>::Forward(const OpContext &ctx,
   if (sync_mode_) {
     compute();
   } else {
-    std::unique_lock<std::mutex> lock(mtx_);
-    q_.push(compute);
-    cv_.notify_all();
+    CallbackExecutor::Get()->Push(strand_, compute, "CustomOpForwardCallback");
   }
 }
 
@@ -152,9 +150,7 @@ void CustomOp<xpu>::Backward(const OpContext &ctx,
   if (sync_mode_) {
     compute();
   } else {
-    std::unique_lock<std::mutex> lock(mtx_);
-    q_.push(compute);
-    cv_.notify_all();
+    CallbackExecutor::Get()->Push(strand_, compute, "CustomOpBackwardCallback");
   }
 }
 
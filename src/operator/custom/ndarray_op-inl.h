@@ -16,7 +16,9 @@
 #include <string>
 #include <utility>
 #include <sstream>
+#include <memory>
 #include "../operator_common.h"
+#include "./callback_executor.h"
 
 namespace mxnet {
 namespace op {
@@ -36,6 +38,13 @@ class NDArrayOp : public Operator {
  public:
   explicit NDArrayOp(NDArrayOpParam p) {
     this->param_ = p;
+    sync_mode_ =
+        std::string("NaiveEngine") == dmlc::GetEnv("MXNET_ENGINE_TYPE", std::string());
+    if (!sync_mode_) strand_ = CallbackExecutor::Get()->NewStrand();
+  }
+
+  ~NDArrayOp() {
+    if (!sync_mode_) strand_->WaitForAll();
   }
 
   virtual void Forward(const OpContext &ctx,
@@ -58,6 +67,9 @@ class NDArrayOp : public Operator {
 
  private:
   NDArrayOpParam param_;
+  /*! \brief orders the callbacks of this operator in the callback executor */
+  std::shared_ptr<CallbackExecutor::Strand> strand_;
+  bool sync_mode_;
   Context get_ctx();
 };  // NDArrayOp
 
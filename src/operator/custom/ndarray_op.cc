@@ -65,10 +65,19 @@ void NDArrayOp<xpu>::Forward(const OpContext &ctx,
     ndcpy.push_back(*reinterpret_cast<NDArray*>(i));
   }
 
-  CHECK(param_.pinfo->forward(ptrs.size(), ptrs.data(), tags.data(), param_.pinfo->p_forward));
-  Engine::Get()->PushSync([ndcpy, ctx](RunContext rctx) {ctx.async_on_complete(); },
-                          ndctx, ndvar, {}, FnProperty::kNormal, 0,
-                          PROFILER_MESSAGE("NDArrayOpForward"));
+  auto compute = [=]() mutable {
+      CHECK(param_.pinfo->forward(ptrs.size(), ptrs.data(), tags.data(),
+                                  param_.pinfo->p_forward));
+      Engine::Get()->PushSync([ndcpy, ctx](RunContext rctx) {ctx.async_on_complete(); },
+                              ndctx, ndvar, {}, FnProperty::kNormal, 0,
+                              PROFILER_MESSAGE("NDArrayOpForward"));
+    };
+
+  if (sync_mode_) {
+    compute();
+  } else {
+    CallbackExecutor::Get()->Push(strand_, compute, "NDArrayOpForwardCallback");
+  }
 }
 
 template<typename xpu>
@@ -112,10 +121,19 @@ void NDArrayOp<xpu>::Backward(const OpContext &ctx,
     ndcpy.push_back(*reinterpret_cast<NDArray*>(i));
   }
 
-  CHECK(param_.pinfo->backward(ptrs.size(), ptrs.data(), tags.data(), param_.pinfo->p_backward));
-  Engine::Get()->PushSync([ndcpy, ctx](RunContext rctx){ ctx.async_on_complete(); },
-                          ndctx, ndvar, {}, FnProperty::kNormal, 0,
-                          PROFILER_MESSAGE("NDArrayOpBackward"));
+  auto compute = [=]() mutable {
+      CHECK(param_.pinfo->backward(ptrs.size(), ptrs.data(), tags.data(),
+                                   param_.pinfo->p_backward));
+      Engine::Get()->PushSync([ndcpy, ctx](RunContext rctx){ ctx.async_on_complete(); },
+                              ndctx, ndvar, {}, FnProperty::kNormal, 0,
+                              PROFILER_MESSAGE("NDArrayOpBackward"));
+    };
+
+  if (sync_mode_) {
+    compute();
+  } else {
+    CallbackExecutor::Get()->Push(strand_, compute, "NDArrayOpBackwardCallback");
+  }
 }
 
 Operator* NDArrayOpProp::CreateOperator(Context ctx) const {
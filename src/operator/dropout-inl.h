@@ -17,6 +17,7 @@
 #include <algorithm>
 #include "./operator_common.h"
 #include "./mshadow_op.h"
+#include "./mxnet_op.h"
 
 #if defined(USE_MKL) && defined(_OPENMP)
 #include <omp.h>
@@ -56,6 +57,26 @@ static void bernoulli_generate(int n, double p, int* r) {
 }
 #endif  // USE_MKL && _OPENMP
 
+/*!
+ * \brief keep each value of block i with probability pkeep, scaled by 1 / pkeep,
+ *  and write the scale to mask
+ */
+struct DropoutKernel {
+  template<typename DType>
+  MSHADOW_XINLINE static void Map(int i, random::RandomRange range, DType *out,
+                                  DType *mask, const DType *data, int size,
+                                  float pkeep, OpReqType req) {
+    float u[random::RandomRange::kBlockSize];
+    range.Uniform(i, u);
+    const int begin = i * random::RandomRange::kBlockSize;
+    for (int j = 0; j < random::RandomRange::kBlockSize && begin + j < size; ++j) {
+      const DType m = DType(u[j] < pkeep ? 1.0f / pkeep : 0.0f);
+      mask[begin + j] = m;
+      KERNEL_ASSIGN(out[begin + j], req, data[begin + j] * m);
+    }
+  }
+};
+
 struct DropoutParam : public dmlc::Parameter<DropoutParam> {
   float p;
   DMLC_DECLARE_PARAMETER(DropoutParam) {
@@ -99,10 +120,14 @@ class DropoutOp : public Operator {
         outptr[i] = dataptr[i] * maskptr[i];
       }
 #else
-      Random<xpu> *prnd = ctx.requested[dropout::kRandom].get_random<xpu, real_t>(s);
-      mask = tcast<DType>(F<mshadow_op::threshold>(
-             prnd->uniform(mask.shape_), pkeep_) * (1.0f / pkeep_));
-      Assign(out, req[dropout::kOut], data * mask);
+      const int size = mask.shape_.Size();
+      const int nblock = (size + random::RandomRange::kBlockSize - 1) /
+                         random::RandomRange::kBlockSize;
+      random::RandomRange range =
+          ctx.requested[dropout::kRandom].get_parallel_random()->Reserve(size);
+      mxnet_op::Kernel<DropoutKernel, xpu>::Launch(s, nblock, range, out.dptr_, mask.dptr_,
+                                                   data.dptr_, size, pkeep_,
+                                                   req[dropout::kOut]);
 #endif  // USE_MKL && _OPENMP
     } else {
       Assign(out, req[dropout::kOut], F<mshadow_op::identity>(data));
@@ -222,7 +247,7 @@ class DropoutProp : public OperatorProperty {
 
   std::vector<ResourceRequest> ForwardResource(
     const std::vector<TShape> &in_shape) const override {
-    return {ResourceRequest::kRandom};
+    return {ResourceRequest::kParallelRandom};
   }
 
   int NumVisibleOutputs() const override {
@@ -4,6 +4,7 @@
  * \brief fully connect operator
 */
 #include "./fully_connected-inl.h"
+#include "./cpu_algoreg-inl.h"
 #if MXNET_USE_NNPACK == 1
 #include "./nnpack/nnpack_fully_connected-inl.h"
 #endif  // MXNET_USE_NNPACK
@@ -15,24 +16,27 @@ Operator* CreateOp<cpu>(FullyConnectedParam param, int dtype,
                         std::vector<TShape> *in_shape,
                         std::vector<TShape> *out_shape,
                         Context ctx) {
-  Operator *op = NULL;
+  std::vector<CPUAlgoCandidate> candidates;
 #if MXNET_USE_NNPACK == 1
-  const size_t batch_size = (*in_shape)[0][0];
   // nnp_fully_connected_inference will do optimization for batch-size = 1
   // nnp_fully_connected_output will do optimization for batch-size > 1
   switch (dtype) {
   case mshadow::kFloat32:
-    return new NNPACKFullyConnectedOp<cpu, float>(param);
+    candidates.push_back({"nnpack", [param]() -> Operator* {
+          return new NNPACKFullyConnectedOp<cpu, float>(param); }});
+    break;
   default:
     break;
   }
 #endif
   switch (dtype) {
   case mshadow::kFloat32:
-    op = new FullyConnectedOp<cpu, float>(param);
+    candidates.push_back({"gemm", [param]() -> Operator* {
+          return new FullyConnectedOp<cpu, float>(param); }});
     break;
   case mshadow::kFloat64:
-    op = new FullyConnectedOp<cpu, double>(param);
+    candidates.push_back({"gemm", [param]() -> Operator* {
+          return new FullyConnectedOp<cpu, double>(param); }});
     break;
   case mshadow::kFloat16:
     LOG(FATAL) << "float16 fully connected layer is currently"
@@ -41,8 +45,8 @@ Operator* CreateOp<cpu>(FullyConnectedParam param, int dtype,
   default:
     LOG(FATAL) << "Unsupported type " << dtype;
   }
-
-  return op;
+  std::string key = CPUAlgoReg::Get()->GetKey("FullyConnected", param, *in_shape, dtype);
+  return CreateCPUAutoTunedOp(key, candidates);
 }
 
 // DO_BIND_DISPATCH comes from operator_common.h
@@ -13,6 +13,7 @@
 #include <mshadow/base.h>
 #include <nnvm/op.h>
 #include <nnvm/op_attr_types.h>
+#include <string>
 #include <vector>
 #include "./operator_common.h"
 #include "./mshadow_op.h"
@@ -153,6 +154,311 @@ inline void SGDMomUpdate(const nnvm::NodeAttrs& attrs,
   });
 }
 
+struct MultiSGDParam : public dmlc::Parameter<MultiSGDParam> {
+  int num_weights;
+  float lr;
+  float wd;
+  float rescale_grad;
+  float clip_gradient;
+  DMLC_DECLARE_PARAMETER(MultiSGDParam) {
+    DMLC_DECLARE_FIELD(num_weights)
+    .set_lower_bound(1)
+    .describe("Number of updated weights.");
+    DMLC_DECLARE_FIELD(lr)
+    .describe("Learning rate");
+    DMLC_DECLARE_FIELD(wd)
+    .set_default(0.0f)
+    .describe("Weight decay augments the objective function with a "
+              "regularization term that penalizes large weights. "
+              "The penalty scales with the square of the magnitude of each weight.");
+    DMLC_DECLARE_FIELD(rescale_grad)
+    .set_default(1.0f)
+    .describe("Rescale gradient to grad = rescale_grad*grad.");
+    DMLC_DECLARE_FIELD(clip_gradient)
+    .set_default(-1.0f)
+    .describe("Clip gradient to the range of [-clip_gradient, clip_gradient] "
+              "If clip_gradient <= 0, gradient clipping is turned off. "
+              "grad = max(min(grad, clip_gradient), -clip_gradient).");
+  }
+};
+
+struct MultiSGDMomParam : public dmlc::Parameter<MultiSGDMomParam> {
+  int num_weights;
+  float lr;
+  float momentum;
+  float wd;
+  float rescale_grad;
+  float clip_gradient;
+  DMLC_DECLARE_PARAMETER(MultiSGDMomParam) {
+    DMLC_DECLARE_FIELD(num_weights)
+    .set_lower_bound(1)
+    .describe("Number of updated weights.");
+    DMLC_DECLARE_FIELD(lr)
+    .describe("Learning rate");
+    DMLC_DECLARE_FIELD(momentum)
+    .set_default(0.0f)
+    .describe("The decay rate of momentum estimates at each epoch.");
+    DMLC_DECLARE_FIELD(wd)
+    .set_default(0.0f)
+    .describe("Weight decay augments the objective function with a "
+              "regularization term that penalizes large weights. "
+              "The penalty scales with the square of the magnitude of each weight.");
+    DMLC_DECLARE_FIELD(rescale_grad)
+    .set_default(1.0f)
+    .describe("Rescale gradient to grad = rescale_grad*grad.");
+    DMLC_DECLARE_FIELD(clip_gradient)
+    .set_default(-1.0f)
+    .describe("Clip gradient to the range of [-clip_gradient, clip_gradient] "
+              "If clip_gradient <= 0, gradient clipping is turned off. "
+              "grad = max(min(grad, clip_gradient), -clip_gradient).");
+  }
+};
+
+/*!
+ * \brief shape or type inference of the multi-weight updates. The inputs are
+ *  num_inputs_per_weight arrays per weight, weight first, all of the attribute
+ *  of the output of that weight.
+ */
+template<typename AttrType, bool (*is_none)(const AttrType&),
+         bool (*assign)(AttrType*, const AttrType&), int num_inputs_per_weight>
+inline bool MultiUpdateAttr(const nnvm::NodeAttrs& attrs,
+                            std::vector<AttrType> *in_attrs,
+                            std::vector<AttrType> *out_attrs) {
+  CHECK_EQ(in_attrs->size(), out_attrs->size() * num_inputs_per_weight);
+  bool known = true;
+  for (size_t i = 0; i < out_attrs->size(); ++i) {
+    AttrType &out = (*out_attrs)[i];
+    for (int j = 0; j < num_inputs_per_weight; ++j) {
+      CHECK(assign(&out, (*in_attrs)[i * num_inputs_per_weight + j]))
+          << "Inputs " << i * num_inputs_per_weight << " to "
+          << (i + 1) * num_inputs_per_weight - 1 << " of " << attrs.op->name
+          << " belong to the same weight and must agree";
+    }
+    for (int j = 0; j < num_inputs_per_weight; ++j) {
+      assign(&(*in_attrs)[i * num_inputs_per_weight + j], out);
+    }
+    known = known && !is_none(out);
+  }
+  return known;
+}
+
+template<int num_inputs_per_weight>
+inline bool MultiUpdateShape(const nnvm::NodeAttrs& attrs,
+                             std::vector<TShape> *in_attrs,
+                             std::vector<TShape> *out_attrs) {
+  return MultiUpdateAttr<TShape, shape_is_none, shape_assign, num_inputs_per_weight>(
+    attrs, in_attrs, out_attrs);
+}
+
+template<int num_inputs_per_weight>
+inline bool MultiUpdateType(const nnvm::NodeAttrs& attrs,
+                            std::vector<int> *in_attrs,
+                            std::vector<int> *out_attrs) {
+  return MultiUpdateAttr<int, type_is_none, type_assign, num_inputs_per_weight>(
+    attrs, in_attrs, out_attrs);
+}
+
+/*!
+ * \brief SGD update of num_weights weights in one operator, so that a whole
+ *  model is updated with one dispatch. The inputs are weight_i, grad_i.
+ */
+template<typename xpu>
+inline void MultiSGDUpdate(const nnvm::NodeAttrs& attrs,
+                           const OpContext &ctx,
+                           const std::vector<TBlob> &inputs,
+                           const std::vector<OpReqType> &req,
+                           const std::vector<TBlob> &outputs) {
+  using namespace mxnet_op;
+  const MultiSGDParam& param = nnvm::get<MultiSGDParam>(attrs.parsed);
+  Stream<xpu>* s = ctx.get_stream<xpu>();
+  for (int i = 0; i < param.num_weights; ++i) {
+    const TBlob &weight = inputs[2 * i], &grad = inputs[2 * i + 1];
+    MSHADOW_REAL_TYPE_SWITCH(weight.type_flag_, DType, {
+      Kernel<SGDKernel, xpu>::Launch(s, weight.Size(), outputs[i].dptr<DType>(),
+        weight.dptr<DType>(), grad.dptr<DType>(), static_cast<DType>(param.clip_gradient),
+        static_cast<DType>(param.lr), static_cast<DType>(param.wd),
+        static_cast<DType>(param.rescale_grad), req[i]);
+    });
+  }
+}
+
+/*!
+ * \brief momentum SGD update of num_weights weights in one operator.
+ *  The inputs are weight_i, grad_i, mom_i.
+ */
+template<typename xpu>
+inline void MultiSGDMomUpdate(const nnvm::NodeAttrs& attrs,
+                              const OpContext &ctx,
+                              const std::vector<TBlob> &inputs,
+                              const std::vector<OpReqType> &req,
+                              const std::vector<TBlob> &outputs) {
+  using namespace mxnet_op;
+  const MultiSGDMomParam& param = nnvm::get<MultiSGDMomParam>(attrs.parsed);
+  Stream<xpu>* s = ctx.get_stream<xpu>();
+  for (int i = 0; i < param.num_weights; ++i) {
+    const TBlob &weight = inputs[3 * i], &grad = inputs[3 * i + 1], &mom = inputs[3 * i + 2];
+    MSHADOW_REAL_TYPE_SWITCH(weight.type_flag_, DType, {
+      Kernel<SGDMomKernel, xpu>::Launch(s, weight.Size(), outputs[i].dptr<DType>(),
+        mom.dptr<DType>(), weight.dptr<DType>(), grad.dptr<DType>(),
+        static_cast<DType>(param.clip_gradient), static_cast<DType>(param.momentum),
+        static_cast<DType>(param.lr), static_cast<DType>(param.wd),
+        static_cast<DType>(param.rescale_grad), req[i]);
+    });
+  }
+}
+
+/*!
+ * \brief shape inference of the row-sparse updates: weight (K, D), grad (N, D),
+ *  row_ids (N,) followed by states of the shape of weight
+ */
+inline bool SparseUpdateShape(const nnvm::NodeAttrs& attrs,
+                              std::vector<TShape> *in_attrs,
+                              std::vector<TShape> *out_attrs) {
+  CHECK_GE(in_attrs->size(), 3U);
+  CHECK_EQ(out_attrs->size(), 1U);
+  const TShape wshape = (*in_attrs)[0];
+  if (wshape.ndim() == 0) return false;
+  CHECK_EQ(wshape.ndim(), 2U) << "row-sparse update expects a 2D weight";
+  const TShape &gshape = (*in_attrs)[1];
+  if (gshape.ndim() != 0) {
+    CHECK_EQ(gshape.ndim(), 2U) << "row-sparse gradient should be 2D";
+    CHECK_EQ(gshape[1], wshape[1]) << "row length of gradient and weight mismatch";
+    SHAPE_ASSIGN_CHECK(*in_attrs, 2, mshadow::Shape1(gshape[0]));
+  }
+  for (size_t i = 3; i < in_attrs->size(); ++i) {
+    SHAPE_ASSIGN_CHECK(*in_attrs, i, wshape);
+  }
+  SHAPE_ASSIGN_CHECK(*out_attrs, 0, wshape);
+  return gshape.ndim() != 0;
+}
+
+/*! \brief type inference of the row-sparse updates, row_ids can be of any type */
+inline bool SparseUpdateType(const nnvm::NodeAttrs& attrs,
+                             std::vector<int> *in_attrs,
+                             std::vector<int> *out_attrs) {
+  CHECK_GE(in_attrs->size(), 3U);
+  CHECK_EQ(out_attrs->size(), 1U);
+  int dtype = (*out_attrs)[0];
+  for (size_t i = 0; i < in_attrs->size(); ++i) {
+    if (i != 2 && (*in_attrs)[i] != -1) dtype = (*in_attrs)[i];
+  }
+  if (dtype == -1) return false;
+  for (size_t i = 0; i < in_attrs->size(); ++i) {
+    if (i != 2) TYPE_ASSIGN_CHECK(*in_attrs, i, dtype);
+  }
+  TYPE_ASSIGN_CHECK(*out_attrs, 0, dtype);
+  return (*in_attrs)[2] != -1;
+}
+
+/*!
+ * \brief copy weight to out unless the update is in-place, so that rows
+ *  absent from the row-sparse gradient keep their value
+ */
+template<typename xpu, typename DType>
+inline void SparseUpdatePrepareOutput(mshadow::Stream<xpu> *s, const TBlob &weight,
+                                      const TBlob &out, OpReqType req) {
+  CHECK(req == kWriteTo || req == kWriteInplace)
+      << "row-sparse update only supports write to the weight";
+  if (out.dptr_ != weight.dptr_) {
+    mshadow::Tensor<xpu, 2, DType> dst = out.FlatTo2D<xpu, DType>(s);
+    mshadow::Copy(dst, weight.FlatTo2D<xpu, DType>(s), s);
+  }
+}
+
+struct SparseSGDKernel {
+  template<typename DType, typename IType>
+  MSHADOW_XINLINE static void Map(int i, DType* out_data, const DType* weight_data,
+    const DType* grad_data, const IType* row_ids, const int row_length, const int64_t num_rows,
+    const DType param_clip_gradient, const DType param_lr, const DType param_wd,
+    const DType param_rescale_grad) {
+    // the offset of a row of a large embedding does not fit in int
+    const int64_t row = static_cast<int64_t>(row_ids[i / row_length]);
+    if (row < 0 || row >= num_rows) return;
+    const int64_t j = row * row_length + i % row_length;
+    DType grad = param_rescale_grad*grad_data[i];
+    if (param_clip_gradient >= 0.0f) {
+      grad = mshadow_op::clip::Map(grad, param_clip_gradient);
+    }
+    out_data[j] = (1.f-param_lr*param_wd)*weight_data[j] - param_lr*grad;
+  }
+};
+
+/*!
+ * \brief SGD update with a row-sparse gradient (row_ids, grad). Only the rows
+ *  listed in row_ids are touched, negative ids are padding and skipped.
+ */
+template<typename xpu>
+inline void SparseSGDUpdate(const nnvm::NodeAttrs& attrs,
+                            const OpContext &ctx,
+                            const std::vector<TBlob> &inputs,
+                            const std::vector<OpReqType> &req,
+                            const std::vector<TBlob> &outputs) {
+  using namespace mxnet_op;
+  const SGDParam& param = nnvm::get<SGDParam>(attrs.parsed);
+  Stream<xpu>* s = ctx.get_stream<xpu>();
+  MSHADOW_REAL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
+    MSHADOW_TYPE_SWITCH(inputs[2].type_flag_, IType, {
+      SparseUpdatePrepareOutput<xpu, DType>(s, inputs[0], outputs[0], req[0]);
+      Tensor<xpu, 2, DType> grad = inputs[1].FlatTo2D<xpu, DType>(s);
+      Kernel<SparseSGDKernel, xpu>::Launch(s, grad.shape_.Size(),
+        outputs[0].dptr<DType>(), outputs[0].dptr<DType>(), grad.dptr_,
+        inputs[2].dptr<IType>(), static_cast<int>(grad.shape_[1]),
+        static_cast<int64_t>(inputs[0].shape_[0]), static_cast<DType>(param.clip_gradient),
+        static_cast<DType>(param.lr), static_cast<DType>(param.wd),
+        static_cast<DType>(param.rescale_grad));
+    });
+  });
+}
+
+struct SparseSGDMomKernel {
+  template<typename DType, typename IType>
+  MSHADOW_XINLINE static void Map(int i, DType* out_data, DType* mom_data,
+    const DType* weight_data, const DType* grad_data, const IType* row_ids,
+    const int row_length, const int64_t num_rows, const DType param_clip_gradient,
+    const DType param_momentum, const DType param_lr, const DType param_wd,
+    const DType param_rescale_grad) {
+    // the offset of a row of a large embedding does not fit in int
+    const int64_t row = static_cast<int64_t>(row_ids[i / row_length]);
+    if (row < 0 || row >= num_rows) return;
+    const int64_t j = row * row_length + i % row_length;
+    DType grad = param_rescale_grad*grad_data[i];
+    if (param_clip_gradient >= 0.0f) {
+      grad = mshadow_op::clip::Map(grad, param_clip_gradient);
+    }
+    mom_data[j] = param_momentum*mom_data[j]
+              - param_lr*param_wd*weight_data[j]
+              - param_lr*grad;
+    out_data[j] = weight_data[j] + mom_data[j];
+  }
+};
+
+/*!
+ * \brief momentum SGD update with a row-sparse gradient. The momentum of rows
+ *  absent from the gradient is not decayed (lazy update).
+ */
+template<typename xpu>
+inline void SparseSGDMomUpdate(const nnvm::NodeAttrs& attrs,
+                               const OpContext &ctx,
+                               const std::vector<TBlob> &inputs,
+                               const std::vector<OpReqType> &req,
+                               const std::vector<TBlob> &outputs) {
+  using namespace mxnet_op;
+  const SGDMomParam& param = nnvm::get<SGDMomParam>(attrs.parsed);
+  Stream<xpu>* s = ctx.get_stream<xpu>();
+  MSHADOW_REAL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
+    MSHADOW_TYPE_SWITCH(inputs[2].type_flag_, IType, {
+      SparseUpdatePrepareOutput<xpu, DType>(s, inputs[0], outputs[0], req[0]);
+      Tensor<xpu, 2, DType> grad = inputs[1].FlatTo2D<xpu, DType>(s);
+      Kernel<SparseSGDMomKernel, xpu>::Launch(s, grad.shape_.Size(),
+        outputs[0].dptr<DType>(), inputs[3].dptr<DType>(), outputs[0].dptr<DType>(),
+        grad.dptr_, inputs[2].dptr<IType>(), static_cast<int>(grad.shape_[1]),
+        static_cast<int64_t>(inputs[0].shape_[0]), static_cast<DType>(param.clip_gradient),
+        static_cast<DType>(param.momentum), static_cast<DType>(param.lr),
+        static_cast<DType>(param.wd), static_cast<DType>(param.rescale_grad));
+    });
+  });
+}
+
 struct AdamParam : public dmlc::Parameter<AdamParam> {
   float lr;
   float beta1;
@@ -11,6 +11,8 @@ namespace op {
 
 DMLC_REGISTER_PARAMETER(SGDParam);
 DMLC_REGISTER_PARAMETER(SGDMomParam);
+DMLC_REGISTER_PARAMETER(MultiSGDParam);
+DMLC_REGISTER_PARAMETER(MultiSGDMomParam);
 DMLC_REGISTER_PARAMETER(AdamParam);
 DMLC_REGISTER_PARAMETER(RMSPropParam);
 DMLC_REGISTER_PARAMETER(RMSPropAlexParam);
@@ -68,6 +70,139 @@ Where the parameter ``momentum`` is the decay rate of momentum estimates at each
 .add_argument("mom", "NDArray-or-Symbol", "Momentum")
 .add_arguments(SGDMomParam::__FIELDS__());
 
+NNVM_REGISTER_OP(multi_sgd_update)
+.describe(R"code(Update function for Stochastic Gradient Descent (SDG) optimizer, applied to
+``num_weights`` weights at once.
+
+The inputs are ``weight_0, grad_0, weight_1, grad_1, ...`` and output ``i`` is the
+update of ``weight_i``, as computed by ``sgd_update``. Updating all the weights of a
+model in one call saves the dispatch of one operator per weight.
+
+)code" ADD_FILELINE)
+.set_num_inputs([](const nnvm::NodeAttrs& attrs) {
+    return static_cast<uint32_t>(dmlc::get<MultiSGDParam>(attrs.parsed).num_weights * 2);
+  })
+.set_num_outputs([](const nnvm::NodeAttrs& attrs) {
+    return static_cast<uint32_t>(dmlc::get<MultiSGDParam>(attrs.parsed).num_weights);
+  })
+.set_attr_parser(ParamParser<MultiSGDParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames",
+  [](const NodeAttrs& attrs) {
+    const int num_weights = dmlc::get<MultiSGDParam>(attrs.parsed).num_weights;
+    std::vector<std::string> ret;
+    for (int i = 0; i < num_weights; ++i) {
+      ret.push_back(std::string("weight_") + std::to_string(i));
+      ret.push_back(std::string("grad_") + std::to_string(i));
+    }
+    return ret;
+  })
+.set_attr<nnvm::FInferShape>("FInferShape", MultiUpdateShape<2>)
+.set_attr<nnvm::FInferType>("FInferType", MultiUpdateType<2>)
+.set_attr<FCompute>("FCompute<cpu>", MultiSGDUpdate<cpu>)
+.add_argument("data", "NDArray-or-Symbol[]", "Weights and gradients, interleaved")
+.add_arguments(MultiSGDParam::__FIELDS__());
+
+NNVM_REGISTER_OP(multi_sgd_mom_update)
+.describe(R"code(Momentum update function for Stochastic Gradient Descent (SDG) optimizer,
+applied to ``num_weights`` weights at once.
+
+The inputs are ``weight_0, grad_0, mom_0, weight_1, grad_1, mom_1, ...`` and output
+``i`` is the update of ``weight_i``, as computed by ``sgd_mom_update``, which also
+updates ``mom_i``.
+
+)code" ADD_FILELINE)
+.set_num_inputs([](const nnvm::NodeAttrs& attrs) {
+    return static_cast<uint32_t>(dmlc::get<MultiSGDMomParam>(attrs.parsed).num_weights * 3);
+  })
+.set_num_outputs([](const nnvm::NodeAttrs& attrs) {
+    return static_cast<uint32_t>(dmlc::get<MultiSGDMomParam>(attrs.parsed).num_weights);
+  })
+.set_attr_parser(ParamParser<MultiSGDMomParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames",
+  [](const NodeAttrs& attrs) {
+    const int num_weights = dmlc::get<MultiSGDMomParam>(attrs.parsed).num_weights;
+    std::vector<std::string> ret;
+    for (int i = 0; i < num_weights; ++i) {
+      ret.push_back(std::string("weight_") + std::to_string(i));
+      ret.push_back(std::string("grad_") + std::to_string(i));
+      ret.push_back(std::string("mom_") + std::to_string(i));
+    }
+    return ret;
+  })
+.set_attr<nnvm::FInferShape>("FInferShape", MultiUpdateShape<3>)
+.set_attr<nnvm::FInferType>("FInferType", MultiUpdateType<3>)
+.set_attr<nnvm::FMutateInputs>("FMutateInputs",
+  [](const nnvm::NodeAttrs& attrs) {
+    const int num_weights = dmlc::get<MultiSGDMomParam>(attrs.parsed).num_weights;
+    std::vector<uint32_t> ret;
+    for (int i = 0; i < num_weights; ++i) ret.push_back(3 * i + 2);
+    return ret;
+  })
+.set_attr<FCompute>("FCompute<cpu>", MultiSGDMomUpdate<cpu>)
+.add_argument("data", "NDArray-or-Symbol[]", "Weights, gradients and momentums, interleaved")
+.add_arguments(MultiSGDMomParam::__FIELDS__());
+
+NNVM_REGISTER_OP(sparse_sgd_update)
+.describe(R"code(Update function for Stochastic Gradient Descent (SDG) optimizer with a
+row-sparse gradient.
+
+The gradient is given as ``row_ids`` and ``grad`` where ``grad[i]`` is the gradient of row
+``row_ids[i]`` of the weight, as produced by ``embedding_row_sparse_grad``. Only these rows
+are updated using::
+
+ weight[row_ids[i]] = weight[row_ids[i]] - learning_rate * grad[i]
+
+Row ids must be unique, negative ids are ignored. Weight decay is only applied to the
+updated rows.
+
+)code" ADD_FILELINE)
+.set_num_inputs(3)
+.set_num_outputs(1)
+.set_attr_parser(ParamParser<SGDParam>)
+.set_attr<nnvm::FInferShape>("FInferShape", SparseUpdateShape)
+.set_attr<nnvm::FInferType>("FInferType", SparseUpdateType)
+.set_attr<nnvm::FInplaceOption>("FInplaceOption",
+  [](const NodeAttrs& attrs) {
+    return std::vector<std::pair<int, int> >{{0, 0}};
+  })
+.set_attr<FCompute>("FCompute<cpu>", SparseSGDUpdate<cpu>)
+.add_argument("weight", "NDArray-or-Symbol", "Weight")
+.add_argument("grad", "NDArray-or-Symbol", "Gradient of the rows in row_ids")
+.add_argument("row_ids", "NDArray-or-Symbol", "Unique row ids of the gradient")
+.add_arguments(SGDParam::__FIELDS__());
+
+NNVM_REGISTER_OP(sparse_sgd_mom_update)
+.describe(R"code(Momentum update function for Stochastic Gradient Descent (SDG) optimizer
+with a row-sparse gradient.
+
+Only the rows listed in ``row_ids`` are updated, see ``sparse_sgd_update``::
+
+  v[row_ids[i]] = momentum * v[row_ids[i]] - learning_rate * grad[i]
+  weight[row_ids[i]] += v[row_ids[i]]
+
+The momentum of the other rows is left untouched.
+
+)code" ADD_FILELINE)
+.set_num_inputs(4)
+.set_num_outputs(1)
+.set_attr_parser(ParamParser<SGDMomParam>)
+.set_attr<nnvm::FInferShape>("FInferShape", SparseUpdateShape)
+.set_attr<nnvm::FInferType>("FInferType", SparseUpdateType)
+.set_attr<nnvm::FInplaceOption>("FInplaceOption",
+  [](const NodeAttrs& attrs) {
+    return std::vector<std::pair<int, int> >{{0, 0}};
+  })
+.set_attr<nnvm::FMutateInputs>("FMutateInputs",
+  [](const nnvm::NodeAttrs& attrs) {
+    return std::vector<uint32_t>{3};
+  })
+.set_attr<FCompute>("FCompute<cpu>", SparseSGDMomUpdate<cpu>)
+.add_argument("weight", "NDArray-or-Symbol", "Weight")
+.add_argument("grad", "NDArray-or-Symbol", "Gradient of the rows in row_ids")
+.add_argument("row_ids", "NDArray-or-Symbol", "Unique row ids of the gradient")
+.add_argument("mom", "NDArray-or-Symbol", "Momentum")
+.add_arguments(SGDMomParam::__FIELDS__());
+
 NNVM_REGISTER_OP(adam_update)
 .describe(R"code(Update function for Adam optimizer. Adam is seen as a generalization
 of AdaGrad.
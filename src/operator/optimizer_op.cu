@@ -15,6 +15,18 @@ NNVM_REGISTER_OP(sgd_update)
 NNVM_REGISTER_OP(sgd_mom_update)
 .set_attr<FCompute>("FCompute<gpu>", SGDMomUpdate<gpu>);
 
+NNVM_REGISTER_OP(multi_sgd_update)
+.set_attr<FCompute>("FCompute<gpu>", MultiSGDUpdate<gpu>);
+
+NNVM_REGISTER_OP(multi_sgd_mom_update)
+.set_attr<FCompute>("FCompute<gpu>", MultiSGDMomUpdate<gpu>);
+
+NNVM_REGISTER_OP(sparse_sgd_update)
+.set_attr<FCompute>("FCompute<gpu>", SparseSGDUpdate<gpu>);
+
+NNVM_REGISTER_OP(sparse_sgd_mom_update)
+.set_attr<FCompute>("FCompute<gpu>", SparseSGDMomUpdate<gpu>);
+
 NNVM_REGISTER_OP(adam_update)
 .set_attr<FCompute>("FCompute<gpu>", AdamUpdate<gpu>);
 
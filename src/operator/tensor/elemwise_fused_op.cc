@@ -0,0 +1,80 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file elemwise_fused_op.cc
+ * \brief CPU Implementation of fused elementwise operator.
+ */
+#include <unordered_map>
+#include "./elemwise_fused_op.h"
+
+namespace mxnet {
+namespace op {
+
+int FusedElemwiseOpCode(const nnvm::NodeAttrs& attrs) {
+  using namespace fused;
+  static const std::unordered_map<std::string, int> kOpCodes = {
+    {"relu", kRelu}, {"sigmoid", kSigmoid}, {"tanh", kTanh},
+    {"negative", kNegative}, {"abs", kAbs}, {"sign", kSign},
+    {"square", kSquare}, {"sqrt", kSqrt}, {"rsqrt", kRsqrt},
+    {"exp", kExp}, {"log", kLog}, {"log1p", kLog1p}, {"expm1", kExpm1},
+    {"elemwise_add", kAdd}, {"_sub", kSub}, {"_mul", kMul}, {"_div", kDiv},
+    {"_maximum", kMaximum}, {"_minimum", kMinimum},
+    {"_power", kPower}, {"_hypot", kHypot},
+    {"_plus_scalar", kPlusScalar}, {"_minus_scalar", kMinusScalar},
+    {"_rminus_scalar", kRMinusScalar}, {"_mul_scalar", kMulScalar},
+    {"_div_scalar", kDivScalar}, {"_rdiv_scalar", kRDivScalar},
+    {"_maximum_scalar", kMaximumScalar}, {"_minimum_scalar", kMinimumScalar},
+    {"_power_scalar", kPowerScalar}, {"_rpower_scalar", kRPowerScalar}
+  };
+  static const std::unordered_map<std::string, int> kActCodes = {
+    {"relu", kRelu}, {"sigmoid", kSigmoid}, {"tanh", kTanh}, {"softrelu", kSoftReLU}
+  };
+  if (attrs.op == nullptr) return -1;
+  if (attrs.op->name == "Activation") {
+    auto it = attrs.dict.find("act_type");
+    if (it == attrs.dict.end()) return -1;
+    auto code = kActCodes.find(it->second);
+    return code == kActCodes.end() ? -1 : code->second;
+  }
+  auto it = kOpCodes.find(attrs.op->name);
+  if (it == kOpCodes.end()) return -1;
+  if (it->second >= kPlusScalar && attrs.dict.count("scalar") == 0) return -1;
+  return it->second;
+}
+
+inline bool FusedElemwiseShape(const nnvm::NodeAttrs& attrs,
+                               std::vector<TShape> *in_attrs,
+                               std::vector<TShape> *out_attrs) {
+  CHECK_EQ(out_attrs->size(), 1U) << " in operator " << attrs.name;
+  return ElemwiseAttr<TShape, shape_is_none, shape_assign, true, shape_string>(
+    attrs, in_attrs, out_attrs, TShape());
+}
+
+inline bool FusedElemwiseType(const nnvm::NodeAttrs& attrs,
+                              std::vector<int> *in_attrs,
+                              std::vector<int> *out_attrs) {
+  CHECK_EQ(out_attrs->size(), 1U) << " in operator " << attrs.name;
+  return ElemwiseAttr<int, type_is_none, type_assign, true, type_string>(
+    attrs, in_attrs, out_attrs, -1);
+}
+
+// internal operator, only created by the FuseElemwise pass of the graph executor.
+// The program is passed through attrs.parsed, so it has no attribute parser.
+NNVM_REGISTER_OP(_FusedElemwise)
+.set_num_inputs([](const NodeAttrs& attrs) {
+    return static_cast<uint32_t>(nnvm::get<FusedElemwiseParam>(attrs.parsed).num_inputs);
+  })
+.set_num_outputs(1)
+.set_attr<nnvm::FInferShape>("FInferShape", FusedElemwiseShape)
+.set_attr<nnvm::FInferType>("FInferType", FusedElemwiseType)
+.set_attr<nnvm::FInplaceOption>("FInplaceOption",
+  [](const NodeAttrs& attrs) {
+    // every block reads all of its inputs before writing the output
+    std::vector<std::pair<int, int> > ret;
+    int num_inputs = nnvm::get<FusedElemwiseParam>(attrs.parsed).num_inputs;
+    for (int i = 0; i < num_inputs; ++i) ret.emplace_back(i, 0);
+    return ret;
+  })
+.set_attr<FCompute>("FCompute<cpu>", FusedElemwiseCompute<cpu>);
+
+}  // namespace op
+}  // namespace mxnet
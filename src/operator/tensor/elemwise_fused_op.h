@@ -0,0 +1,186 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file elemwise_fused_op.h
+ * \brief Fused chains of elementwise operators, created by the FuseElemwise pass.
+ */
+#ifndef MXNET_OPERATOR_TENSOR_ELEMWISE_FUSED_OP_H_
+#define MXNET_OPERATOR_TENSOR_ELEMWISE_FUSED_OP_H_
+
+#include <mxnet/operator_util.h>
+#include <vector>
+#include <string>
+#include <utility>
+#include "../mxnet_op.h"
+#include "../mshadow_op.h"
+#include "../elemwise_op_common.h"
+
+namespace mxnet {
+namespace op {
+namespace fused {
+/*! \brief elementwise functions that can appear inside a fused node */
+enum FusedOpCode {
+  // unary
+  kRelu, kSigmoid, kTanh, kSoftReLU, kNegative, kAbs, kSign, kSquare,
+  kSqrt, kRsqrt, kExp, kLog, kLog1p, kExpm1,
+  // binary, both operands are arrays
+  kAdd, kSub, kMul, kDiv, kMaximum, kMinimum, kPower, kHypot,
+  // binary, rhs is the scalar of the instruction
+  kPlusScalar, kMinusScalar, kRMinusScalar, kMulScalar, kDivScalar, kRDivScalar,
+  kMaximumScalar, kMinimumScalar, kPowerScalar, kRPowerScalar
+};
+/*! \brief number of elements processed per block by one thread */
+const int kBlockSize = 256;
+/*! \brief maximum number of instructions in a fused node */
+const int kMaxInstructions = 16;
+}  // namespace fused
+
+/*!
+ * \brief one instruction of a fused elementwise program.
+ *  Operand index i < num_inputs refers to the i-th input of the node,
+ *  otherwise to the result of instruction (i - num_inputs).
+ */
+struct FusedElemwiseInstr {
+  int opcode;
+  int lhs;
+  int rhs;
+  double scalar;
+};
+
+/*! \brief parsed attribute of _FusedElemwise, the last instruction yields the output */
+struct FusedElemwiseParam {
+  int num_inputs;
+  std::vector<FusedElemwiseInstr> program;
+};
+
+/*!
+ * \brief get the opcode of a node if it can be fused.
+ * \param attrs attributes of the node.
+ * \return the opcode, or -1 if the node is not a fusable elementwise op.
+ */
+int FusedElemwiseOpCode(const nnvm::NodeAttrs& attrs);
+
+/*! \brief whether opcode takes a second array operand */
+inline bool FusedIsBinary(int opcode) {
+  return opcode >= fused::kAdd && opcode < fused::kPlusScalar;
+}
+
+template<typename OP, typename DType>
+MSHADOW_CINLINE void FusedUnaryBlock(int n, DType *out, const DType *a) {
+  for (int i = 0; i < n; ++i) out[i] = OP::Map(a[i]);
+}
+
+template<typename OP, typename DType>
+MSHADOW_CINLINE void FusedBinaryBlock(int n, DType *out, const DType *a, const DType *b) {
+  for (int i = 0; i < n; ++i) out[i] = OP::Map(a[i], b[i]);
+}
+
+template<typename OP, typename DType>
+MSHADOW_CINLINE void FusedScalarBlock(int n, DType *out, const DType *a, DType b) {
+  for (int i = 0; i < n; ++i) out[i] = OP::Map(a[i], b);
+}
+
+/*! \brief apply one instruction to a block of n elements */
+template<typename DType>
+inline void FusedApplyBlock(const FusedElemwiseInstr& ins, int n, DType *out,
+                            const DType *a, const DType *b) {
+  using namespace fused;
+  const DType s = DType(ins.scalar);
+  switch (ins.opcode) {
+    case kRelu: FusedUnaryBlock<mshadow_op::relu>(n, out, a); break;
+    case kSigmoid: FusedUnaryBlock<mshadow_op::sigmoid>(n, out, a); break;
+    case kTanh: FusedUnaryBlock<mshadow_op::tanh>(n, out, a); break;
+    case kSoftReLU: FusedUnaryBlock<mshadow_op::softrelu>(n, out, a); break;
+    case kNegative: FusedUnaryBlock<mshadow_op::negation>(n, out, a); break;
+    case kAbs: FusedUnaryBlock<mshadow_op::abs>(n, out, a); break;
+    case kSign: FusedUnaryBlock<mshadow_op::sign>(n, out, a); break;
+    case kSquare: FusedUnaryBlock<mshadow_op::square>(n, out, a); break;
+    case kSqrt: FusedUnaryBlock<mshadow_op::square_root>(n, out, a); break;
+    case kRsqrt: FusedUnaryBlock<mshadow_op::reciprocal_square_root>(n, out, a); break;
+    case kExp: FusedUnaryBlock<mshadow_op::exp>(n, out, a); break;
+    case kLog: FusedUnaryBlock<mshadow_op::log>(n, out, a); break;
+    case kLog1p: FusedUnaryBlock<mshadow_op::log1p>(n, out, a); break;
+    case kExpm1: FusedUnaryBlock<mshadow_op::expm1>(n, out, a); break;
+    case kAdd: FusedBinaryBlock<mshadow::op::plus>(n, out, a, b); break;
+    case kSub: FusedBinaryBlock<mshadow::op::minus>(n, out, a, b); break;
+    case kMul: FusedBinaryBlock<mshadow::op::mul>(n, out, a, b); break;
+    case kDiv: FusedBinaryBlock<mshadow::op::div>(n, out, a, b); break;
+    case kMaximum: FusedBinaryBlock<mshadow_op::maximum>(n, out, a, b); break;
+    case kMinimum: FusedBinaryBlock<mshadow_op::minimum>(n, out, a, b); break;
+    case kPower: FusedBinaryBlock<mshadow_op::power>(n, out, a, b); break;
+    case kHypot: FusedBinaryBlock<mshadow_op::hypot>(n, out, a, b); break;
+    case kPlusScalar: FusedScalarBlock<mshadow::op::plus>(n, out, a, s); break;
+    case kMinusScalar: FusedScalarBlock<mshadow::op::minus>(n, out, a, s); break;
+    case kRMinusScalar: FusedScalarBlock<mshadow_op::rminus>(n, out, a, s); break;
+    case kMulScalar: FusedScalarBlock<mshadow::op::mul>(n, out, a, s); break;
+    case kDivScalar: FusedScalarBlock<mshadow::op::div>(n, out, a, s); break;
+    case kRDivScalar: FusedScalarBlock<mshadow_op::rdiv>(n, out, a, s); break;
+    case kMaximumScalar: FusedScalarBlock<mshadow_op::maximum>(n, out, a, s); break;
+    case kMinimumScalar: FusedScalarBlock<mshadow_op::minimum>(n, out, a, s); break;
+    case kPowerScalar: FusedScalarBlock<mshadow_op::power>(n, out, a, s); break;
+    case kRPowerScalar: FusedScalarBlock<mshadow_op::rpower>(n, out, a, s); break;
+    default: LOG(FATAL) << "unknown fused opcode " << ins.opcode;
+  }
+}
+
+/*!
+ * \brief kernel that evaluates the whole fused program on one block of elements.
+ *  Intermediate results live in a stack buffer of kBlockSize elements per
+ *  instruction, so every input is read once and the output written once.
+ */
+template<int req>
+struct fused_elemwise_block {
+  template<typename DType>
+  MSHADOW_CINLINE static void Map(int block, int size, DType *out,
+                                  const DType* const* in,
+                                  const FusedElemwiseInstr *program,
+                                  int num_instr, int num_inputs) {
+    DType buf[fused::kMaxInstructions][fused::kBlockSize];
+    const int begin = block * fused::kBlockSize;
+    const int n = (size - begin < fused::kBlockSize) ? size - begin : fused::kBlockSize;
+    auto operand = [&](int idx) -> const DType* {
+      return idx < num_inputs ? in[idx] + begin : buf[idx - num_inputs];
+    };
+    for (int k = 0; k < num_instr; ++k) {
+      const FusedElemwiseInstr& ins = program[k];
+      FusedApplyBlock(ins, n, buf[k], operand(ins.lhs),
+                      FusedIsBinary(ins.opcode) ? operand(ins.rhs) : nullptr);
+    }
+    const DType *res = buf[num_instr - 1];
+    for (int i = 0; i < n; ++i) {
+      KERNEL_ASSIGN(out[begin + i], req, res[i]);
+    }
+  }
+};
+
+template<typename xpu>
+void FusedElemwiseCompute(const nnvm::NodeAttrs& attrs,
+                          const OpContext& ctx,
+                          const std::vector<TBlob>& inputs,
+                          const std::vector<OpReqType>& req,
+                          const std::vector<TBlob>& outputs) {
+  using namespace mshadow;
+  using namespace mxnet_op;
+  const FusedElemwiseParam& param = nnvm::get<FusedElemwiseParam>(attrs.parsed);
+  Stream<xpu> *s = ctx.get_stream<xpu>();
+  CHECK_EQ(inputs.size(), static_cast<size_t>(param.num_inputs));
+  CHECK_EQ(outputs.size(), 1U);
+  if (req[0] == kNullOp) return;
+  const int size = static_cast<int>(outputs[0].Size());
+  const int num_blocks = (size + fused::kBlockSize - 1) / fused::kBlockSize;
+  MSHADOW_TYPE_SWITCH(outputs[0].type_flag_, DType, {
+    std::vector<const DType*> in_ptrs(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      in_ptrs[i] = inputs[i].dptr<DType>();
+    }
+    MXNET_ASSIGN_REQ_SWITCH(req[0], Req, {
+      Kernel<fused_elemwise_block<Req>, xpu>::Launch(
+        s, num_blocks, size, outputs[0].dptr<DType>(), in_ptrs.data(),
+        param.program.data(), static_cast<int>(param.program.size()),
+        param.num_inputs);
+    });
+  });
+}
+
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_TENSOR_ELEMWISE_FUSED_OP_H_
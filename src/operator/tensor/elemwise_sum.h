@@ -8,6 +8,7 @@
 #define MXNET_OPERATOR_TENSOR_ELEMWISE_SUM_H_
 
 #include <dmlc/logging.h>
+#include <algorithm>
 #include <cstring>
 #include <vector>
 #include "../operator_common.h"
@@ -16,6 +17,76 @@
 
 namespace mxnet {
 namespace op {
+/*! \brief number of elements summed at once, small enough for the L1 cache */
+const size_t kElementwiseSumBlock = 1024;
+/*! \brief arrays with fewer elements are summed by one thread */
+const size_t kElementwiseSumParallelSize = 1 << 16;
+
+/*!
+ * \brief sum the block [begin, end) of in into out, in the order of in.
+ *  The block is accumulated in a local buffer, so out may be any of in.
+ */
+template<typename DType>
+inline void ElementwiseSumBlock(const std::vector<const DType*> &in, DType *out,
+                                size_t begin, size_t end, OpReqType req) {
+  DType acc[kElementwiseSumBlock];
+  const size_t n = end - begin;
+  const DType *in_0 = in[0] + begin;
+  for (size_t j = 0; j < n; ++j) acc[j] = in_0[j];
+  size_t i = 1;
+  for (; i + 4 <= in.size(); i += 4) {
+    const DType *in_1 = in[i] + begin, *in_2 = in[i + 1] + begin;
+    const DType *in_3 = in[i + 2] + begin, *in_4 = in[i + 3] + begin;
+    for (size_t j = 0; j < n; ++j) {
+      acc[j] = acc[j] + in_1[j] + in_2[j] + in_3[j] + in_4[j];
+    }
+  }
+  for (; i < in.size(); ++i) {
+    const DType *in_1 = in[i] + begin;
+    for (size_t j = 0; j < n; ++j) acc[j] = acc[j] + in_1[j];
+  }
+  DType *dst = out + begin;
+  if (req == kAddTo) {
+    for (size_t j = 0; j < n; ++j) dst[j] = dst[j] + acc[j];
+  } else {
+    for (size_t j = 0; j < n; ++j) dst[j] = acc[j];
+  }
+}
+
+/*!
+ * \brief out = in[0] + ... + in[n - 1] on CPU, shared by add_n, NDArray
+ *  ElementwiseSum and the CPU reduction of KVStore.
+ *  The arrays are summed block by block, four inputs at a time, and large
+ *  arrays are split over OpenMP threads by blocks.
+ * \param size number of elements of each array
+ * \param req how to write out, out may be one of in
+ * \param nthread number of threads, 0 for the OpenMP default
+ */
+template<typename DType>
+inline void ElementwiseSumCPU(const std::vector<const DType*> &in, DType *out,
+                              size_t size, OpReqType req, int nthread = 0) {
+  if (req == kNullOp || size == 0) return;
+  CHECK(!in.empty());
+  const long nblock = (size + kElementwiseSumBlock - 1) / kElementwiseSumBlock;  // NOLINT(*)
+  if (nthread == 1 || size < kElementwiseSumParallelSize) {
+    for (long b = 0; b < nblock; ++b) {  // NOLINT(*)
+      ElementwiseSumBlock(in, out, b * kElementwiseSumBlock,
+                          std::min(size, (b + 1) * kElementwiseSumBlock), req);
+    }
+  } else if (nthread <= 0) {
+    #pragma omp parallel for schedule(static)
+    for (long b = 0; b < nblock; ++b) {  // NOLINT(*)
+      ElementwiseSumBlock(in, out, b * kElementwiseSumBlock,
+                          std::min(size, (b + 1) * kElementwiseSumBlock), req);
+    }
+  } else {
+    #pragma omp parallel for schedule(static) num_threads(nthread)
+    for (long b = 0; b < nblock; ++b) {  // NOLINT(*)
+      ElementwiseSumBlock(in, out, b * kElementwiseSumBlock,
+                          std::min(size, (b + 1) * kElementwiseSumBlock), req);
+    }
+  }
+}
 
 template<typename xpu, typename DType>
 void ElementWiseSumCompute_(const nnvm::NodeAttrs& attrs,
@@ -74,6 +145,20 @@ void ElementWiseSumCompute(const nnvm::NodeAttrs& attrs,
     });
 }
 
+template<>
+inline void ElementWiseSumCompute<cpu>(const nnvm::NodeAttrs& attrs,
+                                       const OpContext& ctx,
+                                       const std::vector<TBlob>& inputs,
+                                       const std::vector<OpReqType>& req,
+                                       const std::vector<TBlob>& outputs) {
+  CHECK_EQ(outputs.size(), 1U);
+  MSHADOW_TYPE_SWITCH(outputs[0].type_flag_, DType, {
+      std::vector<const DType*> in(inputs.size());
+      for (size_t i = 0; i < inputs.size(); ++i) in[i] = inputs[i].dptr<DType>();
+      ElementwiseSumCPU(in, outputs[0].dptr<DType>(), outputs[0].Size(), req[0]);
+    });
+}
+
 }  // namespace op
 }  // namespace mxnet
 #endif  // MXNET_OPERATOR_TENSOR_ELEMWISE_SUM_H_
@@ -86,6 +86,46 @@ NNVM_REGISTER_OP(_backward_Embedding)
 .set_attr<nnvm::TIsBackward>("TIsBackward", true)
 .set_attr<FCompute>("FCompute<cpu>", EmbeddingOpBackward<cpu>);
 
+NNVM_REGISTER_OP(_contrib_embedding_row_sparse_grad)
+.describe(R"code(Computes the gradient of the Embedding weight in row-sparse form.
+
+Given the indices ``data`` fed to Embedding and the gradient ``grad`` of its output,
+returns ``(row_ids, values)``: the sorted unique row indices seen in ``data`` and the
+summed gradient of each of these rows. Both outputs have one entry per element of
+``data``; the unused tail is padded with ``-1`` in ``row_ids`` and zeros in ``values``.
+
+Unlike the dense gradient, whose size is ``(input_dim, output_dim)``, the cost only
+depends on the number of indices, which makes it suitable for large vocabularies.
+The result can be fed to ``sparse_sgd_update``, ``sparse_sgd_mom_update`` and
+``KVStore.push_row_sparse``.
+
+Examples::
+
+  data = [2, 0, 2]
+  grad = [[1, 1], [2, 2], [3, 3]]
+
+  embedding_row_sparse_grad(data, grad, input_dim=4, output_dim=2) =
+      [0, 2, -1], [[2, 2], [4, 4], [0, 0]]
+
+)code" ADD_FILELINE)
+.set_num_inputs(2)
+.set_num_outputs(2)
+.set_attr_parser(ParamParser<EmbeddingParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames",
+  [](const NodeAttrs& attrs) {
+    return std::vector<std::string>{"data", "grad"};
+  })
+.set_attr<nnvm::FListOutputNames>("FListOutputNames",
+  [](const NodeAttrs& attrs) {
+    return std::vector<std::string>{"row_ids", "values"};
+  })
+.set_attr<nnvm::FInferShape>("FInferShape", EmbeddingRowSparseGradShape)
+.set_attr<nnvm::FInferType>("FInferType", EmbeddingRowSparseGradType)
+.set_attr<FCompute>("FCompute<cpu>", EmbeddingRowSparseGradCompute)
+.add_argument("data", "NDArray-or-Symbol", "The indices fed to the embedding operator.")
+.add_argument("grad", "NDArray-or-Symbol", "The gradient of the embedding output.")
+.add_arguments(EmbeddingParam::__FIELDS__());
+
 
 NNVM_REGISTER_OP(take)
 .describe(R"code(Takes elements from an input array along the given axis.
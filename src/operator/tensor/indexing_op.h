@@ -315,6 +315,111 @@ void EmbeddingOpBackward(const nnvm::NodeAttrs& attrs,
   });
 }
 
+/*!
+ * \brief CPU: Merge the rows of a row-sparse gradient that share an index.
+ *  A row-sparse gradient is a pair (idx, val) where val[i] is the gradient of row idx[i].
+ *  On return out_idx holds the sorted unique indices padded with -1, and out_val the
+ *  summed rows padded with zeros. Both outputs have num_rows rows and must not alias
+ *  the inputs.
+ * \param clip_bound if positive, indices are clipped to [0, clip_bound - 1] like Embedding
+ *  does, otherwise rows with a negative index are dropped
+ * \return the number of unique rows
+ */
+template<typename IType, typename OType, typename DType>
+inline index_t RowSparseMerge(const IType *idx, const DType *val,
+                              index_t num_rows, index_t row_length, int64_t clip_bound,
+                              OType *out_idx, DType *out_val) {
+  std::vector<std::pair<int64_t, index_t> > order;
+  order.reserve(num_rows);
+  for (index_t i = 0; i < num_rows; ++i) {
+    int64_t k = static_cast<int64_t>(idx[i]);
+    if (clip_bound > 0) {
+      k = std::min(std::max(k, static_cast<int64_t>(0)), clip_bound - 1);
+    } else if (k < 0) {
+      continue;
+    }
+    order.emplace_back(k, i);
+  }
+  std::sort(order.begin(), order.end());
+  std::vector<index_t> seg_start;
+  for (index_t i = 0; i < order.size(); ++i) {
+    if (i == 0 || order[i].first != order[i - 1].first) seg_start.push_back(i);
+  }
+  const index_t num_unique = seg_start.size();
+  seg_start.push_back(order.size());
+  #pragma omp parallel for
+  for (int j = 0; j < static_cast<int>(num_rows); ++j) {
+    DType *dst = out_val + static_cast<index_t>(j) * row_length;
+    if (static_cast<index_t>(j) >= num_unique) {
+      out_idx[j] = static_cast<OType>(-1);
+      std::fill(dst, dst + row_length, DType(0));
+      continue;
+    }
+    out_idx[j] = static_cast<OType>(order[seg_start[j]].first);
+    const DType *src = val + order[seg_start[j]].second * row_length;
+    std::copy(src, src + row_length, dst);
+    for (index_t p = seg_start[j] + 1; p < seg_start[j + 1]; ++p) {
+      src = val + order[p].second * row_length;
+      for (index_t d = 0; d < row_length; ++d) dst[d] += src[d];
+    }
+  }
+  return num_unique;
+}
+
+inline bool EmbeddingRowSparseGradShape(const nnvm::NodeAttrs& attrs,
+                                        std::vector<TShape> *in_attrs,
+                                        std::vector<TShape> *out_attrs) {
+  CHECK_EQ(in_attrs->size(), 2U);
+  CHECK_EQ(out_attrs->size(), 2U);
+  const EmbeddingParam& param = nnvm::get<EmbeddingParam>(attrs.parsed);
+  const TShape &dshape = (*in_attrs)[embedding::kData];
+  if (dshape.ndim() == 0) return false;
+  TShape gshape(dshape.ndim() + 1);
+  for (size_t i = 0; i < dshape.ndim(); ++i) gshape[i] = dshape[i];
+  gshape[dshape.ndim()] = param.output_dim;
+  SHAPE_ASSIGN_CHECK(*in_attrs, 1, gshape);
+  SHAPE_ASSIGN_CHECK(*out_attrs, 0, mshadow::Shape1(dshape.Size()));
+  SHAPE_ASSIGN_CHECK(*out_attrs, 1, mshadow::Shape2(dshape.Size(), param.output_dim));
+  return true;
+}
+
+inline bool EmbeddingRowSparseGradType(const nnvm::NodeAttrs& attrs,
+                                       std::vector<int> *in_attrs,
+                                       std::vector<int> *out_attrs) {
+  CHECK_EQ(in_attrs->size(), 2U);
+  CHECK_EQ(out_attrs->size(), 2U);
+  CHECK_NE((*in_attrs)[0], -1) << "First input must have specified type";
+  TYPE_ASSIGN_CHECK(*out_attrs, 0, mshadow::kInt32);
+  TYPE_ASSIGN_CHECK(*out_attrs, 1, (*in_attrs)[1]);
+  TYPE_ASSIGN_CHECK(*in_attrs, 1, (*out_attrs)[1]);
+  return (*in_attrs)[1] != -1;
+}
+
+/*!
+ * \brief CPU: row-sparse gradient of the Embedding weight. Instead of the dense
+ *  (input_dim, output_dim) matrix written by EmbeddingOpBackward, only the rows
+ *  seen in data are produced, so the cost is independent of the vocabulary size.
+ */
+inline void EmbeddingRowSparseGradCompute(const nnvm::NodeAttrs& attrs,
+                                          const OpContext& ctx,
+                                          const std::vector<TBlob>& inputs,
+                                          const std::vector<OpReqType>& req,
+                                          const std::vector<TBlob>& outputs) {
+  CHECK_EQ(inputs.size(), 2U);
+  CHECK_EQ(outputs.size(), 2U);
+  CHECK_EQ(req[0], kWriteTo);
+  CHECK_EQ(req[1], kWriteTo);
+  const EmbeddingParam& param = nnvm::get<EmbeddingParam>(attrs.parsed);
+  const index_t num_rows = inputs[embedding::kData].Size();
+  MSHADOW_TYPE_SWITCH(inputs[1].type_flag_, DType, {
+    MSHADOW_TYPE_SWITCH(inputs[0].type_flag_, IType, {
+      RowSparseMerge(inputs[0].dptr<IType>(), inputs[1].dptr<DType>(),
+                     num_rows, param.output_dim, param.input_dim,
+                     outputs[0].dptr<int32_t>(), outputs[1].dptr<DType>());
+    });
+  });
+}
+
 namespace take_ {  // to avoid name conflict
 enum TakeOpInputs {kArr, kIdx};
 enum TakeOpOutputs {kOut};
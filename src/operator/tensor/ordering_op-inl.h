@@ -9,6 +9,8 @@
 #include <mxnet/operator_util.h>
 #include <dmlc/optional.h>
 #include <mshadow/tensor.h>
+#include <algorithm>
+#include <utility>
 #include <vector>
 #include <type_traits>
 #include "../mshadow_op.h"
@@ -132,6 +134,75 @@ inline void ParseTopKParam(const TShape& src_shape, const TopKParam& param, TSha
                                       << *element_num << ", get k = " << *k;
 }
 
+/*!
+ * \brief CPU implementation of the TopK operation. Each row along the axis is
+ *  processed independently and in parallel: the k best elements are selected with
+ *  nth_element in O(n) and only these are sorted, so a full sort only happens when
+ *  k equals the axis length. Ties are ordered by index, like the stable sort.
+ */
+inline void TopKImplCPU(const TBlob& src,
+                        const std::vector<TBlob>& ret,
+                        const TopKParam& param) {
+  for (auto ret_ele : ret) {
+    CHECK_EQ(ret_ele.type_flag_, src.type_flag_);
+  }
+  int batch_size, element_num;  // number of batches + the size of each batch
+  int axis = 0;
+  bool do_transpose = false;
+  bool is_ascend = false;
+  int k = 0;
+  TShape target_shape;
+  ParseTopKParam(src.shape_, param,
+                 &target_shape, &batch_size, &element_num, &axis, &k, &do_transpose, &is_ascend);
+  // the rows are strided by `inner` when the axis is not the last one
+  const index_t inner = static_cast<bool>(param.axis) ?
+                        src.shape_.ProdShape(axis + 1, src.shape_.ndim()) : 1;
+  const bool is_mask = param.ret_typ == topk_enum::kReturnMask;
+  const index_t ret_len = is_mask ? element_num : k;
+  const real_t *dat = src.dptr<real_t>();
+  real_t *ret_value = nullptr, *ret_indices = nullptr, *ret_mask = nullptr;
+  if (is_mask) {
+    ret_mask = ret[0].dptr<real_t>();
+    std::fill(ret_mask, ret_mask + ret[0].Size(), real_t(0));
+  } else if (param.ret_typ == topk_enum::kReturnIndices) {
+    ret_indices = ret[0].dptr<real_t>();
+  } else if (param.ret_typ == topk_enum::kReturnValue) {
+    ret_value = ret[0].dptr<real_t>();
+  } else {
+    ret_value = ret[0].dptr<real_t>();
+    ret_indices = ret[1].dptr<real_t>();
+  }
+  auto cmp = [is_ascend](const std::pair<real_t, int>& a, const std::pair<real_t, int>& b) {
+    if (a.first != b.first) return is_ascend ? a.first < b.first : a.first > b.first;
+    return a.second < b.second;
+  };
+  #pragma omp parallel
+  {
+    std::vector<std::pair<real_t, int> > row(element_num);
+    #pragma omp for
+    for (int b = 0; b < batch_size; ++b) {
+      const index_t outer_idx = b / inner, inner_idx = b % inner;
+      const index_t in_base = outer_idx * element_num * inner + inner_idx;
+      for (int j = 0; j < element_num; ++j) {
+        row[j] = std::make_pair(dat[in_base + j * inner], j);
+      }
+      if (k < element_num) {
+        std::nth_element(row.begin(), row.begin() + (k - 1), row.end(), cmp);
+      }
+      std::sort(row.begin(), row.begin() + k, cmp);
+      const index_t out_base = outer_idx * ret_len * inner + inner_idx;
+      for (int j = 0; j < k; ++j) {
+        if (is_mask) {
+          ret_mask[out_base + row[j].second * inner] = real_t(1);
+          continue;
+        }
+        if (ret_value != nullptr) ret_value[out_base + j * inner] = row[j].first;
+        if (ret_indices != nullptr) ret_indices[out_base + j * inner] = row[j].second;
+      }
+    }
+  }
+}
+
 /*!
    * \brief Implementation of the TopK operation
    *
@@ -152,6 +223,10 @@ void TopKImpl(RunContext ctx,
               const TopKParam& param) {
   using namespace mshadow;
   using namespace mshadow::expr;
+  if (std::is_same<xpu, cpu>::value) {
+    TopKImplCPU(src, ret, param);
+    return;
+  }
   for (auto ret_ele : ret) {
     CHECK_EQ(ret_ele.type_flag_, src.type_flag_);
   }
@@ -23,7 +23,6 @@ DMLC_REGISTER_PARAMETER(SampleGenNegBinomialParam);
   .set_attr_parser(ParamParser<ParamType>)                              \
   .set_attr<nnvm::FInferShape>("FInferShape", InitShape<ParamType>)     \
   .set_attr<nnvm::FInferType>("FInferType", SampleOpType<ParamType>)    \
-  .set_attr<FResourceRequest>("FResourceRequest", SampleResource)       \
   .add_arguments(ParamType::__FIELDS__())
 
 // Add "uniform" alias for backward compatibility
@@ -39,6 +38,7 @@ Samples are uniformly distributed over the half-open interval [low, high)
                                             [ 0.54488319,  0.84725171]]
 
 )code" ADD_FILELINE)
+.set_attr<FResourceRequest>("FResourceRequest", ParallelSampleResource)
 .set_attr<FCompute>("FCompute<cpu>", SampleUniform_<cpu>);
 
 // Add "normal" alias for backward compatibility
@@ -52,31 +52,37 @@ Examples::
   normal(loc=0, scale=1, shape=(2,2)) = [[ 1.89171135, -1.16881478],
                                          [-1.23474145,  1.55807114]]
 )code" ADD_FILELINE)
+.set_attr<FResourceRequest>("FResourceRequest", ParallelSampleResource)
 .set_attr<FCompute>("FCompute<cpu>", SampleNormal_<cpu>);
 
 MXNET_OPERATOR_REGISTER_SAMPLE(random_gamma, SampleGammaParam)
 .add_alias("_sample_gamma")
 .describe("Sample a gamma distribution")
+.set_attr<FResourceRequest>("FResourceRequest", SampleResource)
 .set_attr<FCompute>("FCompute<cpu>", SampleGamma_<cpu>);
 
 MXNET_OPERATOR_REGISTER_SAMPLE(random_exponential, SampleExponentialParam)
 .add_alias("_sample_exponential")
 .describe("Sample an exponential distribution")
+.set_attr<FResourceRequest>("FResourceRequest", SampleResource)
 .set_attr<FCompute>("FCompute<cpu>", SampleExponential_<cpu>);
 
 MXNET_OPERATOR_REGISTER_SAMPLE(random_poisson, SamplePoissonParam)
 .add_alias("_sample_poisson")
 .describe("Sample a Poisson distribution")
+.set_attr<FResourceRequest>("FResourceRequest", SampleResource)
 .set_attr<FCompute>("FCompute<cpu>", SamplePoisson_<cpu>);
 
 MXNET_OPERATOR_REGISTER_SAMPLE(random_negative_binomial, SampleNegBinomialParam)
 .add_alias("_sample_negbinomial")
 .describe("Sample a negative binomial distribution")
+.set_attr<FResourceRequest>("FResourceRequest", SampleResource)
 .set_attr<FCompute>("FCompute<cpu>", SampleNegBinomial_<cpu>);
 
 MXNET_OPERATOR_REGISTER_SAMPLE(random_generalized_negative_binomial, SampleGenNegBinomialParam)
 .add_alias("_sample_gennegbinomial")
 .describe("Sample a generalized negative binomial distribution")
+.set_attr<FResourceRequest>("FResourceRequest", SampleResource)
 .set_attr<FCompute>("FCompute<cpu>", SampleGenNegBinomial_<cpu>);
 
 }  // namespace op
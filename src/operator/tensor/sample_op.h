@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 #include "../mshadow_op.h"
+#include "../mxnet_op.h"
 #include "../elemwise_op_common.h"
 #include "./init_op.h"
 
@@ -214,20 +215,55 @@ struct SampleGenNegBinomialParam : public dmlc::Parameter<SampleGenNegBinomialPa
   }
 };
 
+/*! \brief fill block i of out with values uniform in [low, high) */
+struct SampleUniformKernel {
+  template<typename DType>
+  MSHADOW_XINLINE static void Map(int i, random::RandomRange range, DType *out,
+                                  int size, float low, float high) {
+    float u[random::RandomRange::kBlockSize];
+    range.Uniform(i, u);
+    const int begin = i * random::RandomRange::kBlockSize;
+    for (int j = 0; j < random::RandomRange::kBlockSize && begin + j < size; ++j) {
+      out[begin + j] = DType(low + (high - low) * u[j]);
+    }
+  }
+};
+
+/*! \brief fill block i of out with normal values of mean loc and deviation scale */
+struct SampleNormalKernel {
+  template<typename DType>
+  MSHADOW_XINLINE static void Map(int i, random::RandomRange range, DType *out,
+                                  int size, float loc, float scale) {
+    float z[random::RandomRange::kBlockSize];
+    range.Normal(i, z);
+    const int begin = i * random::RandomRange::kBlockSize;
+    for (int j = 0; j < random::RandomRange::kBlockSize && begin + j < size; ++j) {
+      out[begin + j] = DType(loc + scale * z[j]);
+    }
+  }
+};
+
+/*!
+ * \brief number of blocks of the counter based generator for size values
+ */
+inline int NumRandomBlocks(int size) {
+  return (size + random::RandomRange::kBlockSize - 1) / random::RandomRange::kBlockSize;
+}
+
 template<typename xpu>
 void SampleUniform_(const nnvm::NodeAttrs& attrs,
                     const OpContext& ctx,
                     const std::vector<TBlob>& inputs,
                     const std::vector<OpReqType>& req,
                     const std::vector<TBlob>& outputs) {
-  using namespace mxnet::op;
-  using namespace mshadow::expr;
+  using namespace mxnet_op;
   mshadow::Stream<xpu> *s = ctx.get_stream<xpu>();
   const SampleUniformParam& param = nnvm::get<SampleUniformParam>(attrs.parsed);
+  const int size = outputs[0].Size();
+  random::RandomRange range = ctx.requested[0].get_parallel_random()->Reserve(size);
   MSHADOW_REAL_TYPE_SWITCH(outputs[0].type_flag_, DType, {
-    mshadow::Random<xpu, DType> *prnd = ctx.requested[0].get_random<xpu, DType>(s);
-    mshadow::Tensor<xpu, 2, DType> out = outputs[0].FlatTo2D<xpu, DType>(s);
-    prnd->SampleUniform(&out, param.low, param.high);
+    Kernel<SampleUniformKernel, xpu>::Launch(s, NumRandomBlocks(size), range,
+        outputs[0].dptr<DType>(), size, param.low, param.high);
   });
 }
 
@@ -237,15 +273,15 @@ void SampleNormal_(const nnvm::NodeAttrs& attrs,
                    const std::vector<TBlob>& inputs,
                    const std::vector<OpReqType>& req,
                    const std::vector<TBlob>& outputs) {
-  using namespace mxnet::op;
-  using namespace mshadow::expr;
+  using namespace mxnet_op;
   mshadow::Stream<xpu> *s = ctx.get_stream<xpu>();
   const SampleNormalParam& param = nnvm::get<SampleNormalParam>(attrs.parsed);
   CHECK_GT(param.scale, 0) << "scale parameter in gaussian has to be positive";
+  const int size = outputs[0].Size();
+  random::RandomRange range = ctx.requested[0].get_parallel_random()->Reserve(size);
   MSHADOW_REAL_TYPE_SWITCH(outputs[0].type_flag_, DType, {
-    mshadow::Random<xpu, DType> *prnd = ctx.requested[0].get_random<xpu, DType>(s);
-    mshadow::Tensor<xpu, 2, DType> out = outputs[0].FlatTo2D<xpu, DType>(s);
-    prnd->SampleGaussian(&out, param.loc, param.scale);  // NOLINT(*)
+    Kernel<SampleNormalKernel, xpu>::Launch(s, NumRandomBlocks(size), range,
+        outputs[0].dptr<DType>(), size, param.loc, param.scale);
   });
 }
 
@@ -384,6 +420,10 @@ inline std::vector<ResourceRequest> SampleResource(const NodeAttrs& attrs) {
   return { ResourceRequest::kRandom, ResourceRequest::kTempSpace };
 }
 
+inline std::vector<ResourceRequest> ParallelSampleResource(const NodeAttrs& attrs) {
+  return { ResourceRequest::kParallelRandom };
+}
+
 }  // namespace op
 }  // namespace mxnet
 #endif  // MXNET_OPERATOR_TENSOR_SAMPLE_OP_H_
@@ -8,10 +8,13 @@
 #include <dmlc/thread_local.h>
 #include <mxnet/base.h>
 #include <mxnet/engine.h>
+#include <mxnet/random_generator.h>
 #include <mxnet/resource.h>
 #include <mxnet/storage.h>
+#include <algorithm>
 #include <limits>
 #include <atomic>
+#include <vector>
 #include "./common/lazy_alloc_array.h"
 
 namespace mxnet {
@@ -25,8 +28,22 @@ struct SpaceAllocator {
   Storage::Handle handle;
   // internal CPU handle
   Storage::Handle host_handle;
+  // number of requests in a window, 0 to never shrink
+  size_t window;
+  // number of requests in the current window
+  size_t window_requests;
+  // largest request in the current window
+  size_t window_high_water;
+  // number of consecutive windows whose requests all fit in a smaller space
+  size_t low_windows;
+  // largest request in these windows
+  size_t low_high_water;
+  // number of consecutive low windows after which the space is shrunk
+  static const size_t kShrinkWindows = 4;
 
-  SpaceAllocator() {
+  SpaceAllocator()
+      : window(0), window_requests(0), window_high_water(0),
+        low_windows(0), low_high_water(0) {
     handle.dptr = nullptr;
     handle.size = 0;
     host_handle.dptr = nullptr;
@@ -42,7 +59,29 @@ struct SpaceAllocator {
       host_handle.size = 0;
     }
   }
+  // frees the space once several consecutive windows of requests fit in a
+  // smaller one, a single low window does not free it since the requests of
+  // an iteration may straddle two windows and freeing may synchronize the device
+  inline void Shrink(size_t size) {
+    window_high_water = std::max(window_high_water, size);
+    if (++window_requests < window) return;
+    if (window_high_water < handle.size) {
+      low_high_water = std::max(low_high_water, window_high_water);
+      if (++low_windows >= kShrinkWindows) {
+        Storage::Get()->DirectFree(handle);
+        handle = Storage::Get()->Alloc(low_high_water, ctx);
+        low_windows = 0;
+        low_high_water = 0;
+      }
+    } else {
+      low_windows = 0;
+      low_high_water = 0;
+    }
+    window_requests = 0;
+    window_high_water = 0;
+  }
   inline void* GetSpace(size_t size) {
+    if (window != 0) Shrink(size);
     if (handle.size >= size) return handle.dptr;
     if (handle.size != 0) {
       Storage::Get()->DirectFree(handle);
@@ -69,20 +108,27 @@ class ResourceManagerImpl : public ResourceManager {
       : global_seed_(0) {
     cpu_temp_space_copy_ = dmlc::GetEnv("MXNET_CPU_TEMP_COPY", 4);
     gpu_temp_space_copy_ = dmlc::GetEnv("MXNET_GPU_TEMP_COPY", 1);
+    temp_space_window_ = dmlc::GetEnv("MXNET_TEMP_SPACE_WINDOW", 0);
+    cpu_parallel_rand_copy_ = dmlc::GetEnv("MXNET_CPU_PARALLEL_RAND_COPY", 4);
+    gpu_parallel_rand_copy_ = dmlc::GetEnv("MXNET_GPU_PARALLEL_RAND_COPY", 4);
     engine_ref_ = Engine::_GetSharedRef();
     storage_ref_ = Storage::_GetSharedRef();
     cpu_rand_.reset(new ResourceRandom<cpu>(
         Context::CPU(), global_seed_));
     cpu_space_.reset(new ResourceTempSpace(
-        Context::CPU(), cpu_temp_space_copy_));
+        Context::CPU(), cpu_temp_space_copy_, temp_space_window_));
+    cpu_parallel_rand_.reset(new ResourceParallelRandom(
+        Context::CPU(), cpu_parallel_rand_copy_, global_seed_));
   }
   ~ResourceManagerImpl() {
     // need explicit delete, before engine get killed
     cpu_rand_.reset(nullptr);
     cpu_space_.reset(nullptr);
+    cpu_parallel_rand_.reset(nullptr);
 #if MXNET_USE_CUDA
     gpu_rand_.Clear();
     gpu_space_.Clear();
+    gpu_parallel_rand_.Clear();
 #endif
     if (engine_ref_ != nullptr) {
       engine_ref_ = nullptr;
@@ -98,6 +144,7 @@ class ResourceManagerImpl : public ResourceManager {
       switch (req.type) {
         case ResourceRequest::kRandom: return cpu_rand_->resource;
         case ResourceRequest::kTempSpace: return cpu_space_->GetNext();
+        case ResourceRequest::kParallelRandom: return cpu_parallel_rand_->GetNext();
         default: LOG(FATAL) << "Unknown supported type " << req.type;
       }
     } else {
@@ -111,7 +158,12 @@ class ResourceManagerImpl : public ResourceManager {
         }
         case ResourceRequest::kTempSpace: {
           return gpu_space_.Get(ctx.dev_id, [ctx, this]() {
-              return new ResourceTempSpace(ctx, gpu_temp_space_copy_);
+              return new ResourceTempSpace(ctx, gpu_temp_space_copy_, temp_space_window_);
+            })->GetNext();
+        }
+        case ResourceRequest::kParallelRandom: {
+          return gpu_parallel_rand_.Get(ctx.dev_id, [ctx, this]() {
+              return new ResourceParallelRandom(ctx, gpu_parallel_rand_copy_, global_seed_);
             })->GetNext();
         }
         default: LOG(FATAL) << "Unknown supported type " << req.type;
@@ -127,10 +179,14 @@ class ResourceManagerImpl : public ResourceManager {
   void SeedRandom(uint32_t seed) override {
     global_seed_ = seed;
     cpu_rand_->Seed(global_seed_);
+    cpu_parallel_rand_->Seed(global_seed_);
 #if MXNET_USE_CUDA
     gpu_rand_.ForEach([seed](size_t i, ResourceRandom<gpu> *p) {
         p->Seed(seed);
       });
+    gpu_parallel_rand_.ForEach([seed](size_t i, ResourceParallelRandom *p) {
+        p->Seed(seed);
+      });
 #endif
   }
 
@@ -139,6 +195,17 @@ class ResourceManagerImpl : public ResourceManager {
   static constexpr std::size_t kMaxNumGPUs = 16;
   /*! \brief Random number magic number to seed different random numbers */
   static constexpr uint32_t kRandMagic = 127UL;
+  // next index of a round robin over n copies
+  static inline size_t RoundRobin(std::atomic<size_t> *curr_ptr, size_t n) {
+    const size_t kMaxDigit = std::numeric_limits<size_t>::max() / 2;
+    size_t ptr = ++(*curr_ptr);
+    // reset ptr to avoid undefined behavior during overflow
+    // usually this won't happen
+    if (ptr > kMaxDigit) {
+      curr_ptr->store((ptr + 1) % n);
+    }
+    return ptr % n;
+  }
   // the random number resources
   template<typename xpu>
   struct ResourceRandom {
@@ -187,7 +254,7 @@ class ResourceManagerImpl : public ResourceManager {
     /*! \brief current pointer to the round roubin alloator */
     std::atomic<size_t> curr_ptr;
     /*! \brief constructor */
-    explicit ResourceTempSpace(Context ctx, size_t ncopy)
+    explicit ResourceTempSpace(Context ctx, size_t ncopy, size_t window)
         : ctx(ctx), space(ncopy), resource(ncopy), curr_ptr(0) {
       for (size_t i = 0; i < space.size(); ++i) {
         resource[i].var = Engine::Get()->NewVariable();
@@ -195,6 +262,7 @@ class ResourceManagerImpl : public ResourceManager {
         resource[i].ptr_ = &space[i];
         resource[i].req = ResourceRequest(ResourceRequest::kTempSpace);
         space[i].ctx = ctx;
+        space[i].window = window;
         CHECK_EQ(space[i].handle.size, 0U);
       }
     }
@@ -210,20 +278,69 @@ class ResourceManagerImpl : public ResourceManager {
     }
     // get next resource in round roubin matter
     inline Resource GetNext() {
-      const size_t kMaxDigit = std::numeric_limits<size_t>::max() / 2;
-      size_t ptr = ++curr_ptr;
-      // reset ptr to avoid undefined behavior during overflow
-      // usually this won't happen
-      if (ptr > kMaxDigit) {
-        curr_ptr.store((ptr + 1) % space.size());
+      return resource[RoundRobin(&curr_ptr, space.size())];
+    }
+  };
+
+  // counter based random number resources, handed out in round robin
+  struct ResourceParallelRandom {
+    /*! \brief the context of the device */
+    Context ctx;
+    /*! \brief the streams of the copies */
+    std::vector<random::ParallelRandom> streams;
+    /*! \brief resource representation */
+    std::vector<Resource> resource;
+    /*! \brief current pointer to the round roubin alloator */
+    std::atomic<size_t> curr_ptr;
+    /*! \brief constructor */
+    explicit ResourceParallelRandom(Context ctx, size_t ncopy, uint32_t global_seed)
+        : ctx(ctx), streams(ncopy), resource(ncopy), curr_ptr(0) {
+      for (size_t i = 0; i < streams.size(); ++i) {
+        resource[i].var = Engine::Get()->NewVariable();
+        resource[i].id = static_cast<int32_t>(i);
+        resource[i].ptr_ = &streams[i];
+        resource[i].req = ResourceRequest(ResourceRequest::kParallelRandom);
+        streams[i].Seed(global_seed, StreamId(i));
+      }
+    }
+    ~ResourceParallelRandom() {
+      for (size_t i = 0; i < streams.size(); ++i) {
+        Engine::Get()->DeleteVariable([](RunContext rctx) {}, ctx, resource[i].var);
       }
-      return resource[ptr % space.size()];
+    }
+    // the streams of all the devices and copies differ for the same seed
+    inline uint32_t StreamId(size_t i) const {
+      return (static_cast<uint32_t>(ctx.dev_mask()) << 24) |
+          (static_cast<uint32_t>(ctx.dev_id) << 12) | static_cast<uint32_t>(i);
+    }
+    // restart every stream, after the operators already pushed,
+    // and the round robin so that imperative calls get the same copies again
+    inline void Seed(uint32_t global_seed) {
+      curr_ptr.store(0);
+      for (size_t i = 0; i < streams.size(); ++i) {
+        random::ParallelRandom *r = &streams[i];
+        const uint32_t id = StreamId(i);
+        Engine::Get()->PushSync([r, global_seed, id](RunContext rctx) {
+            r->Seed(global_seed, id);
+          }, ctx, {}, {resource[i].var},
+          FnProperty::kNormal, 0, PROFILER_MESSAGE("ResourceParallelRandomSetSeed"));
+      }
+    }
+    // get next resource in round roubin matter
+    inline Resource GetNext() {
+      return resource[RoundRobin(&curr_ptr, streams.size())];
     }
   };
   /*! \brief number of copies in CPU temp space */
   int cpu_temp_space_copy_;
   /*! \brief number of copies in GPU temp space */
   int gpu_temp_space_copy_;
+  /*! \brief number of requests after which a temp space fits their high-water mark */
+  size_t temp_space_window_;
+  /*! \brief number of copies in CPU parallel random number resources */
+  int cpu_parallel_rand_copy_;
+  /*! \brief number of copies in GPU parallel random number resources */
+  int gpu_parallel_rand_copy_;
   /*! \brief Reference to the engine */
   std::shared_ptr<Engine> engine_ref_;
   /*! \brief Reference to the storage */
@@ -234,16 +351,24 @@ class ResourceManagerImpl : public ResourceManager {
   std::unique_ptr<ResourceRandom<cpu> > cpu_rand_;
   /*! \brief CPU temp space resources */
   std::unique_ptr<ResourceTempSpace> cpu_space_;
+  /*! \brief CPU parallel random number resources */
+  std::unique_ptr<ResourceParallelRandom> cpu_parallel_rand_;
 #if MXNET_USE_CUDA
   /*! \brief random number generator for GPU */
   common::LazyAllocArray<ResourceRandom<gpu> > gpu_rand_;
   /*! \brief temp space for GPU */
   common::LazyAllocArray<ResourceTempSpace> gpu_space_;
+  /*! \brief parallel random number generators for GPU */
+  common::LazyAllocArray<ResourceParallelRandom> gpu_parallel_rand_;
 #endif
 };
 }  // namespace resource
 
 void* Resource::get_space_internal(size_t size) const {
+  if (stat != nullptr) {
+    stat->high_water = std::max(stat->high_water, size);
+    ++stat->num_requests;
+  }
   return static_cast<resource::SpaceAllocator*>(ptr_)->GetSpace(size);
 }
 
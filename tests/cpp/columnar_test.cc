@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <dmlc/io.h>
+#include <dmlc/logging.h>
+#include <mxnet/io.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../../src/io/columnar_format.h"
+
+using namespace mxnet::io::columnar;
+
+TEST(Columnar, ShuffleRLE) {
+  // runs, literals and a mix of both, with values of several sizes
+  std::vector<int32_t> values;
+  for (int i = 0; i < 1000; ++i) values.push_back(i < 300 ? 7 : (i * 2654435761U) % 1000);
+  for (size_t elem_size : {1, 2, 4}) {
+    const size_t n = values.size() * 4 / elem_size;
+    const char *src = reinterpret_cast<const char*>(values.data());
+    std::string packed;
+    ShuffleRLEEncode(src, n, elem_size, &packed);
+    std::vector<char> buf(n * elem_size), dst(n * elem_size);
+    ShuffleRLEDecode(packed.data(), packed.size(), n, elem_size, buf.data(), dst.data());
+    EXPECT_EQ(std::string(src, n * elem_size), std::string(dst.data(), dst.size()));
+  }
+}
+
+TEST(Columnar, Iterator) {
+  const std::string path = "columnar_test.col";
+  const size_t num_rows = 103, chunk_rows = 20, batch_size = 8;
+  for (bool compress : {false, true}) {
+    // a label column and two data columns of different types
+    {
+      std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(path.c_str(), "w"));
+      Writer writer(fo.get(), {mshadow::kFloat32, mshadow::kInt32, mshadow::kUint8}, 1, compress);
+      for (size_t begin = 0; begin < num_rows; begin += chunk_rows) {
+        const size_t n = std::min(chunk_rows, num_rows - begin);
+        std::vector<float> label(n);
+        std::vector<int32_t> x(n);
+        std::vector<uint8_t> y(n);
+        for (size_t i = 0; i < n; ++i) {
+          label[i] = static_cast<float>(begin + i) / 2;
+          x[i] = static_cast<int32_t>(begin + i) * 3;
+          y[i] = 5;
+        }
+        writer.WriteChunk({label.data(), x.data(), y.data()}, n);
+      }
+      writer.Close();
+    }
+    const mxnet::DataIteratorReg *reg =
+        dmlc::Registry<mxnet::DataIteratorReg>::Find("ColumnarIter");
+    ASSERT_NE(reg, nullptr) << "ColumnarIter is not registered";
+    std::unique_ptr<mxnet::IIterator<mxnet::DataBatch> > iter(reg->body());
+    iter->Init({{"path", path}, {"batch_size", std::to_string(batch_size)},
+                {"round_batch", "0"}});
+    for (int epoch = 0; epoch < 2; ++epoch) {
+      size_t row = 0;
+      iter->BeforeFirst();
+      while (iter->Next()) {
+        const mxnet::DataBatch &batch = iter->Value();
+        const mxnet::TBlob data = batch.data[0].data();
+        const mxnet::TBlob label = batch.data[1].data();
+        ASSERT_EQ(data.shape_[1], 2U);
+        const size_t n = batch_size - batch.num_batch_padd;
+        for (size_t i = 0; i < n; ++i, ++row) {
+          EXPECT_EQ(label.dptr<float>()[i], static_cast<float>(row) / 2);
+          EXPECT_EQ(data.dptr<float>()[2 * i], static_cast<float>(row * 3));
+          EXPECT_EQ(data.dptr<float>()[2 * i + 1], 5.0f);
+          EXPECT_EQ(batch.index[i], row);
+        }
+      }
+      EXPECT_EQ(row, num_rows);
+    }
+  }
+  std::remove(path.c_str());
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <mxnet/operator.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../src/operator/cpu_algoreg-inl.h"
+
+using namespace mxnet;
+using namespace mxnet::op;
+
+namespace {
+// counts its forward calls and takes at least delay_ms for each of them
+class TimedOp : public Operator {
+ public:
+  TimedOp(int delay_ms, int *calls) : delay_ms_(delay_ms), calls_(calls) {}
+
+  virtual void Forward(const OpContext &ctx,
+                       const std::vector<TBlob> &in_data,
+                       const std::vector<OpReqType> &req,
+                       const std::vector<TBlob> &out_data,
+                       const std::vector<TBlob> &aux_args) {
+    if (delay_ms_ != 0) std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms_));
+    ++*calls_;
+  }
+
+ private:
+  int delay_ms_;
+  int *calls_;
+};
+}  // namespace
+
+TEST(CPUAlgoReg, SelectsFastestCandidate) {
+  const std::string key = "op=CPUAlgoRegTest;";
+  int slow_calls = 0, fast_calls = 0;
+  // the slow candidate is the default, so the selection is not the first one
+  std::vector<CPUAlgoCandidate> candidates = {
+    {"slow", [&slow_calls]() { return new TimedOp(20, &slow_calls); }},
+    {"fast", [&fast_calls]() { return new TimedOp(0, &fast_calls); }}};
+  std::unique_ptr<Operator> op(new CPUAutoTuneOp(key, candidates));
+  OpContext ctx;
+  std::vector<TBlob> blobs;
+  std::vector<OpReqType> req = {kWriteTo};
+  op->Forward(ctx, blobs, req, blobs, blobs);
+  std::string algo;
+  ASSERT_TRUE(CPUAlgoReg::Get()->Find(key, &algo));
+  EXPECT_EQ(algo, "fast");
+
+  // later passes only run the selected candidate
+  const int slow_before = slow_calls, fast_before = fast_calls;
+  op->Forward(ctx, blobs, req, blobs, blobs);
+  EXPECT_EQ(slow_calls, slow_before);
+  EXPECT_EQ(fast_calls, fast_before + 1);
+
+  // operators created for the same key skip the tuning
+  std::unique_ptr<Operator> tuned(CreateCPUAutoTunedOp(key, candidates));
+  tuned->Forward(ctx, blobs, req, blobs, blobs);
+  EXPECT_EQ(slow_calls, slow_before);
+  EXPECT_EQ(fast_calls, fast_before + 2);
+}
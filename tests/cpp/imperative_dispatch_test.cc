@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <dmlc/logging.h>
+#include <dmlc/timer.h>
+#include <mxnet/c_api.h>
+#include <nnvm/op.h>
+#include <vector>
+
+/**
+ * measure the dispatch overhead of MXImperativeInvoke and MXInvokeCachedOp
+ * with an operator small enough for dispatch to dominate
+ */
+namespace {
+const int kNumCalls = 20000;
+
+NDArrayHandle CreateArray(const std::vector<float>& values) {
+  NDArrayHandle handle;
+  mx_uint shape = static_cast<mx_uint>(values.size());
+  CHECK_EQ(MXNDArrayCreateEx(&shape, 1, 1, 0, 0, 0, &handle), 0);
+  CHECK_EQ(MXNDArraySyncCopyFromCPU(handle, values.data(), values.size()), 0);
+  return handle;
+}
+
+std::vector<float> ToVector(NDArrayHandle handle, size_t size) {
+  std::vector<float> values(size);
+  CHECK_EQ(MXNDArraySyncCopyToCPU(handle, values.data(), size), 0);
+  return values;
+}
+}  // namespace
+
+TEST(ImperativeDispatch, CachedOp) {
+  // Op::Get aborts on an unknown name, a missing registration fails the test instead
+  const nnvm::Op *op = dmlc::Registry<nnvm::Op>::Find("_plus_scalar");
+  ASSERT_NE(op, nullptr) << "_plus_scalar is not registered";
+  AtomicSymbolCreator creator = const_cast<nnvm::Op*>(op);
+  const char *keys[] = {"scalar"};
+  const char *vals[] = {"1"};
+  const std::vector<float> values = {1, 2, 3, 4};
+  NDArrayHandle x = CreateArray(values);
+  NDArrayHandle y = CreateArray(values);
+  NDArrayHandle z = CreateArray(values);
+
+  // writing to a given output
+  int num_outputs = 1;
+  NDArrayHandle *outputs = &y;
+  double tstart = dmlc::GetTime();
+  for (int i = 0; i < kNumCalls; ++i) {
+    ASSERT_EQ(MXImperativeInvoke(creator, 1, &x, &num_outputs, &outputs, 1, keys, vals), 0);
+  }
+  ASSERT_EQ(MXNDArrayWaitAll(), 0);
+  const double invoke_time = dmlc::GetTime() - tstart;
+
+  CachedOpHandle cached;
+  ASSERT_EQ(MXCreateCachedOp(creator, 1, 1, keys, vals, &cached), 0);
+  outputs = &z;
+  tstart = dmlc::GetTime();
+  for (int i = 0; i < kNumCalls; ++i) {
+    ASSERT_EQ(MXInvokeCachedOp(cached, 1, &x, &num_outputs, &outputs), 0);
+  }
+  ASSERT_EQ(MXNDArrayWaitAll(), 0);
+  const double cached_time = dmlc::GetTime() - tstart;
+  LOG(INFO) << "MXImperativeInvoke: " << invoke_time / kNumCalls * 1e6 << " us/call, "
+            << "MXInvokeCachedOp: " << cached_time / kNumCalls * 1e6 << " us/call";
+
+  std::vector<float> expected = values;
+  for (float& v : expected) v += 1;
+  EXPECT_EQ(ToVector(y, values.size()), expected);
+  EXPECT_EQ(ToVector(z, values.size()), expected);
+
+  // allocating the outputs, with a change of input shape in between
+  NDArrayHandle w = CreateArray({5, 6});
+  for (NDArrayHandle input : {x, w, w}) {
+    num_outputs = 0;
+    outputs = nullptr;
+    ASSERT_EQ(MXInvokeCachedOp(cached, 1, &input, &num_outputs, &outputs), 0);
+    ASSERT_EQ(num_outputs, 1);
+    NDArrayHandle out = outputs[0];
+    const mx_uint size = input == x ? 4 : 2;
+    std::vector<float> result = ToVector(out, size), source = ToVector(input, size);
+    for (mx_uint i = 0; i < size; ++i) EXPECT_EQ(result[i], source[i] + 1);
+    MXNDArrayFree(out);
+  }
+  EXPECT_EQ(MXFreeCachedOp(cached), 0);
+  for (NDArrayHandle handle : {x, y, z, w}) MXNDArrayFree(handle);
+}
@@ -5,6 +5,7 @@
 #include <gtest/gtest.h>
 #include <thread>
 #include <chrono>
+#include <memory>
 #include <vector>
 
 #include <mxnet/engine.h>
@@ -229,3 +230,35 @@ TEST(Engine, basics) {
   oprs.clear();
   LOG(INFO) << "All pass";
 }
+
+TEST(Engine, bulk) {
+  std::unique_ptr<mxnet::Engine> engine(mxnet::engine::CreateThreadedEnginePerDevice());
+  const int num_var = 3, num_ops = 1000;
+  std::vector<mxnet::Engine::VarHandle> vars;
+  std::vector<double> data(num_var, 1.0), expected(num_var, 1.0);
+  for (int i = 0; i < num_var; ++i) vars.push_back(engine->NewVariable());
+  EXPECT_EQ(engine->set_bulk_size(16), 0);
+  EXPECT_EQ(engine->bulk_size(), 16);
+  for (int i = 0; i < num_ops; ++i) {
+    const int write = i % num_var, read = (i + 1) % num_var;
+    double *dptr = data.data();
+    engine->PushSync([dptr, write, read](mxnet::RunContext) {
+        dptr[write] = (dptr[write] + dptr[read]) / 2 + 1;
+      }, mxnet::Context::CPU(), {vars[read]}, {vars[write]});
+    expected[write] = (expected[write] + expected[read]) / 2 + 1;
+    if (i % 100 == 99) {
+      // waiting pushes the pending group
+      engine->WaitForVar(vars[write]);
+      EXPECT_EQ(data[write], expected[write]);
+    }
+  }
+  // deleting a variable does not push the pending group early
+  engine->DeleteVariable([](mxnet::RunContext) {}, mxnet::Context::CPU(), vars[0]);
+  EXPECT_EQ(engine->set_bulk_size(0), 16);
+  engine->WaitForAll();
+  for (int i = 0; i < num_var; ++i) EXPECT_EQ(data[i], expected[i]);
+  for (int i = 1; i < num_var; ++i) {
+    engine->DeleteVariable([](mxnet::RunContext) {}, mxnet::Context::CPU(), vars[i]);
+  }
+  engine->WaitForAll();
+}
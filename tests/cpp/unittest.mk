@@ -15,7 +15,11 @@ build/tests/cpp/%.o : tests/cpp/%.cc
 	$(CXX) -std=c++0x $(CFLAGS) -MM -MT tests/cpp/$* $< > build/tests/cpp/$*.d
 	$(CXX) -c -std=c++0x $(CFLAGS) -I$(GTEST_INC) -o build/tests/cpp/$*.o $(filter %.cc %.a, $^)
 
-$(TEST): $(TEST_OBJ) lib/libmxnet.a
-	$(CXX) -std=c++0x $(CFLAGS) -I$(GTEST_INC) -o $@ $^ $(LDFLAGS) -L$(GTEST_LIB) -lgtest
+# operators, iterators and nnvm passes register themselves in static initializers
+# that nothing references, link the whole archives as lib/libmxnet.so does
+$(TEST): $(TEST_OBJ) lib/libmxnet.a $(LIB_DEP)
+	$(CXX) -std=c++0x $(CFLAGS) -I$(GTEST_INC) -o $@ $(TEST_OBJ) \
+	-Wl,${WHOLE_ARCH} lib/libmxnet.a $(filter %libnnvm.a, $^) -Wl,${NO_WHOLE_ARCH} \
+	$(filter-out %libnnvm.a, $(LIB_DEP)) $(LDFLAGS) -L$(GTEST_LIB) -lgtest
 
 -include build/tests/cpp/*.d
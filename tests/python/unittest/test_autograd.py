@@ -1,3 +1,4 @@
+import numpy as np
 import mxnet.ndarray as nd
 from mxnet.contrib.autograd import grad, grad_and_loss, train, test
 from mxnet.test_utils import *
@@ -82,6 +83,26 @@ def test_training():
             y = nd.Dropout(x, p=0.5)
             assert (y.asnumpy() == x.asnumpy()).all()
 
+def test_repeated_graph():
+    # the backward executor compiled for a graph is reused when the same graph
+    # is recorded again, gradients must follow the new inputs and operators
+    def f_fc(x, y, weight):
+        return nd.FullyConnected(x*y, weight, no_bias=True, num_hidden=4)
+
+    grad_func = grad_and_loss(f_fc)
+    for shape in [(3, 5), (3, 5), (3, 5), (6, 5), (3, 5)]:
+        x = nd.uniform(shape=shape)
+        y = nd.uniform(shape=shape)
+        weight = nd.uniform(shape=(4, shape[1]))
+        grad_vals, output = grad_func(x, y, weight)
+        ones = np.ones((shape[0], 4))
+        xy = (x*y).asnumpy()
+        assert_almost_equal(output.asnumpy(), np.dot(xy, weight.asnumpy().T))
+        dxy = np.dot(ones, weight.asnumpy())
+        assert_almost_equal(grad_vals[0].asnumpy(), dxy * y.asnumpy())
+        assert_almost_equal(grad_vals[1].asnumpy(), dxy * x.asnumpy())
+        assert_almost_equal(grad_vals[2].asnumpy(), np.dot(ones.T, xy))
+
 
 if __name__ == "__main__":
     test_training()
@@ -89,3 +110,4 @@ if __name__ == "__main__":
     test_binary_func()
     test_operator_with_state()
     test_argnum()
+    test_repeated_graph()
@@ -1,5 +1,6 @@
 import numpy as np
 import mxnet as mx
+from mxnet.test_utils import assert_almost_equal
 
 
 def reldiff(a, b):
@@ -136,7 +137,59 @@ def test_reshape():
     exe.forward(is_train=False)
     assert np.all(exe.outputs[0].asnumpy() == 4)
 
+def test_fused_elemwise():
+    x = mx.sym.Variable('x')
+    a = mx.sym.Variable('a')
+    b = mx.sym.Variable('b')
+    y = mx.sym.Activation(mx.sym.sqrt(mx.sym.abs(x * a + b) + 1) * 2 - x,
+                          act_type='relu')
+    shape = (7, 301)
+    args = {k: mx.nd.array(np.random.uniform(-1, 1, shape)) for k in ['x', 'a', 'b']}
+    grads = {k: mx.nd.empty(shape) for k in ['x', 'a', 'b']}
+    exe = y.bind(mx.cpu(), args=args, args_grad=grads)
+    # the forward chain is fused in the training graph too, the gradient nodes
+    # depend on the fused nodes instead of the absorbed ones
+    assert '_FusedElemwise' in exe.debug_str()
+    exe.forward(is_train=True)
+    xn, an, bn = [args[k].asnumpy() for k in ['x', 'a', 'b']]
+    z = xn * an + bn
+    s = np.sqrt(np.abs(z) + 1)
+    v = s * 2 - xn
+    out = np.maximum(v, 0)
+    assert reldiff(out, exe.outputs[0].asnumpy()) < 1e-6
+    exe.backward([mx.nd.ones(shape)])
+    mask = (v > 0).astype(np.float32)
+    dz = mask * np.sign(z) / s
+    assert_almost_equal(grads['x'].asnumpy(), dz * an - mask, rtol=1e-5, atol=1e-6)
+    assert_almost_equal(grads['a'].asnumpy(), dz * xn, rtol=1e-5, atol=1e-6)
+    assert_almost_equal(grads['b'].asnumpy(), dz, rtol=1e-5, atol=1e-6)
+    exe = y.bind(mx.cpu(), args=args)
+    assert '_FusedElemwise' in exe.debug_str()
+    exe.forward(is_train=False)
+    assert reldiff(out, exe.outputs[0].asnumpy()) < 1e-6
+
+def test_temp_space_stats():
+    import re
+    data = mx.sym.Variable('data')
+    conv = mx.sym.Convolution(data, kernel=(3, 3), num_filter=8, name='conv')
+    net = mx.sym.FullyConnected(mx.sym.Flatten(conv), num_hidden=4, name='fc')
+    exe = net.simple_bind(mx.cpu(), data=(2, 3, 8, 8))
+    exe.forward(is_train=True)
+    exe.backward([mx.nd.ones((2, 4))])
+    mx.nd.waitall()
+    info = exe.debug_str()
+    assert 'Total 1 TempSpace resource requested' in info
+    # forward and backward of the convolution use the im2col workspace
+    match = re.search('TempSpace conv\w*: (\d+) KB high-water, (\d+) requests', info)
+    assert match is not None and int(match.group(2)) > 0
+    # an executor sharing the memory of exe also shares its temp space
+    exe2 = exe.reshape(data=(1, 3, 8, 8))
+    assert 'Total 1 TempSpace resource requested' in exe2.debug_str()
+
+
 if __name__ == "__main__":
+    test_temp_space_stats()
+    test_fused_elemwise()
     test_bind(disable_bulk_exec=False)
     test_bind(disable_bulk_exec=True)
     test_reshape()
@@ -6,6 +6,7 @@ import pickle as pickle
 import time
 import sys
 from common import get_data
+from mxnet.test_utils import assert_almost_equal
 
 def test_MNISTIter():
     # prepare data
@@ -88,7 +89,170 @@ def test_NDArrayIter():
         else:
             assert(labelcount[i] == 100)
 
+def test_ImageRecordIter_indexed():
+    try:
+        import cv2
+    except ImportError:
+        return
+    num_image = 40
+    prefix = 'data/test_indexed'
+    if not os.path.isdir('data'):
+        os.makedirs('data')
+    record = mx.recordio.MXIndexedRecordIO(prefix + '.idx', prefix + '.rec', 'w')
+    for i in range(num_image):
+        img = np.full((8, 8, 3), i, dtype=np.uint8)
+        header = mx.recordio.IRHeader(0, float(i), i, 0)
+        record.write_idx(i, mx.recordio.pack_img(header, img, img_fmt='.png'))
+    record.close()
+
+    def read_epoch(dataiter):
+        labels = []
+        for batch in dataiter:
+            data = batch.data[0].asnumpy()
+            label = batch.label[0].asnumpy()
+            for j in range(label.shape[0] - batch.pad):
+                assert (data[j] == label[j]).all()
+                labels.append(int(label[j]))
+        return labels
+
+    for num_parts in [1, 2]:
+        seen = []
+        for part_index in range(num_parts):
+            dataiter = mx.io.ImageRecordIter(
+                path_imgrec=prefix + '.rec', path_imgidx=prefix + '.idx',
+                data_shape=(3, 8, 8), batch_size=5, shuffle=True,
+                num_parts=num_parts, part_index=part_index)
+            epoch0 = read_epoch(dataiter)
+            dataiter.reset()
+            epoch1 = read_epoch(dataiter)
+            assert sorted(epoch0) == sorted(epoch1)
+            assert len(epoch0) == num_image // num_parts
+            seen += epoch0
+        assert sorted(seen) == list(range(num_image))
+
+def test_ImageRecordIter_decoded_cache():
+    try:
+        import cv2
+    except ImportError:
+        return
+    # 120 images of 64x64x3 take 1.4MB once decoded
+    num_image = 120
+    prefix = 'data/test_decoded_cache'
+    if not os.path.isdir('data'):
+        os.makedirs('data')
+    rng = np.random.RandomState(0)
+    record = mx.recordio.MXIndexedRecordIO(prefix + '.idx', prefix + '.rec', 'w')
+    for i in range(num_image):
+        img = rng.randint(0, 256, size=(64, 64, 3)).astype(np.uint8)
+        header = mx.recordio.IRHeader(0, float(i), i, 0)
+        record.write_idx(i, mx.recordio.pack_img(header, img, img_fmt='.png'))
+    record.close()
+
+    def read_epochs(cache_size):
+        dataiter = mx.io.ImageRecordIter(
+            path_imgrec=prefix + '.rec', data_shape=(3, 64, 64), batch_size=16,
+            decoded_cache_size=cache_size)
+        epochs = []
+        for _ in range(2):
+            batches = []
+            for batch in dataiter:
+                batches.append((batch.data[0].asnumpy(), batch.label[0].asnumpy(), batch.pad))
+            epochs.append(batches)
+            dataiter.reset()
+        return epochs
+
+    expected = read_epochs(0)
+    assert len(expected[0]) == (num_image + 15) // 16
+    # a cache holding every image, and one that fills up and decodes the rest
+    for cache_size in [16, 1]:
+        cached = read_epochs(cache_size)
+        for batches in cached + expected[1:]:
+            assert len(batches) == len(expected[0])
+            for (d, l, pad), (ed, el, epad) in zip(batches, expected[0]):
+                assert pad == epad
+                assert (d == ed).all()
+                assert (l == el).all()
+
+def test_ImageRecordUInt8Iter_layout():
+    try:
+        import cv2
+    except ImportError:
+        return
+    num_image = 6
+    prefix = 'data/test_layout'
+    if not os.path.isdir('data'):
+        os.makedirs('data')
+    rng = np.random.RandomState(0)
+    images = [rng.randint(0, 256, size=(4, 5, 3)).astype(np.uint8) for _ in range(num_image)]
+    record = mx.recordio.MXIndexedRecordIO(prefix + '.idx', prefix + '.rec', 'w')
+    for i, img in enumerate(images):
+        header = mx.recordio.IRHeader(0, float(i), i, 0)
+        record.write_idx(i, mx.recordio.pack_img(header, img, img_fmt='.png'))
+    record.close()
+
+    def read_epoch(**kwargs):
+        dataiter = mx.io.ImageRecordUInt8Iter(path_imgrec=prefix + '.rec', data_shape=(3, 4, 5),
+                                             batch_size=num_image, **kwargs)
+        batch = next(iter(dataiter))
+        return batch.data[0].asnumpy(), batch.label[0].asnumpy()
+
+    nchw, _ = read_epoch()
+    nhwc, label = read_epoch(layout='NHWC')
+    assert nhwc.dtype == np.uint8
+    assert nhwc.shape == (num_image, 4, 5, 3)
+    assert (nhwc == nchw.transpose(0, 2, 3, 1)).all()
+    for j in range(num_image):
+        # pixels are stored as BGR and returned as RGB
+        assert (nhwc[j] == images[int(label[j])][:, :, ::-1]).all()
+    # the v1 iterators only write NCHW batches
+    try:
+        mx.io.ImageRecordUInt8Iter_v1(path_imgrec=prefix + '.rec', data_shape=(3, 4, 5),
+                                      batch_size=num_image, layout='NHWC')
+        assert False, 'layout NHWC must be rejected by ImageRecordUInt8Iter_v1'
+    except mx.base.MXNetError:
+        pass
+
+def test_CSVIter_staged():
+    # batches copied to a stand-in device as they are prefetched must match
+    # the prefetched batches, with both the thread and the engine prefetcher
+    if not os.path.isdir('data'):
+        os.makedirs('data')
+    num_example, dim = 50, 3
+    data = np.arange(num_example * dim, dtype=np.float32).reshape(num_example, dim)
+    np.savetxt('data/test_staged_data.csv', data, delimiter=',')
+    np.savetxt('data/test_staged_label.csv', np.arange(num_example), delimiter=',')
+
+    def read_epochs(**kwargs):
+        dataiter = mx.io.CSVIter(data_csv='data/test_staged_data.csv', data_shape=(dim,),
+                                 label_csv='data/test_staged_label.csv', label_shape=(1,),
+                                 batch_size=8, prefetch_buffer=2, **kwargs)
+        epochs = []
+        for _ in range(2):
+            batches = []
+            for batch in dataiter:
+                assert batch.data[0].context == mx.cpu(0)
+                batches.append((batch.data[0].asnumpy(), batch.label[0].asnumpy(), batch.pad))
+            epochs.append(batches)
+            dataiter.reset()
+        return epochs
+
+    expected = read_epochs()
+    for use_engine in [False, True]:
+        staged = read_epochs(device_type='cpu', device_id=0, pin_memory=True,
+                             use_engine=use_engine)
+        assert len(staged) == len(expected)
+        for batches, expected_batches in zip(staged, expected):
+            assert len(batches) == len(expected_batches)
+            for (d, l, pad), (ed, el, epad) in zip(batches, expected_batches):
+                assert pad == epad
+                assert_almost_equal(d, ed)
+                assert_almost_equal(l, el)
+
 if __name__ == "__main__":
     test_NDArrayIter()
     test_MNISTIter()
     test_Cifar10Rec()
+    test_ImageRecordIter_indexed()
+    test_ImageRecordIter_decoded_cache()
+    test_ImageRecordUInt8Iter_layout()
+    test_CSVIter_staged()
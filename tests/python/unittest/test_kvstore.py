@@ -111,6 +111,26 @@ def test_updater(dev = 'cpu'):
         for v in vv:
             check_diff_to_scalar(v, num_devs * num_push)
 
+def test_row_sparse():
+    """row-sparse push & pull with and without updater"""
+    kv = init_kv()
+    devs = [mx.Context('cpu', i) for i in range(2)]
+    ids = [mx.nd.array([1, 3, -1], d) for d in devs]
+    vals = [mx.nd.ones((3, shape[1]), d) for d in devs]
+    kv.push_row_sparse(3, ids, vals)
+    out = mx.nd.zeros((3, shape[1]))
+    kv.pull_row_sparse(3, out=out, row_ids=mx.nd.array([3, 0, -1]))
+    assert np.all(out.asnumpy() == np.array([[2] * 4, [0] * 4, [0] * 4]))
+
+    kv = init_kv()
+    kv.set_optimizer(mx.optimizer.create('sgd', learning_rate=0.5))
+    kv.push_row_sparse(3, ids, vals)
+    val = mx.nd.empty(shape)
+    kv.pull(3, out=val)
+    expected = np.zeros(shape)
+    expected[[1, 3]] = -1
+    assert np.all(val.asnumpy() == expected)
+
 def test_get_type():
     kvtype = 'local_allreduce_cpu'
     kv = mx.kv.create(kvtype)
@@ -123,3 +143,4 @@ if __name__ == '__main__':
     test_list_kv_pair()
     test_aggregator()
     test_updater()
+    test_row_sparse()
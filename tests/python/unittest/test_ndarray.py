@@ -230,6 +230,51 @@ def test_ndarray_saveload():
     os.remove(fname)
 
 
+def test_ndarray_save_options():
+    data = [mx.nd.array(np.random.uniform(-10, 10, (1000, 700))),
+            mx.nd.zeros((300, 400), dtype=np.int32),
+            mx.nd.array(np.arange(7, dtype=np.float64), dtype=np.float64)]
+    fname = 'tmp_save_options.bin'
+    for compress in [False, True]:
+        for background in [False, True]:
+            expected = [x.asnumpy() for x in data]
+            mx.nd.save(fname, data, compress=compress, background=background)
+            # the arrays are copied, later writes are not in the file
+            for x in data:
+                x[:] = 1
+            mx.nd.waitall()
+            data2 = mx.nd.load(fname)
+            assert len(data2) == len(data)
+            for x, y, z in zip(expected, data2, data):
+                assert y.dtype == z.dtype
+                assert np.array_equal(x, y.asnumpy())
+                z[:] = y
+    # a corrupted array is reported with its name, compressed or not
+    x = mx.nd.array(np.random.randint(0, 4, (100, 1000)))
+    for compress in [False, True]:
+        mx.nd.save(fname, {'x': x}, compress=compress)
+        size = os.path.getsize(fname)
+        with open(fname, 'r+b') as f:
+            f.seek(size // 2)
+            byte = f.read(1)
+            f.seek(size // 2)
+            f.write(bytes(bytearray([(ord(byte) + 1) % 256])))
+        try:
+            mx.nd.load(fname)
+            assert False
+        except mx.base.MXNetError as err:
+            assert 'NDArray x' in str(err) and 'corrupted' in str(err)
+    os.remove(fname)
+    # a failed background save is raised by waitall
+    mx.nd.save(os.path.join('no_such_dir', fname), data, background=True)
+    try:
+        mx.nd.waitall()
+        assert False
+    except mx.base.MXNetError as err:
+        assert 'Failed to save' in str(err)
+    mx.nd.waitall()
+
+
 def test_ndarray_slice():
     shape = (10,)
     A = mx.nd.array(np.random.uniform(-10, 10, shape))
@@ -617,6 +662,54 @@ def test_iter():
         assert same(y[i].asnumpy(), x[i].asnumpy())
 
 
+def test_cached_op():
+    add = mx.nd.CachedOp('_plus_scalar', 1, scalar=2)
+    for shape in [(2, 3), (2, 3), (4,), (4,)]:
+        x = mx.nd.array(np.random.uniform(size=shape))
+        assert same(add(x).asnumpy(), x.asnumpy() + 2)
+    out = mx.nd.zeros((4,))
+    assert add(x, out=out) is out
+    assert same(out.asnumpy(), x.asnumpy() + 2)
+
+    dot = mx.nd.CachedOp('dot', 2, transpose_a=True)
+    a = mx.nd.array(np.random.uniform(size=(3, 2)))
+    b = mx.nd.array(np.random.uniform(size=(3, 4)))
+    assert_allclose(dot(a, b).asnumpy(), np.dot(a.asnumpy().T, b.asnumpy()), rtol=1e-5)
+
+
+def test_bulk():
+    x = mx.nd.zeros((10,))
+    y = mx.nd.ones((10,))
+    with mx.engine.bulk(8):
+        for i in range(100):
+            x += y
+            if i == 50:
+                # reading a value inside the scope pushes the pending group
+                assert same(x.asnumpy(), np.full((10,), 51))
+            y = y * 1
+    assert same(x.asnumpy(), np.full((10,), 100))
+    assert mx.engine.set_bulk_size(0) == 0
+
+
+def test_bulk_with_executor():
+    # executor operations come after the grouped writes of their inputs
+    data = mx.sym.Variable('data')
+    x = mx.nd.zeros((4, 5))
+    grad = mx.nd.zeros((4, 5))
+    exe = (data * data).bind(mx.cpu(), {'data': x}, args_grad={'data': grad})
+    outputs, grads = [], []
+    with mx.engine.bulk(16):
+        for i in range(10):
+            x[:] = i
+            exe.forward(is_train=True)
+            exe.backward([mx.nd.ones((4, 5))])
+            outputs.append(exe.outputs[0].copy())
+            grads.append(grad.copy())
+    for i in range(10):
+        assert same(outputs[i].asnumpy(), np.full((4, 5), i * i))
+        assert same(grads[i].asnumpy(), np.full((4, 5), 2 * i))
+
+
 if __name__ == '__main__':
     test_broadcast_binary()
     test_ndarray_setitem()
@@ -628,6 +721,7 @@ if __name__ == '__main__':
     test_ndarray_slice()
     test_ndarray_pickle()
     test_ndarray_saveload()
+    test_ndarray_save_options()
     test_ndarray_copy()
     test_ndarray_negate()
     test_ndarray_scalar()
@@ -642,3 +736,6 @@ if __name__ == '__main__':
     test_ndarray_equal()
     test_take()
     test_iter()
+    test_cached_op()
+    test_bulk()
+    test_bulk_with_executor()
@@ -2,6 +2,10 @@
 import numpy as np
 import mxnet as mx
 import random
+import os
+import subprocess
+import sys
+import tempfile
 from numpy.testing import assert_allclose
 from mxnet.test_utils import *
 
@@ -47,6 +51,9 @@ def test_elementwise_sum():
         for dim in range(1, maxdim):
             shape = tuple(np.random.randint(1, int(1000**(1.0/dim)), size=dim))
             check_elementwise_sum_with_shape(shape, np.random.randint(1, 8))
+    # large arrays are summed by several threads, the last block is partial
+    for n in [1, 2, 5, 9]:
+        check_elementwise_sum_with_shape((3, 40001), n)
 
 
 def check_concat_with_shape(shapes, dimension, skip_second):
@@ -3033,6 +3040,57 @@ def test_ctc_loss():
     check_ctc_loss(acts2, labels2, true_loss)
 
     
+def test_embedding_row_sparse_grad():
+    data = mx.nd.array([[2, 0], [2, 5]])
+    grad = mx.nd.array(np.arange(8).reshape((2, 2, 2)))
+    row_ids, values = mx.contrib.nd.embedding_row_sparse_grad(data, grad, input_dim=4, output_dim=2)
+    # ids are clipped to input_dim like Embedding does
+    assert same(row_ids.asnumpy(), np.array([0, 2, 3, -1]))
+    assert same(values.asnumpy(), np.array([[2, 3], [4, 6], [6, 7], [0, 0]]))
+
+    weight = mx.nd.ones((4, 2))
+    mx.nd.sparse_sgd_update(weight, values, row_ids, out=weight, lr=0.5)
+    expected = np.ones((4, 2))
+    expected[[0, 2, 3]] -= 0.5 * values.asnumpy()[:3]
+    assert same(weight.asnumpy(), expected)
+
+    weight = mx.nd.ones((4, 2))
+    mom = mx.nd.zeros((4, 2))
+    for i in range(2):
+        mx.nd.sparse_sgd_mom_update(weight, values, row_ids, mom, out=weight,
+                                    lr=0.5, momentum=0.9)
+    assert same(mom.asnumpy()[1], np.zeros(2))
+    assert same(weight.asnumpy()[1], np.ones(2))
+    assert_almost_equal(mom.asnumpy()[0], -0.5 * 1.9 * np.array([2, 3]))
+
+
+def test_sparse_sgd_large_row():
+    # the offset of row 2^21 + 1 of a 1024 wide weight is above 2^31
+    num_rows, row_length = (1 << 21) + 2, 1024
+    # the float16 weight takes 4GB, skip where it does not fit
+    try:
+        with open('/proc/meminfo') as f:
+            info = dict(line.split(':', 1) for line in f)
+        if int(info['MemAvailable'].split()[0]) < (12 << 20):
+            return
+    except (IOError, KeyError):
+        return
+    row = num_rows - 1
+    weight = mx.nd.empty((num_rows, row_length), dtype='float16')
+    weight[row - 1:row + 1] = 0
+    row_ids = mx.nd.array([row, -1])
+    values = mx.nd.ones((2, row_length), dtype='float16')
+    mx.nd.sparse_sgd_update(weight, values, row_ids, out=weight, lr=0.5)
+    assert same(weight[row].asnumpy(), np.full(row_length, -0.5, dtype=np.float16))
+    assert same(weight[row - 1].asnumpy(), np.zeros(row_length, dtype=np.float16))
+    mom = mx.nd.empty((num_rows, row_length), dtype='float16')
+    mom[row:row + 1] = 0
+    weight[row:row + 1] = 0
+    mx.nd.sparse_sgd_mom_update(weight, values, row_ids, mom, out=weight, lr=0.5, momentum=0.9)
+    assert same(mom[row].asnumpy(), np.full(row_length, -0.5, dtype=np.float16))
+    assert same(weight[row].asnumpy(), np.full(row_length, -0.5, dtype=np.float16))
+
+
 def test_quantization_op():
   min0 = mx.nd.array([0.0])
   max0 = mx.nd.array([1.0])
@@ -3047,6 +3105,112 @@ def test_quantization_op():
   assert same(a_.asnumpy(),  a_real.asnumpy())
 
 
+def test_normalize_image():
+    data = np.random.randint(0, 256, size=(2, 5, 4, 3)).astype(np.uint8)
+    mean = (123.0, 117.0, 104.0)
+    std = (58.0, 57.0, 57.5)
+    expected = (data.astype(np.float32) - np.array(mean)) / np.array(std)
+    expected = expected.transpose(0, 3, 1, 2)
+    out = mx.contrib.nd.normalize_image(mx.nd.array(data, dtype='uint8'), mean=mean, std=std)
+    assert out.dtype == np.float32
+    assert_almost_equal(out.asnumpy(), expected, rtol=1e-5, atol=1e-5)
+    nchw = mx.nd.array(data.transpose(0, 3, 1, 2), dtype='uint8')
+    out = mx.contrib.nd.normalize_image(nchw, mean=(127.5,), std=(127.5,), in_layout='NCHW')
+    assert_almost_equal(out.asnumpy(), (data.transpose(0, 3, 1, 2) - 127.5) / 127.5,
+                        rtol=1e-5, atol=1e-5)
+    sym = mx.contrib.sym.normalize_image(mx.sym.Variable('data'))
+    _, out_shapes, _ = sym.infer_shape(data=(2, 5, 4, 3))
+    assert out_shapes == [(2, 3, 5, 4)]
+
+
+def test_quantize_graph():
+    data = mx.sym.Variable('data')
+    conv = mx.sym.Convolution(data, kernel=(3, 3), pad=(1, 1), num_filter=4, name='conv')
+    act = mx.sym.Activation(conv, act_type='relu')
+    fc = mx.sym.FullyConnected(act, num_hidden=5, name='fc')
+    qsym = mx.contrib.quantization.quantize_graph(fc)
+    # the weights and biases are quantized once, at conversion time
+    assert 'data' in qsym.list_arguments()
+    assert 'fc_weight' not in qsym.list_arguments()
+    assert 'fc_weight_quantized' in qsym.list_arguments()
+    assert '_contrib_quantize' in qsym.tojson()
+    args = {'data': mx.nd.array(np.random.uniform(-1, 1, (2, 3, 6, 6))),
+            'conv_weight': mx.nd.array(np.random.uniform(-1, 1, (4, 3, 3, 3))),
+            'conv_bias': mx.nd.array(np.random.uniform(-1, 1, (4,))),
+            'fc_weight': mx.nd.array(np.random.uniform(-1, 1, (5, 144))),
+            'fc_bias': mx.nd.array(np.random.uniform(-1, 1, (5,)))}
+    out = fc.bind(mx.cpu(), args).forward()[0].asnumpy()
+    qargs = mx.contrib.quantization.quantize_params(qsym, args)
+    assert sorted(qargs.keys()) == sorted(qsym.list_arguments())
+    assert qargs['fc_weight_quantized'].dtype == np.uint8
+    qout = qsym.bind(mx.cpu(), qargs).forward()[0].asnumpy()
+    assert np.abs(out - qout).max() < 0.1 * np.abs(out).max()
+    # the shapes of the weights are inferred from the data shape alone
+    exe = qsym.simple_bind(mx.cpu(), data=(2, 3, 6, 6))
+    assert exe.arg_dict['fc_weight_quantized'].shape == (5, 144)
+
+    # consecutive quantized layers are connected by requantize
+    fc2 = mx.sym.FullyConnected(conv, num_hidden=5, name='fc')
+    qsym2 = mx.contrib.quantization.quantize_graph(fc2)
+    assert '_contrib_requantize' in qsym2.tojson()
+    out = fc2.bind(mx.cpu(), args).forward()[0].asnumpy()
+    qargs2 = mx.contrib.quantization.quantize_params(qsym2, args)
+    qout = qsym2.bind(mx.cpu(), qargs2).forward()[0].asnumpy()
+    assert np.abs(out - qout).max() < 0.1 * np.abs(out).max()
+
+
+def test_dequantize_int32():
+    # the int32 outputs of the quantized layers are symmetric
+    data = mx.nd.array([-2147483647, -3, 0, 7, 2147483647], dtype='int32')
+    scale = 1e-3
+    min_range = mx.nd.array([-scale * 2147483647])
+    max_range = mx.nd.array([scale * 2147483647])
+    out = mx.contrib.nd.dequantize(data, min_range, max_range, out_type='float32')
+    assert_almost_equal(out.asnumpy(), data.asnumpy().astype(np.float64) * scale, rtol=1e-6)
+    assert out.asnumpy()[2] == 0
+
+
+def run_cpu_autotune_net(fin, fout):
+    x = mx.sym.Variable('x')
+    conv = mx.sym.Convolution(data=x, num_filter=8, kernel=(3, 3), pad=(1, 1), name='conv')
+    net = mx.sym.FullyConnected(data=conv, num_hidden=10, name='fc')
+    args = mx.nd.load(fin)
+    grads = {k: mx.nd.zeros(v.shape) for k, v in args.items()}
+    exe = net.bind(mx.cpu(), args=args, args_grad=grads)
+    results = {}
+    # the first pass times the candidates, the second one runs the selected one
+    for i in range(2):
+        exe.forward(is_train=True)
+        exe.backward(mx.nd.ones(exe.outputs[0].shape))
+        results['out%d' % i] = exe.outputs[0].copy()
+        for k, v in grads.items():
+            results['%s_grad%d' % (k, i)] = v.copy()
+    mx.nd.save(fout, results)
+
+
+def test_cpu_autotune():
+    fin, fout, fref = tempfile.mktemp(), tempfile.mktemp(), tempfile.mktemp()
+    args = {'x': mx.nd.uniform(-1, 1, shape=(4, 3, 10, 10)),
+            'conv_weight': mx.nd.uniform(-1, 1, shape=(8, 3, 3, 3)),
+            'conv_bias': mx.nd.uniform(-1, 1, shape=(8,)),
+            'fc_weight': mx.nd.uniform(-1, 1, shape=(10, 800)),
+            'fc_bias': mx.nd.uniform(-1, 1, shape=(10,))}
+    mx.nd.save(fin, args)
+    run_cpu_autotune_net(fin, fout)
+    # MXNET_CPU_AUTOTUNE is read once, the untuned ops run in another process
+    script = 'import sys; sys.path.insert(0, %r); import test_operator; ' \
+             'test_operator.run_cpu_autotune_net(%r, %r)' % \
+             (os.path.dirname(os.path.abspath(__file__)), fin, fref)
+    env = dict(os.environ, MXNET_CPU_AUTOTUNE='0')
+    subprocess.check_call([sys.executable, '-c', script], env=env)
+    tuned, untuned = mx.nd.load(fout), mx.nd.load(fref)
+    assert sorted(tuned.keys()) == sorted(untuned.keys())
+    for k in tuned:
+        assert_almost_equal(tuned[k].asnumpy(), untuned[k].asnumpy(), rtol=1e-4, atol=1e-4)
+    for f in [fin, fout, fref]:
+        os.remove(f)
+
+
 def test_custom_op():
     class Sqr(mx.operator.CustomOp):
         def forward(self, is_train, req, in_data, out_data, aux):
@@ -3087,9 +3251,108 @@ def test_custom_op():
     x = mx.nd.array(np.random.uniform(-1, 1, size=(4, 10)))
     check_numeric_gradient(op, [x])
 
+def test_custom_op_shared_threads():
+    class Plus(mx.operator.CustomOp):
+        def __init__(self, value):
+            super(Plus, self).__init__()
+            self.value = value
+
+        def forward(self, is_train, req, in_data, out_data, aux):
+            self.assign(out_data[0], req[0], in_data[0] + self.value)
+
+        def backward(self, req, out_grad, in_data, out_data, in_grad, aux):
+            self.assign(in_grad[0], req[0], out_grad[0])
+
+    @mx.operator.register("plus_value")
+    class PlusProp(mx.operator.CustomOpProp):
+        def __init__(self, value):
+            super(PlusProp, self).__init__(need_top_grad=True)
+            self.value = float(value)
+
+        def infer_shape(self, in_shape):
+            return in_shape, [in_shape[0]], []
+
+        def create_operator(self, ctx, shapes, dtypes):
+            return Plus(self.value)
+
+    def num_threads():
+        return len(os.listdir('/proc/self/task')) if os.path.isdir('/proc/self/task') else 0
+
+    # a chain of custom layers in many executors
+    num_layers, num_execs = 10, 8
+    net = mx.symbol.Variable('data')
+    for i in range(num_layers):
+        net = mx.symbol.Custom(data=net, value=i, op_type='plus_value')
+    x = mx.nd.ones((2, 3))
+    threads_before = num_threads()
+    execs = [net.bind(mx.cpu(), {'data': x + j}, args_grad={'data': mx.nd.zeros((2, 3))})
+             for j in range(num_execs)]
+    for exe in execs:
+        exe.forward(is_train=True)
+        exe.backward([mx.nd.ones((2, 3))])
+    expected = sum(range(num_layers))
+    for j, exe in enumerate(execs):
+        assert_almost_equal(exe.outputs[0].asnumpy(), np.full((2, 3), 1 + j + expected))
+        assert_almost_equal(exe.grad_arrays[0].asnumpy(), np.ones((2, 3)))
+    # the callbacks are run by a bounded pool and its monitor thread, not by one
+    # thread per operator
+    pool_size = int(os.environ.get('MXNET_CUSTOM_OP_NUM_THREADS', 4))
+    assert num_threads() - threads_before <= pool_size + 1 + 2
+
+
+def test_custom_op_nested_wait():
+    class Inner(mx.operator.CustomOp):
+        def forward(self, is_train, req, in_data, out_data, aux):
+            self.assign(out_data[0], req[0], in_data[0] + 1)
+
+        def backward(self, req, out_grad, in_data, out_data, in_grad, aux):
+            self.assign(in_grad[0], req[0], out_grad[0])
+
+    @mx.operator.register("nested_inner")
+    class InnerProp(mx.operator.CustomOpProp):
+        def __init__(self):
+            super(InnerProp, self).__init__(need_top_grad=True)
+
+        def infer_shape(self, in_shape):
+            return in_shape, [in_shape[0]], []
+
+        def create_operator(self, ctx, shapes, dtypes):
+            return Inner()
+
+    class Outer(mx.operator.CustomOp):
+        def forward(self, is_train, req, in_data, out_data, aux):
+            # waits in the callback for the callback of the nested operator
+            y = mx.nd.Custom(in_data[0], op_type='nested_inner').asnumpy()
+            self.assign(out_data[0], req[0], mx.nd.array(y))
+
+        def backward(self, req, out_grad, in_data, out_data, in_grad, aux):
+            self.assign(in_grad[0], req[0], out_grad[0])
+
+    @mx.operator.register("nested_outer")
+    class OuterProp(mx.operator.CustomOpProp):
+        def __init__(self):
+            super(OuterProp, self).__init__(need_top_grad=True)
+
+        def infer_shape(self, in_shape):
+            return in_shape, [in_shape[0]], []
+
+        def create_operator(self, ctx, shapes, dtypes):
+            return Outer()
+
+    # more outer callbacks waiting at once than threads in the pool
+    num_execs = 2 * int(os.environ.get('MXNET_CUSTOM_OP_NUM_THREADS', 4)) + 1
+    net = mx.symbol.Custom(data=mx.symbol.Variable('data'), op_type='nested_outer')
+    execs = [net.bind(mx.cpu(), {'data': mx.nd.ones((2, 3)) * j}) for j in range(num_execs)]
+    for exe in execs:
+        exe.forward(is_train=False)
+    for j, exe in enumerate(execs):
+        assert_almost_equal(exe.outputs[0].asnumpy(), np.full((2, 3), j + 1))
+
 
 if __name__ == '__main__':
     test_custom_op()
+    test_custom_op_shared_threads()
+    test_custom_op_nested_wait()
     test_log_softmax()
     test_new_softmax()
     test_pick()
@@ -3154,6 +3417,12 @@ if __name__ == '__main__':
     test_one_hot()
     test_where()
     test_ctc_loss()
+    test_embedding_row_sparse_grad()
+    test_sparse_sgd_large_row()
     test_quantization_op()
+    test_normalize_image()
+    test_quantize_graph()
+    test_dequantize_int32()
+    test_cpu_autotune()
     test_relu()
     test_sigmoid()
@@ -350,7 +350,30 @@ def test_rms():
     for kwarg in kwargs:
         compare_optimizer(opt1(**kwarg), opt2(**kwarg), shape)
 
+def test_multi_sgd_update():
+    shapes = [(3, 4), (10,), (2, 5, 6)]
+    kwargs = {'lr': 0.1, 'wd': 0.01, 'rescale_grad': 0.5, 'clip_gradient': 1.0}
+    weights = [mx.nd.array(np.random.uniform(-1, 1, s)) for s in shapes]
+    grads = [mx.nd.array(np.random.uniform(-3, 3, s)) for s in shapes]
+    moms = [mx.nd.array(np.random.uniform(-1, 1, s)) for s in shapes]
+    moms2 = [m.copy() for m in moms]
+
+    data = sum([[w, g] for w, g in zip(weights, grads)], [])
+    outs = mx.nd.multi_sgd_update(*data, num_weights=len(shapes), **kwargs)
+    for w, g, out in zip(weights, grads, outs):
+        expected = mx.nd.sgd_update(w, g, **kwargs)
+        assert_almost_equal(out.asnumpy(), expected.asnumpy())
+
+    data = sum([[w, g, m] for w, g, m in zip(weights, grads, moms)], [])
+    outs = mx.nd.multi_sgd_mom_update(*data, num_weights=len(shapes), momentum=0.9, **kwargs)
+    for w, g, m, m2, out in zip(weights, grads, moms, moms2, outs):
+        expected = mx.nd.sgd_mom_update(w, g, m2, momentum=0.9, **kwargs)
+        assert_almost_equal(out.asnumpy(), expected.asnumpy())
+        assert_almost_equal(m.asnumpy(), m2.asnumpy())
+
+
 if __name__ == '__main__':
     test_adam()
     test_rms()
     test_sgd()
+    test_multi_sgd_update()
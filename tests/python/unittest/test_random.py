@@ -1,5 +1,6 @@
 import os
 import mxnet as mx
+from mxnet.contrib import autograd
 import numpy as np
 
 def same(a, b):
@@ -169,7 +170,27 @@ def test_random():
     check_with_device(mx.context.current_context(), 'float32')
     check_with_device(mx.context.current_context(), 'float64')
 
+def test_parallel_random():
+    # operators spread over the generator copies reproduce their values for a seed
+    shape = (33, 17)
+    def run():
+        mx.random.seed(42)
+        outs = [mx.nd.random_uniform(shape=shape) for _ in range(8)]
+        outs += [mx.nd.random_normal(shape=shape) for _ in range(8)]
+        outs.append(mx.nd.Dropout(mx.nd.ones(shape), p=0.3))
+        return [out.asnumpy() for out in outs]
+    with autograd.train():
+        ret1 = run()
+        ret2 = run()
+    for a, b in zip(ret1, ret2):
+        assert same(a, b)
+    for i in range(1, 8):
+        assert not same(ret1[0], ret1[i])
+    dropped = ret1[-1]
+    assert same(dropped[dropped != 0], np.full((np.sum(dropped != 0),), 1.0 / 0.7, dtype=np.float32))
+    assert abs(np.mean(dropped == 0) - 0.3) < 0.05
 
 
 if __name__ == '__main__':
     test_random()
+    test_parallel_random()
@@ -8,12 +8,18 @@
  *  Image List Format: unique-image-index label[s] path-to-image
  * \sa dmlc/recordio.h
  */
+#include <algorithm>
 #include <cctype>
 #include <cstring>
 #include <string>
 #include <vector>
 #include <iomanip>
 #include <sstream>
+#include <map>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 #include <dmlc/base.h>
 #include <dmlc/io.h>
 #include <dmlc/timer.h>
@@ -42,6 +48,126 @@ int GetInterMethod(int inter_method, int old_width, int old_height, int new_widt
         return inter_method;
     }
 }
+/*! \brief options of converting one image */
+struct PackOptions {
+  std::string root;
+  int label_width;
+  int pack_label;
+  int new_size;
+  int center_crop;
+  int color_mode;
+  int unchanged;
+  int inter_method;
+  std::string encoding;
+  std::vector<int> encode_params;
+};
+/*! \brief a packed record, invalid for list lines that are skipped */
+struct PackedRecord {
+  bool valid;
+  uint64_t image_id;
+  std::string blob;
+};
+/*!
+ * \brief convert the image of one line of the list into a record.
+ *  Buffers are per worker so that they are reused across images.
+ */
+void PackImage(const std::string &sline, const PackOptions &opt, std::mt19937 &prnd,
+               std::vector<unsigned char> *decode_buf, std::vector<unsigned char> *encode_buf,
+               std::vector<float> *label_buf, PackedRecord *out) {
+  using namespace dmlc;
+  const static size_t kBufferSize = 1 << 20UL;
+  mxnet::io::ImageRecordIO rec;
+  std::string fname, path;
+  std::string &blob = out->blob;
+  std::istringstream is(sline);
+  out->valid = false;
+  blob.clear();
+  if (!(is >> rec.header.image_id[0] >> rec.header.label)) return;
+  (*label_buf)[0] = rec.header.label;
+  for (int k = 1; k < opt.label_width; ++k) {
+    CHECK(is >> (*label_buf)[k])
+        << "Invalid ImageList, did you provide the correct label_width?";
+  }
+  if (opt.pack_label) rec.header.flag = opt.label_width;
+  rec.SaveHeader(&blob);
+  if (opt.pack_label) {
+    size_t bsize = blob.size();
+    blob.resize(bsize + label_buf->size()*sizeof(float));
+    memcpy(BeginPtr(blob) + bsize,
+           BeginPtr(*label_buf), label_buf->size()*sizeof(float));
+  }
+  CHECK(std::getline(is, fname));
+  // eliminate invalid chars in the end
+  while (fname.length() != 0 &&
+         (isspace(*fname.rbegin()) || !isprint(*fname.rbegin()))) {
+    fname.resize(fname.length() - 1);
+  }
+  // eliminate invalid chars in beginning.
+  const char *p = fname.c_str();
+  while (isspace(*p)) ++p;
+  path = opt.root + p;
+  // use "r" is equal to rb in dmlc::Stream
+  dmlc::Stream *fi = dmlc::Stream::Create(path.c_str(), "r");
+  decode_buf->clear();
+  size_t imsize = 0;
+  while (true) {
+    decode_buf->resize(imsize + kBufferSize);
+    size_t nread = fi->Read(BeginPtr(*decode_buf) + imsize, kBufferSize);
+    imsize += nread;
+    decode_buf->resize(imsize);
+    if (nread != kBufferSize) break;
+  }
+  delete fi;
+
+  if (opt.unchanged != 1) {
+    const int new_size = opt.new_size;
+    cv::Mat img = cv::imdecode(*decode_buf, opt.color_mode);
+    CHECK(img.data != NULL) << "OpenCV decode fail:" << path;
+    cv::Mat res = img;
+    if (new_size > 0) {
+      if (opt.center_crop) {
+        if (img.rows > img.cols) {
+          int margin = (img.rows - img.cols)/2;
+          img = img(cv::Range(margin, margin+img.cols), cv::Range(0, img.cols));
+        } else {
+          int margin = (img.cols - img.rows)/2;
+          img = img(cv::Range(0, img.rows), cv::Range(margin, margin + img.rows));
+        }
+      }
+      int interpolation_method = 1;
+      if (img.rows > img.cols) {
+          if (img.cols != new_size) {
+              interpolation_method = GetInterMethod(opt.inter_method, img.cols, img.rows, new_size, img.rows * new_size / img.cols, prnd);
+              cv::resize(img, res, cv::Size(new_size, img.rows * new_size / img.cols), 0, 0, interpolation_method);
+          } else {
+              res = img.clone();
+          }
+      } else {
+          if (img.rows != new_size) {
+              interpolation_method = GetInterMethod(opt.inter_method, img.cols, img.rows, new_size * img.cols / img.rows, new_size, prnd);
+              cv::resize(img, res, cv::Size(new_size * img.cols / img.rows, new_size), 0, 0, interpolation_method);
+          } else {
+              res = img.clone();
+          }
+      }
+    }
+    encode_buf->clear();
+    CHECK(cv::imencode(opt.encoding, res, *encode_buf, opt.encode_params));
+
+    // write buffer
+    size_t bsize = blob.size();
+    blob.resize(bsize + encode_buf->size());
+    memcpy(BeginPtr(blob) + bsize,
+           BeginPtr(*encode_buf), encode_buf->size());
+  } else {
+    size_t bsize = blob.size();
+    blob.resize(bsize + decode_buf->size());
+    memcpy(BeginPtr(blob) + bsize,
+           BeginPtr(*decode_buf), decode_buf->size());
+  }
+  out->image_id = rec.header.image_id[0];
+  out->valid = true;
+}
 int main(int argc, char *argv[]) {
   if (argc < 4) {
     printf("Usage: <image.lst> <image_root_dir> <output.rec> [additional parameters in form key=value]\n"\
@@ -56,7 +182,9 @@ int main(int argc, char *argv[]) {
            "\tquality=QUALITY[default=95] JPEG quality for encoding (1-100, default: 95) or PNG compression for encoding (1-9, default: 3).\n"\
            "\tencoding=ENCODING[default='.jpg'] Encoding type. Can be '.jpg' or '.png'\n"\
            "\tinter_method=INTER_METHOD[default=1] NN(0) BILINEAR(1) CUBIC(2) AREA(3) LANCZOS4(4) AUTO(9) RAND(10).\n"\
-           "\tunchanged=UNCHANGED[default=0] Keep the original image encoding, size and color. If set to 1, it will ignore the others parameters.\n");
+           "\tunchanged=UNCHANGED[default=0] Keep the original image encoding, size and color. If set to 1, it will ignore the others parameters.\n"\
+           "\tnum_thread=NUM_THREAD[default=1] number of threads decoding, resizing and encoding images. The output order is the order of the list.\n"\
+           "\tnum_shard=NUM_SHARD[default=1] write the records round-robin to NUM_SHARD files <output>_NNN.rec, each with its <output>_NNN.idx.\n");
     return 0;
   }
   int label_width = 1;
@@ -69,6 +197,8 @@ int main(int argc, char *argv[]) {
   int color_mode = CV_LOAD_IMAGE_COLOR;
   int unchanged = 0;
   int inter_method = CV_INTER_LINEAR;
+  int num_thread = 1;
+  int num_shard = 1;
   std::string encoding(".jpg");
   for (int i = 4; i < argc; ++i) {
     char key[128], val[128];
@@ -92,6 +222,8 @@ int main(int argc, char *argv[]) {
       if (!strcmp(key, "encoding")) encoding = std::string(val);
       if (!strcmp(key, "unchanged")) unchanged = atoi(val);
       if (!strcmp(key, "inter_method")) inter_method = atoi(val);
+      if (!strcmp(key, "num_thread")) num_thread = atoi(val);
+      if (!strcmp(key, "num_shard")) num_shard = atoi(val);
     }
   }
   // Check parameters ranges
@@ -104,6 +236,9 @@ int main(int argc, char *argv[]) {
   if (label_width <= 1 && pack_label) {
     LOG(FATAL) << "pack_label can only be used when label_width > 1";
   }
+  if (num_thread < 1 || num_shard < 1) {
+    LOG(FATAL) << "num_thread and num_shard must be positive.";
+  }
   if (new_size > 0) {
     LOG(INFO) << "New Image Size: Short Edge " << new_size;
   } else {
@@ -149,11 +284,25 @@ int main(int argc, char *argv[]) {
       }
   }
   std::random_device rd;
-  std::mt19937 prnd(rd());
-  using namespace dmlc;
-  const static size_t kBufferSize = 1 << 20UL;
-  std::string root = argv[2];
-  mxnet::io::ImageRecordIO rec;
+  PackOptions opt;
+  opt.root = argv[2];
+  opt.label_width = label_width;
+  opt.pack_label = pack_label;
+  opt.new_size = new_size;
+  opt.center_crop = center_crop;
+  opt.color_mode = color_mode;
+  opt.unchanged = unchanged;
+  opt.inter_method = inter_method;
+  opt.encoding = encoding;
+  if (encoding == std::string(".png")) {
+      opt.encode_params.push_back(CV_IMWRITE_PNG_COMPRESSION);
+      opt.encode_params.push_back(quality);
+      LOG(INFO) << "PNG encoding compression: " << quality;
+  } else {
+      opt.encode_params.push_back(CV_IMWRITE_JPEG_QUALITY);
+      opt.encode_params.push_back(quality);
+      LOG(INFO) << "JPEG encoding quality: " << quality;
+  }
   size_t imcnt = 0;
   double tstart = dmlc::GetTime();
   dmlc::InputSplit *flist = dmlc::InputSplit::
@@ -164,121 +313,122 @@ int main(int argc, char *argv[]) {
   } else {
     os << argv[3] << ".part" << std::setw(3) << std::setfill('0') << partid;
   }
-  LOG(INFO) << "Write to output: " << os.str();
-  dmlc::Stream *fo = dmlc::Stream::Create(os.str().c_str(), "w");
-  LOG(INFO) << "Output: " << os.str();
-  dmlc::RecordIOWriter writer(fo);
-  std::string fname, path, blob;
-  std::vector<unsigned char> decode_buf;
-  std::vector<unsigned char> encode_buf;
-  std::vector<int> encode_params;
-  if (encoding == std::string(".png")) {
-      encode_params.push_back(CV_IMWRITE_PNG_COMPRESSION);
-      encode_params.push_back(quality);
-      LOG(INFO) << "PNG encoding compression: " << quality;
-  } else {
-      encode_params.push_back(CV_IMWRITE_JPEG_QUALITY);
-      encode_params.push_back(quality);
-      LOG(INFO) << "JPEG encoding quality: " << quality;
+  // every shard is a .rec with the index of its records next to it
+  std::string stem = os.str(), ext;
+  if (stem.length() > 4 && stem.substr(stem.length() - 4) == ".rec") {
+    ext = ".rec";
+    stem.resize(stem.length() - 4);
   }
-  dmlc::InputSplit::Blob line;
-  std::vector<float> label_buf(label_width, 0.f);
-
-  while (flist->NextRecord(&line)) {
-    std::string sline(static_cast<char*>(line.dptr), line.size);
-    std::istringstream is(sline);
-    if (!(is >> rec.header.image_id[0] >> rec.header.label)) continue;
-    label_buf[0] = rec.header.label;
-    for (int k = 1; k < label_width; ++k) {
-      CHECK(is >> label_buf[k])
-          << "Invalid ImageList, did you provide the correct label_width?";
-    }
-    if (pack_label) rec.header.flag = label_width;
-    rec.SaveHeader(&blob);
-    if (pack_label) {
-      size_t bsize = blob.size();
-      blob.resize(bsize + label_buf.size()*sizeof(float));
-      memcpy(BeginPtr(blob) + bsize,
-             BeginPtr(label_buf), label_buf.size()*sizeof(float));
-    }
-    CHECK(std::getline(is, fname));
-    // eliminate invalid chars in the end
-    while (fname.length() != 0 &&
-           (isspace(*fname.rbegin()) || !isprint(*fname.rbegin()))) {
-      fname.resize(fname.length() - 1);
-    }
-    // eliminate invalid chars in beginning.
-    const char *p = fname.c_str();
-    while (isspace(*p)) ++p;
-    path = root + p;
-    // use "r" is equal to rb in dmlc::Stream
-    dmlc::Stream *fi = dmlc::Stream::Create(path.c_str(), "r");
-    decode_buf.clear();
-    size_t imsize = 0;
-    while (true) {
-      decode_buf.resize(imsize + kBufferSize);
-      size_t nread = fi->Read(BeginPtr(decode_buf) + imsize, kBufferSize);
-      imsize += nread;
-      decode_buf.resize(imsize);
-      if (nread != kBufferSize) break;
-    }
-    delete fi;
+  std::vector<dmlc::Stream*> fo(num_shard), fidx(num_shard);
+  std::vector<dmlc::RecordIOWriter*> writer(num_shard);
+  for (int i = 0; i < num_shard; ++i) {
+    std::ostringstream name;
+    name << stem;
+    if (num_shard != 1) name << '_' << std::setw(3) << std::setfill('0') << i;
+    const std::string path_rec = name.str() + ext;
+    LOG(INFO) << "Write to output: " << path_rec;
+    fo[i] = dmlc::Stream::Create(path_rec.c_str(), "w");
+    fidx[i] = dmlc::Stream::Create((name.str() + ".idx").c_str(), "w");
+    writer[i] = new dmlc::RecordIOWriter(fo[i]);
+  }
+  LOG(INFO) << "Use " << num_thread << " threads";
 
+  // lines are numbered as they are read, workers convert them in any order and
+  // the records are written in the order of the numbers through a reorder buffer
+  // that bounds the number of lines in flight
+  const size_t kMaxInFlight = 64 * num_thread;
+  std::mutex mutex;
+  std::condition_variable cv_task, cv_done, cv_space;
+  std::deque<std::pair<size_t, std::string> > tasks;
+  std::map<size_t, PackedRecord> done;
+  size_t nline = 0, nwritten = 0;
+  bool eof = false;
 
-    if (unchanged != 1) {
-      cv::Mat img = cv::imdecode(decode_buf, color_mode);
-      CHECK(img.data != NULL) << "OpenCV decode fail:" << path;
-      cv::Mat res = img;
-      if (new_size > 0) {
-        if (center_crop) {
-          if (img.rows > img.cols) {
-            int margin = (img.rows - img.cols)/2;
-            img = img(cv::Range(margin, margin+img.cols), cv::Range(0, img.cols));
-          } else {
-            int margin = (img.cols - img.rows)/2;
-            img = img(cv::Range(0, img.rows), cv::Range(margin, margin + img.rows));
-          }
+  std::vector<std::thread> workers;
+  for (int t = 0; t < num_thread; ++t) {
+    const unsigned seed = rd();
+    workers.emplace_back([&, seed]() {
+      std::mt19937 prnd(seed);
+      std::vector<unsigned char> decode_buf;
+      std::vector<unsigned char> encode_buf;
+      std::vector<float> label_buf(label_width, 0.f);
+      while (true) {
+        std::pair<size_t, std::string> task;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          cv_task.wait(lock, [&]() { return !tasks.empty() || eof; });
+          if (tasks.empty()) return;
+          task = std::move(tasks.front());
+          tasks.pop_front();
         }
-        int interpolation_method = 1;
-        if (img.rows > img.cols) {
-            if (img.cols != new_size) {
-                interpolation_method = GetInterMethod(inter_method, img.cols, img.rows, new_size, img.rows * new_size / img.cols, prnd);
-                cv::resize(img, res, cv::Size(new_size, img.rows * new_size / img.cols), 0, 0, interpolation_method);
-            } else {
-                res = img.clone();
-            }
-        } else {
-            if (img.rows != new_size) {
-                interpolation_method = GetInterMethod(inter_method, img.cols, img.rows, new_size * img.cols / img.rows, new_size, prnd);
-                cv::resize(img, res, cv::Size(new_size * img.cols / img.rows, new_size), 0, 0, interpolation_method);
-            } else {
-                res = img.clone();
-            }
+        PackedRecord record;
+        PackImage(task.second, opt, prnd, &decode_buf, &encode_buf, &label_buf, &record);
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          done[task.first] = std::move(record);
         }
+        cv_done.notify_one();
       }
-      encode_buf.clear();
-      CHECK(cv::imencode(encoding, res, encode_buf, encode_params));
+    });
+  }
 
-      // write buffer
-      size_t bsize = blob.size();
-      blob.resize(bsize + encode_buf.size());
-      memcpy(BeginPtr(blob) + bsize,
-             BeginPtr(encode_buf), encode_buf.size());
-    } else {
-      size_t bsize = blob.size();
-      blob.resize(bsize + decode_buf.size());
-      memcpy(BeginPtr(blob) + bsize,
-             BeginPtr(decode_buf), decode_buf.size());
-    }
-    writer.WriteRecord(BeginPtr(blob), blob.size());
-    // write header
-    ++imcnt;
-    if (imcnt % 1000 == 0) {
-      LOG(INFO) << imcnt << " images processed, " << GetTime() - tstart << " sec elapsed";
+  std::thread writer_thread([&]() {
+    size_t nrecord = 0;
+    while (true) {
+      PackedRecord record;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv_done.wait(lock, [&]() {
+          return done.count(nwritten) != 0 || (eof && nwritten == nline);
+        });
+        if (done.count(nwritten) == 0) return;
+        record = std::move(done[nwritten]);
+        done.erase(nwritten);
+        ++nwritten;
+      }
+      cv_space.notify_one();
+      if (!record.valid) continue;
+      const int shard = nrecord % num_shard;
+      std::ostringstream idx_line;
+      idx_line << record.image_id << '\t' << writer[shard]->Tell() << '\n';
+      const std::string sidx = idx_line.str();
+      fidx[shard]->Write(sidx.c_str(), sidx.length());
+      writer[shard]->WriteRecord(dmlc::BeginPtr(record.blob), record.blob.size());
+      ++nrecord;
+      imcnt = nrecord;
+      if (nrecord % 1000 == 0) {
+        LOG(INFO) << nrecord << " images processed, " << dmlc::GetTime() - tstart
+                  << " sec elapsed";
+      }
     }
+  });
+
+  dmlc::InputSplit::Blob line;
+  while (flist->NextRecord(&line)) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv_space.wait(lock, [&]() { return nline - nwritten < kMaxInFlight; });
+    tasks.emplace_back(nline++, std::string(static_cast<char*>(line.dptr), line.size));
+    lock.unlock();
+    cv_task.notify_one();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    eof = true;
+  }
+  cv_task.notify_all();
+  cv_done.notify_all();
+  for (auto &worker : workers) worker.join();
+  writer_thread.join();
+
+  double elapsed = dmlc::GetTime() - tstart;
+  LOG(INFO) << "Total: " << imcnt << " images processed, " << elapsed << " sec elapsed, "
+            << imcnt / std::max(elapsed, 1e-6) << " images/sec with " << num_thread
+            << " threads";
+  for (int i = 0; i < num_shard; ++i) {
+    delete writer[i];
+    delete fo[i];
+    delete fidx[i];
   }
-  LOG(INFO) << "Total: " << imcnt << " images processed, " << GetTime() - tstart << " sec elapsed";
-  delete fo;
   delete flist;
   return 0;
 }
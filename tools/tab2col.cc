@@ -0,0 +1,225 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file tab2col.cc
+ * \brief convert CSV or LibSVM text into the columnar binary format read by ColumnarIter
+ *
+ *  CSV: one row per line, values separated by commas, the first label_width
+ *  values are the labels.
+ *  LibSVM: label index:value ..., indices start at 1 unless zero_based=1,
+ *  missing features are 0.
+ * \sa src/io/columnar_format.h
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <dmlc/base.h>
+#include <dmlc/io.h>
+#include <dmlc/logging.h>
+#include <dmlc/timer.h>
+#include <mshadow/base.h>
+#include "../src/io/columnar_format.h"
+
+using mxnet::io::columnar::Writer;
+
+/*! \brief mshadow type flag of a type name */
+int GetTypeFlag(const std::string &name) {
+  if (name == "float32") return mshadow::kFloat32;
+  if (name == "float64") return mshadow::kFloat64;
+  if (name == "float16") return mshadow::kFloat16;
+  if (name == "int32") return mshadow::kInt32;
+  if (name == "uint8") return mshadow::kUint8;
+  LOG(FATAL) << "unknown type " << name
+             << ", must be float32, float64, float16, int32 or uint8";
+  return -1;
+}
+
+/*! \brief parse a CSV line into values, returns false for a blank line */
+bool ParseCSV(const std::string &line, std::vector<float> *values) {
+  values->clear();
+  const char *p = line.c_str();
+  while (*p == ' ' || *p == '\t') ++p;
+  if (*p == '\0' || *p == '\r') return false;
+  while (true) {
+    char *end;
+    values->push_back(std::strtof(p, &end));
+    CHECK(end != p) << "invalid CSV line: " << line;
+    p = end;
+    while (*p == ' ' || *p == '\t' || *p == '\r') ++p;
+    if (*p != ',') break;
+    ++p;
+  }
+  CHECK(*p == '\0') << "invalid CSV line: " << line;
+  return true;
+}
+
+/*!
+ * \brief parse a LibSVM line into the label and (index, value) pairs,
+ *  returns false for a blank line
+ */
+bool ParseLibSVM(const std::string &line, float *label,
+                 std::vector<std::pair<size_t, float> > *features) {
+  features->clear();
+  const char *p = line.c_str();
+  char *end;
+  while (*p == ' ' || *p == '\t') ++p;
+  if (*p == '\0' || *p == '\r' || *p == '#') return false;
+  *label = std::strtof(p, &end);
+  CHECK(end != p) << "invalid LibSVM line: " << line;
+  p = end;
+  while (true) {
+    while (*p == ' ' || *p == '\t' || *p == '\r') ++p;
+    if (*p == '\0' || *p == '#') break;
+    if (!std::strncmp(p, "qid:", 4)) {
+      // query ids are not kept
+      while (*p != '\0' && *p != ' ' && *p != '\t') ++p;
+      continue;
+    }
+    const size_t index = std::strtoull(p, &end, 10);
+    CHECK(end != p && *end == ':') << "invalid LibSVM line: " << line;
+    p = end + 1;
+    const float value = std::strtof(p, &end);
+    CHECK(end != p) << "invalid LibSVM line: " << line;
+    p = end;
+    features->push_back(std::make_pair(index, value));
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    printf("Usage: <input> <output> [additional parameters in form key=value]\n"\
+           "Possible additional parameters:\n"\
+           "\tformat=FORMAT[default=csv] csv or libsvm.\n"\
+           "\tlabel_width=WIDTH[default=1] number of leading label values of a CSV row, can be 0. LibSVM has 1 label.\n"\
+           "\tnum_features=NUM[default=0] number of LibSVM features, 0 to find the largest index with an extra pass over the input.\n"\
+           "\tzero_based=ZERO_BASED[default=0] whether LibSVM indices start at 0.\n"\
+           "\tdata_dtype=DTYPE[default=float32] type of the data columns, float32, float64, float16, int32 or uint8.\n"\
+           "\tlabel_dtype=DTYPE[default=float32] type of the label columns.\n"\
+           "\tchunk_rows=ROWS[default=65536] number of rows per chunk.\n"\
+           "\tcompress=COMPRESS[default=0] whether to compress the columns of each chunk.\n");
+    return 0;
+  }
+  std::string format("csv");
+  int label_width = 1;
+  size_t num_features = 0;
+  int zero_based = 0;
+  std::string data_dtype("float32");
+  std::string label_dtype("float32");
+  size_t chunk_rows = 65536;
+  int compress = 0;
+  for (int i = 3; i < argc; ++i) {
+    char key[128], val[128];
+    int effct_len = 0;
+
+#ifdef _MSC_VER
+    effct_len = sscanf_s(argv[i], "%[^=]=%s", key, sizeof(key), val, sizeof(val));
+#else
+    effct_len = sscanf(argv[i], "%[^=]=%s", key, val);
+#endif
+
+    if (effct_len == 2) {
+      if (!strcmp(key, "format")) format = std::string(val);
+      if (!strcmp(key, "label_width")) label_width = atoi(val);
+      if (!strcmp(key, "num_features")) num_features = strtoull(val, nullptr, 10);
+      if (!strcmp(key, "zero_based")) zero_based = atoi(val);
+      if (!strcmp(key, "data_dtype")) data_dtype = std::string(val);
+      if (!strcmp(key, "label_dtype")) label_dtype = std::string(val);
+      if (!strcmp(key, "chunk_rows")) chunk_rows = strtoull(val, nullptr, 10);
+      if (!strcmp(key, "compress")) compress = atoi(val);
+    }
+  }
+  CHECK(format == "csv" || format == "libsvm") << "format must be csv or libsvm";
+  CHECK_GE(label_width, 0) << "label_width must not be negative";
+  CHECK_GT(chunk_rows, 0U) << "chunk_rows must be positive";
+  const bool libsvm = format == "libsvm";
+  if (libsvm) label_width = 1;
+
+  std::vector<float> values;
+  std::vector<std::pair<size_t, float> > features;
+  float label;
+  std::string line;
+  if (libsvm && num_features == 0) {
+    std::ifstream fi(argv[1]);
+    CHECK(fi) << "cannot open " << argv[1];
+    while (std::getline(fi, line)) {
+      if (!ParseLibSVM(line, &label, &features)) continue;
+      for (const auto &f : features) {
+        num_features = std::max(num_features, f.first + (zero_based ? 1 : 0));
+      }
+    }
+    LOG(INFO) << "Found " << num_features << " features";
+  }
+
+  std::ifstream fi(argv[1]);
+  CHECK(fi) << "cannot open " << argv[1];
+  std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(argv[2], "w"));
+  std::unique_ptr<Writer> writer;
+  std::vector<int> dtypes;
+  // the current chunk, column by column
+  std::vector<std::vector<float> > columns;
+  size_t nrow = 0, total = 0;
+  double tstart = dmlc::GetTime();
+
+  auto flush = [&]() {
+    std::vector<std::vector<char> > buffers(columns.size());
+    std::vector<const void*> ptrs(columns.size());
+    for (size_t c = 0; c < columns.size(); ++c) {
+      buffers[c].resize(nrow * mshadow::mshadow_sizeof(dtypes[c]));
+      MSHADOW_TYPE_SWITCH(dtypes[c], DType, {
+        DType *dptr = reinterpret_cast<DType*>(dmlc::BeginPtr(buffers[c]));
+        for (size_t i = 0; i < nrow; ++i) dptr[i] = static_cast<DType>(columns[c][i]);
+      });
+      ptrs[c] = dmlc::BeginPtr(buffers[c]);
+      columns[c].clear();
+    }
+    writer->WriteChunk(ptrs, nrow);
+    total += nrow;
+    nrow = 0;
+  };
+
+  while (std::getline(fi, line)) {
+    if (libsvm) {
+      if (!ParseLibSVM(line, &label, &features)) continue;
+      values.assign(1 + num_features, 0.0f);
+      values[0] = label;
+      for (const auto &f : features) {
+        CHECK(zero_based || f.first != 0) << "LibSVM index 0 with zero_based=0: " << line;
+        const size_t index = zero_based ? f.first : f.first - 1;
+        CHECK_LT(index, num_features) << "LibSVM index beyond num_features: " << line;
+        values[1 + index] = f.second;
+      }
+    } else {
+      if (!ParseCSV(line, &values)) continue;
+    }
+    if (writer == nullptr) {
+      CHECK_GE(values.size(), static_cast<size_t>(label_width))
+          << "CSV row shorter than label_width: " << line;
+      for (size_t c = 0; c < values.size(); ++c) {
+        dtypes.push_back(GetTypeFlag(c < static_cast<size_t>(label_width) ? label_dtype
+                                                                          : data_dtype));
+      }
+      columns.resize(values.size());
+      writer.reset(new Writer(fo.get(), dtypes, label_width, compress != 0));
+    }
+    CHECK_EQ(values.size(), columns.size()) << "rows have different lengths: " << line;
+    for (size_t c = 0; c < values.size(); ++c) columns[c].push_back(values[c]);
+    if (++nrow == chunk_rows) {
+      flush();
+      if (total % (chunk_rows * 16) == 0) {
+        LOG(INFO) << total << " rows converted, " << (dmlc::GetTime() - tstart) << " sec elapsed";
+      }
+    }
+  }
+  CHECK(writer != nullptr) << "no row in " << argv[1];
+  if (nrow != 0) flush();
+  writer->Close();
+  LOG(INFO) << "Total: " << total << " rows of " << columns.size() << " columns converted in "
+            << (dmlc::GetTime() - tstart) << " sec";
+  return 0;
+}